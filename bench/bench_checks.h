@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// The checks trueshot_bench runs, one per command (bench/main.cpp). Each
+// returns the process exit code: 0 when the fast path agreed with its
+// reference everywhere.
+namespace Bench {
+
+    // Replays a recording (game --record) in the arena: the final state must
+    // match the stored checksum bit for bit
+    int replay(const std::string& path, int passes);
+
+    // HitboxSet::raycast against the scalar path: `players` standing
+    // targets, `rays` shots aimed around them
+    int hitscan(uint32_t players, uint32_t rays);
+    // CollisionWorld::raycastPacket against one raycast per pellet:
+    // `shots` shotgun cones of `pellets` rays in the arena with crates
+    int pellets(uint32_t shots, uint32_t pellets);
+
+    // Capsule sweeps (the per-substep query of moveAndSlide) in the arena
+    // with crates, the BVH against a linear scan
+    int sweeps(uint32_t sweeps);
+    // moveAndSlide cost per tick from walking to bhop-cap speeds in the
+    // arena with crates; no move may end up through the walls or floor
+    int slide(uint32_t moves);
+
+    // A controller rewinds `window` ticks (at most the 64 kept in history)
+    // after every tick and replays them: each replay must land exactly on
+    // the live state
+    int resimulate(uint32_t rollbacks, uint32_t window);
+    // Two controllers stepped side by side must each move exactly as when
+    // run alone
+    int controllers(uint32_t ticks);
+
+    // Server movement (Net::PlayerMovement on MovementBatch) against
+    // PlayerController without a collision world, tick for tick: `players`
+    // scripted players, sub-tick jumps included
+    int parity(uint32_t players, uint32_t ticks);
+    // MovementBatch::step against the scalar reference at 10, 100 and 10000
+    // players (or just `players`)
+    int movement(uint32_t players);
+    // The same for every movement ruleset, then the competitive 64 profile
+    // against the pre-ruleset kernel that read the Physics:: constants
+    // (legacy_movement.h): same results, and the cost of each
+    int rulesets(uint32_t players);
+
+    // ProjectileSystem::step (batched sweeps) against stepReference (one
+    // sweep per grenade) with 100 and 512 grenades (or `live`) bouncing
+    // around the arena with crates for `ticks` ticks; each size must also
+    // stay under the 1 ms tick budget
+    int projectiles(uint32_t live, uint32_t ticks);
+
+    // Player broadphase (Net::SpatialGrid) against all-pairs at 10, 100 and
+    // 2000 players (or just `players`)
+    int grid(uint32_t players);
+}
@@ -0,0 +1,29 @@
+#include "bench_common.h"
+#include "input_source.h"
+
+#include <iostream>
+
+namespace Bench {
+
+ScriptedTick scriptedTick(uint32_t stream, uint32_t tick) {
+    uint32_t bits = (stream + 1) * 0x9E3779B9u ^ (tick / 8) * 0x85EBCA6Bu;
+    bits = (bits ^ (bits >> 15)) * 0x2C1B3C6Du;
+    bits ^= bits >> 12;
+
+    auto bit = [](InputAction action) { return 1u << static_cast<uint32_t>(action); };
+    ScriptedTick scripted;
+    scripted.buttons = bit((bits & 3) != 0 ? InputAction::MOVE_FORWARD : InputAction::MOVE_BACK);
+    if (((bits >> 2) & 3) == 1) scripted.buttons |= bit(InputAction::MOVE_LEFT);
+    if (((bits >> 2) & 3) == 2) scripted.buttons |= bit(InputAction::MOVE_RIGHT);
+    if (((bits >> 4) & 3) == 0 && (tick & 4) != 0) scripted.buttons |= bit(InputAction::JUMP);
+    scripted.turn = static_cast<float>(static_cast<int>((bits >> 8) % 11) - 5) * 0.5f;
+    scripted.jumpOffset = static_cast<float>((bits >> 16) & 255) / 256.0f;
+    return scripted;
+}
+
+int report(const char* what, uint32_t mismatches) {
+    std::cout << what << " mismatches: " << mismatches << (mismatches == 0 ? " OK" : " MISMATCH") << std::endl;
+    return mismatches == 0 ? 0 : 1;
+}
+
+}
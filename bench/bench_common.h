@@ -0,0 +1,63 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Helpers shared by the headless benchmarks and checks (trueshot_bench).
+// Each check prints its timings, then one "<what> mismatches: N OK" line,
+// and returns the process exit code: 0 when the fast path and its
+// reference agreed everywhere.
+namespace Bench {
+
+    // LCG, the same numbers every run so results are comparable
+    class Random {
+    public:
+        explicit Random(uint32_t seed = 1234) : m_State(seed) {}
+
+        uint32_t next() {
+            m_State = m_State * 1664525u + 1013904223u;
+            return m_State >> 8;                // Top 24 bits, the low ones are weak
+        }
+        float unit() { return static_cast<float>(next()) / 16777216.0f; }     // [0, 1)
+        float symmetric() { return unit() * 2.0f - 1.0f; }                      // [-1, 1)
+        uint32_t index(uint32_t count) { return next() % count; }
+
+    private:
+        uint32_t m_State;
+    };
+
+    // Wall time of fn() in nanoseconds
+    template <typename Fn>
+    double timeNs(Fn&& fn) {
+        auto start = std::chrono::steady_clock::now();
+        fn();
+        auto end = std::chrono::steady_clock::now();
+        return std::chrono::duration<double, std::nano>(end - start).count();
+    }
+
+    // Best of `passes` runs of fn(), so a preempted pass doesn't count;
+    // fn() must be repeatable
+    const int PASSES = 5;
+    template <typename Fn>
+    double bestOfNs(Fn&& fn, int passes = PASSES) {
+        double best = 1e300;
+        for (int pass = 0; pass < passes; ++pass) {
+            double ns = timeNs(fn);
+            if (ns < best) best = ns;
+        }
+        return best;
+    }
+
+    // One scripted player's input for `tick`: movement keys and jumps change
+    // every 8 ticks, the view turns a little every tick. Each `stream` is
+    // a different player.
+    struct ScriptedTick {
+        uint32_t buttons = 0;           // Bit per InputAction
+        float turn = 0.0f;              // Yaw change this tick, degrees
+        float jumpOffset = 0.0f;        // When in the tick jump was pressed (0-1)
+    };
+    ScriptedTick scriptedTick(uint32_t stream, uint32_t tick);
+
+    // Prints "<what> mismatches: N OK" (or MISMATCH); returns the exit code
+    int report(const char* what, uint32_t mismatches);
+}
@@ -0,0 +1,103 @@
+#include "bench_checks.h"
+#include "bench_common.h"
+#include "arena.h"
+#include "collision_world.h"
+#include "physics_types.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace Bench {
+
+int sweeps(uint32_t sweeps) {
+    CollisionWorld world;
+    buildArena(world, 300);
+
+    // Capsules anywhere over the arena floor, feet up to a jump high,
+    // moving up to one substep mostly sideways: what moveAndSlide asks for
+    // each substep
+    Random random;
+    const float radius = Physics::PLAYER_RADIUS, height = Physics::PLAYER_HEIGHT;
+    std::vector<glm::vec3> feet(sweeps), deltas(sweeps);
+    for (uint32_t s = 0; s < sweeps; ++s) {
+        feet[s] = glm::vec3(random.symmetric() * 44.0f, 0.01f + random.unit() * 1.2f, random.symmetric() * 44.0f);
+        glm::vec3 direction = glm::normalize(glm::vec3(random.symmetric(), random.symmetric() * 0.3f, random.symmetric()));
+        deltas[s] = direction * random.unit() * Physics::CCD_SUBSTEP_DISTANCE;
+    }
+
+    std::vector<SweepHit> tree(sweeps), linear(sweeps);
+    double treeNs = bestOfNs([&]() {
+        for (uint32_t s = 0; s < sweeps; ++s) world.sweepCapsule(feet[s], radius, height, deltas[s], tree[s]);
+    });
+    // One pass, the linear scan is orders of magnitude slower
+    double linearNs = timeNs([&]() {
+        for (uint32_t s = 0; s < sweeps; ++s) world.sweepCapsuleLinear(feet[s], radius, height, deltas[s], linear[s]);
+    });
+
+    uint32_t hits = 0, mismatches = 0;
+    for (uint32_t s = 0; s < sweeps; ++s) {
+        if (tree[s].hit) ++hits;
+        // Same contact within 1e-3 units of travel: where triangles meet, an
+        // edge root and a face contact can differ by float rounding
+        float travel = glm::length(deltas[s]);
+        bool same = tree[s].hit == linear[s].hit &&
+                    (!tree[s].hit || std::fabs(tree[s].fraction - linear[s].fraction) * travel < 1e-3f);
+        if (!same) ++mismatches;
+    }
+    double nsPerSweep = treeNs / sweeps;
+    std::cout << "Sweeps " << sweeps << " (" << world.getTriangles().size() << " triangles): " << nsPerSweep
+              << " ns/sweep (" << static_cast<uint64_t>(1e9 / std::max(1e-9, nsPerSweep))
+              << " sweeps/s), linear scan " << linearNs / sweeps << " ns/sweep, " << hits << " hits" << std::endl;
+    return report("BVH/linear", mismatches);
+}
+
+int slide(uint32_t moves) {
+    CollisionWorld world;
+    buildArena(world, 300);
+
+    // Half grounded runs, half airborne hops, in every direction from
+    // anywhere in the arena (pushed out of crates). Nobody runs on the
+    // ground faster than MAX_GROUND_SPEED, so above that every move is a hop.
+    Random random;
+    struct Move { glm::vec3 feet, direction; bool grounded; };
+    std::vector<Move> setup(moves);
+    for (Move& move : setup) {
+        move.grounded = random.unit() < 0.5f;
+        move.feet = glm::vec3(random.symmetric() * 44.0f, move.grounded ? 0.0f : random.unit() * 1.5f,
+                              random.symmetric() * 44.0f);
+        float angle = random.unit() * 6.2831853f;
+        float climb = move.grounded ? 0.0f : random.symmetric() * 0.3f;
+        move.direction = glm::normalize(glm::vec3(std::cos(angle), climb, std::sin(angle)));
+        glm::vec3 normal;
+        world.depenetrate(move.feet, normal);
+    }
+
+    // Each move's cost is its own best of PASSES, so the worst move is the
+    // geometry, not a preempted thread
+    const float speeds[] = {10.0f, 250.0f, 1000.0f, Physics::MAX_AIR_SPEED_CAP};
+    const float inside = 45.0f + 0.01f;         // Farthest the capsule axis gets from the centre
+    uint32_t tunnelled = 0;
+    for (float speed : speeds) {
+        double total = 0.0, worst = 0.0;
+        for (const Move& move : setup) {
+            bool grounded = move.grounded && speed <= Physics::MAX_GROUND_SPEED;
+            SlideResult result;
+            double ns = bestOfNs([&]() {
+                result = world.moveAndSlide(move.feet, move.direction * speed, Physics::FIXED_TIMESTEP, grounded);
+            });
+            if (std::fabs(result.position.x) > inside || std::fabs(result.position.z) > inside ||
+                result.position.y < -0.01f)
+                ++tunnelled;
+            total += ns;
+            worst = std::max(worst, ns);
+        }
+        std::cout << "Slide " << speed << " u/s, " << moves << " moves (" << world.getTriangles().size()
+                  << " triangles): " << total / moves / 1000.0 << " us/tick, worst " << worst / 1000.0 << " us"
+                  << std::endl;
+    }
+    return report("Through walls", tunnelled);
+}
+
+}
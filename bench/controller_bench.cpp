@@ -0,0 +1,129 @@
+#include "bench_checks.h"
+#include "bench_common.h"
+#include "arena.h"
+#include "collision_world.h"
+#include "input_recording.h"
+#include "player_controller.h"
+
+#include <algorithm>
+#include <iostream>
+#include <vector>
+
+namespace Bench {
+
+int replay(const std::string& path, int passes) {
+    InputRecording recording;
+    if (!recording.load(path)) return 2;
+
+    CollisionWorld world;
+    buildArena(world);
+
+    ReplayResult result = recording.replay(&world, passes);
+    std::cout << "Replay " << path << ": " << recording.getFrameCount() << " frames, " << result.ticks << " ticks, "
+              << result.nsPerTick << " ns/tick (best of " << passes << ")" << std::endl;
+    std::cout << "Checksum " << std::hex << result.checksum << " expected " << recording.getExpectedChecksum()
+              << std::dec << std::endl;
+    return report("Replay checksum", result.checksumMatch ? 0 : 1);
+}
+
+int resimulate(uint32_t rollbacks, uint32_t window) {
+    CollisionWorld world;
+    buildArena(world, 300);
+
+    PlayerController controller;
+    controller.setReplaying(true);
+    controller.setCollisionWorld(&world);
+
+    std::vector<PlayerTickInput> inputs(window + rollbacks);
+    float yaw = -90.0f;
+    for (uint32_t t = 0; t < inputs.size(); ++t) {
+        ScriptedTick scripted = scriptedTick(0, t);
+        yaw += scripted.turn;
+        inputs[t].buttons = scripted.buttons;
+        inputs[t].yaw = yaw;
+        inputs[t].jumpOffset = scripted.jumpOffset;
+    }
+
+    uint32_t first = controller.getTick();
+    for (uint32_t t = 0; t < window; ++t) controller.simulateTick(inputs[t]);
+
+    uint32_t mismatches = 0;
+    double total = 0.0, worst = 0.0;
+    for (uint32_t r = 0; r < rollbacks; ++r) {
+        controller.simulateTick(inputs[window + r]);
+        PlayerSimState live = controller.saveState();
+
+        // Replaying rewrites the same history, so it can be repeated
+        uint32_t fromTick = controller.getTick() - window;
+        bool replayed = true;
+        double ns = bestOfNs([&]() {
+            replayed = controller.resimulate(fromTick, &inputs[fromTick - first], window) && replayed;
+        });
+        total += ns;
+        worst = std::max(worst, ns);
+
+        PlayerSimState state = controller.saveState();
+        bool same = replayed && state.tick == live.tick && state.movement.position == live.movement.position &&
+                    state.movement.velocity == live.movement.velocity && state.movement.onGround == live.movement.onGround;
+        if (!same) ++mismatches;
+    }
+
+    std::cout << "Resimulate " << window << " ticks x " << rollbacks << " (" << world.getTriangles().size()
+              << " triangles): " << total / rollbacks / 1000.0 << " us, worst " << worst / 1000.0 << " us, moved "
+              << glm::length(controller.getPosition() - glm::vec3(0.0f, Physics::PLAYER_HEIGHT, 0.0f)) << " units"
+              << std::endl;
+    return report("Live/replay", mismatches);
+}
+
+int controllers(uint32_t ticks) {
+    CollisionWorld world;
+    buildArena(world, 300);
+
+    struct Sample { glm::vec3 position, velocity; };
+    auto start = [&world](PlayerController& controller, uint32_t player) {
+        controller.setReplaying(true);
+        controller.setCollisionWorld(&world);
+        controller.setPosition(glm::vec3(player == 0 ? -10.0f : 10.0f, Physics::PLAYER_HEIGHT, 0.0f));
+    };
+    auto step = [](PlayerController& controller, uint32_t player, uint32_t tick, StateInputSource& input,
+                   std::vector<Sample>& trace) {
+        ScriptedTick scripted = scriptedTick(player, tick);
+        input.setMask(scripted.buttons);
+        controller.addViewAngles(scripted.turn, 0.0f);
+        controller.processInput(input, Physics::FIXED_TIMESTEP);
+        controller.update(Physics::FIXED_TIMESTEP);
+        trace[tick] = {controller.getPosition(), controller.getVelocity()};
+    };
+
+    // Both at once, each with its own input source
+    std::vector<Sample> together[2] = {std::vector<Sample>(ticks), std::vector<Sample>(ticks)};
+    {
+        PlayerController controllers[2];
+        StateInputSource inputs[2];
+        for (uint32_t p = 0; p < 2; ++p) start(controllers[p], p);
+        for (uint32_t t = 0; t < ticks; ++t)
+            for (uint32_t p = 0; p < 2; ++p) step(controllers[p], p, t, inputs[p], together[p]);
+    }
+
+    // Then each alone: every tick must match bit for bit
+    uint32_t mismatches = 0;
+    float travelled[2] = {};
+    for (uint32_t p = 0; p < 2; ++p) {
+        std::vector<Sample> alone(ticks);
+        PlayerController controller;
+        StateInputSource input;
+        start(controller, p);
+        for (uint32_t t = 0; t < ticks; ++t) step(controller, p, t, input, alone);
+        for (uint32_t t = 0; t < ticks; ++t) {
+            bool same = alone[t].position == together[p][t].position && alone[t].velocity == together[p][t].velocity;
+            if (!same) ++mismatches;
+        }
+        travelled[p] = glm::length(alone[ticks - 1].position - alone[0].position);
+    }
+
+    std::cout << "Controllers 2 x " << ticks << " ticks: moved " << travelled[0] << " and " << travelled[1]
+              << " units" << std::endl;
+    return report("Shared/alone", mismatches);
+}
+
+}
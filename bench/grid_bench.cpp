@@ -0,0 +1,113 @@
+#include "bench_checks.h"
+#include "bench_common.h"
+#include "Network/NetCommon.h"
+#include "Network/SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace Bench {
+
+namespace {
+    // `count` players wandering at walking pace over ~36 m^2 each, bouncing
+    // off the square's edges, all moved every tick
+    struct Walker { float x, z, dx, dz; };
+    const float WalkSpeed = 5.0f;
+
+    std::vector<Walker> walkers(uint32_t count, float half) {
+        Random random;
+        std::vector<Walker> start(count);
+        const float step = WalkSpeed * Net::TickDelta;
+        for (Walker& w : start) {
+            float angle = random.symmetric() * 3.14159265f;
+            w = {random.symmetric() * half, random.symmetric() * half, std::cos(angle) * step, std::sin(angle) * step};
+        }
+        return start;
+    }
+
+    void move(std::vector<Walker>& walkers, float half) {
+        for (Walker& w : walkers) {
+            w.x += w.dx;
+            w.z += w.dz;
+            if (w.x < -half || w.x > half) w.dx = -w.dx;
+            if (w.z < -half || w.z > half) w.dz = -w.dz;
+        }
+    }
+
+    // Pair sets compared by count and an order-independent sum
+    struct TickPairs {
+        uint32_t count = 0;
+        uint64_t sum = 0;
+
+        void add(uint32_t a, uint32_t b, uint32_t items) {
+            if (a > b) std::swap(a, b);
+            ++count;
+            sum += static_cast<uint64_t>(a) * items + b;
+        }
+    };
+
+    // Update + ForEachPair against testing every pair, for `ticks` ticks;
+    // a tick mismatches when the pair sets differ
+    uint32_t checkGrid(uint32_t count, uint32_t ticks) {
+        const float radius = 2.0f * Net::PlayerRadius;
+        const float half = 3.0f * std::sqrt(static_cast<float>(count));
+        const std::vector<Walker> start = walkers(count, half);
+
+        std::vector<TickPairs> grid(ticks), all(ticks);
+        uint32_t relinks = 0;
+        double gridNs = bestOfNs([&]() {
+            std::vector<Walker> w = start;
+            Net::SpatialGrid g;
+            uint32_t linked = 0;
+            for (uint32_t t = 0; t < ticks; ++t) {
+                move(w, half);
+                g.Resize(count);
+                for (uint32_t i = 0; i < count; ++i) g.Update(i, w[i].x, w[i].z);
+                if (t == 0) linked = g.Relinks();       // The first tick links everyone
+                grid[t] = TickPairs();
+                g.ForEachPair(radius, [&](uint32_t a, uint32_t b) { grid[t].add(a, b, count); });
+            }
+            relinks = g.Relinks() - linked;
+        });
+        const float r2 = radius * radius;
+        double allNs = bestOfNs([&]() {
+            std::vector<Walker> w = start;
+            for (uint32_t t = 0; t < ticks; ++t) {
+                move(w, half);
+                all[t] = TickPairs();
+                for (uint32_t a = 0; a < count; ++a) {
+                    for (uint32_t b = a + 1; b < count; ++b) {
+                        float dx = w[b].x - w[a].x, dz = w[b].z - w[a].z;
+                        if (dx * dx + dz * dz < r2) all[t].add(a, b, count);
+                    }
+                }
+            }
+        });
+
+        uint32_t pairs = 0, mismatches = 0;
+        for (uint32_t t = 0; t < ticks; ++t) {
+            pairs += grid[t].count;
+            if (grid[t].count != all[t].count || grid[t].sum != all[t].sum) ++mismatches;
+        }
+        // Walker movement is timed too, it is the same in both
+        std::cout << "Grid " << count << " players, " << ticks << " ticks: " << gridNs / ticks / 1000.0
+                  << " us/tick, all pairs " << allNs / ticks / 1000.0 << " us/tick, " << pairs << " pairs, "
+                  << relinks << " relinks" << std::endl;
+        return mismatches;
+    }
+}
+
+int grid(uint32_t players) {
+    const uint32_t sizes[] = {10, 100, 2000};
+    uint32_t mismatches = 0;
+    for (uint32_t size : sizes) {
+        if (players != 0) size = players;
+        mismatches += checkGrid(size, 200);
+        if (players != 0) break;
+    }
+    return report("Grid/all-pairs", mismatches);
+}
+
+}
@@ -0,0 +1,114 @@
+#include "bench_checks.h"
+#include "bench_common.h"
+#include "arena.h"
+#include "collision_world.h"
+#include "hitscan.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace Bench {
+
+int hitscan(uint32_t players, uint32_t rays) {
+    // Players scattered over the arena floor, shots from eye height at a
+    // random player's chest, jittered so some miss and some hit limbs
+    Random random;
+    std::vector<Hitscan::Target> targets(players);
+    for (uint32_t i = 0; i < players; ++i) {
+        targets[i].id = static_cast<int>(i);
+        targets[i].feet = glm::vec3(random.symmetric() * 40.0f, 0.0f, random.symmetric() * 40.0f);
+        targets[i].yaw = random.symmetric() * 180.0f;
+    }
+    Hitscan::HitboxSet set;
+    set.build(targets.data(), players);
+
+    struct Shot { glm::vec3 origin, direction; int shooter; };
+    std::vector<Shot> shots(rays);
+    for (Shot& shot : shots) {
+        shot.shooter = static_cast<int>(random.index(players));
+        const Hitscan::Target& victim = targets[random.index(players)];
+        shot.origin = targets[shot.shooter].feet + glm::vec3(0.0f, 1.62f, 0.0f);
+        glm::vec3 aim = victim.feet + glm::vec3(random.symmetric() * 0.5f, 1.1f + random.symmetric() * 0.7f,
+                                                random.symmetric() * 0.5f);
+        shot.direction = aim - shot.origin;
+        float length = glm::length(shot.direction);
+        shot.direction = length > 0.0f ? shot.direction / length : glm::vec3(0.0f, 0.0f, -1.0f);
+    }
+
+    std::vector<HitResult> simd(rays), scalar(rays);
+    double simdNs = bestOfNs([&]() {
+        for (uint32_t r = 0; r < rays; ++r) {
+            simd[r] = HitResult();
+            set.raycast(shots[r].origin, shots[r].direction, 1000.0f, shots[r].shooter, simd[r]);
+        }
+    });
+    double scalarNs = bestOfNs([&]() {
+        for (uint32_t r = 0; r < rays; ++r) {
+            scalar[r] = HitResult();
+            set.raycastScalar(shots[r].origin, shots[r].direction, 1000.0f, shots[r].shooter, scalar[r]);
+        }
+    });
+
+    uint32_t hits = 0, mismatches = 0;
+    for (uint32_t r = 0; r < rays; ++r) {
+        if (simd[r].hit) ++hits;
+        bool same = simd[r].hit == scalar[r].hit && simd[r].targetId == scalar[r].targetId &&
+                    simd[r].hitLocation == scalar[r].hitLocation &&
+                    std::fabs(simd[r].distance - scalar[r].distance) < 1e-3f;
+        if (!same) ++mismatches;
+    }
+    std::cout << "Hitscan " << players << " players, " << rays << " rays: " << simdNs / rays << " ns/ray, scalar "
+              << scalarNs / rays << " ns/ray, " << hits << " hits" << std::endl;
+    return report("Scalar/SIMD", mismatches);
+}
+
+int pellets(uint32_t shots, uint32_t pellets) {
+    CollisionWorld world;
+    buildArena(world, 300);
+
+    // Eye-height shots from anywhere in the arena, mostly level, each a
+    // cone of pellets from the same muzzle
+    Random random;
+    const float cone = std::tan(glm::radians(4.0f));
+    const uint32_t rays = shots * pellets;
+    std::vector<glm::vec3> origins(rays), directions(rays);
+    for (uint32_t s = 0; s < shots; ++s) {
+        glm::vec3 origin(random.symmetric() * 40.0f, 1.62f, random.symmetric() * 40.0f);
+        glm::vec3 aim = glm::normalize(glm::vec3(random.symmetric(), random.symmetric() * 0.2f, random.symmetric()));
+        glm::vec3 up = std::fabs(aim.y) < 0.9f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+        glm::vec3 right = glm::normalize(glm::cross(aim, up));
+        up = glm::cross(right, aim);
+        for (uint32_t k = 0; k < pellets; ++k) {
+            origins[s * pellets + k] = origin;
+            directions[s * pellets + k] =
+                glm::normalize(aim + (right * random.symmetric() + up * random.symmetric()) * cone);
+        }
+    }
+
+    std::vector<RayHit> packet(rays), single(rays);
+    double packetNs = bestOfNs([&]() {
+        for (uint32_t s = 0; s < shots; ++s) {
+            const uint32_t first = s * pellets;
+            world.raycastPacket(&origins[first], &directions[first], pellets, 1000.0f, &packet[first]);
+        }
+    });
+    double singleNs = bestOfNs([&]() {
+        for (uint32_t r = 0; r < rays; ++r) world.raycast(origins[r], directions[r], 1000.0f, single[r]);
+    });
+
+    uint32_t hits = 0, mismatches = 0;
+    for (uint32_t r = 0; r < rays; ++r) {
+        if (packet[r].hit) ++hits;
+        bool same = packet[r].hit == single[r].hit &&
+                    (!packet[r].hit || std::fabs(packet[r].distance - single[r].distance) < 1e-3f);
+        if (!same) ++mismatches;
+    }
+    std::cout << "Pellets " << shots << " shots x " << pellets << " (" << world.getTriangles().size()
+              << " triangles): " << packetNs / rays << " ns/ray, single rays " << singleNs / rays << " ns/ray, "
+              << hits << " hits" << std::endl;
+    return report("Packet/single", mismatches);
+}
+
+}
@@ -0,0 +1,237 @@
+#include "legacy_movement.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+// MovementBatch's first kernels, verbatim but for the columns being reached
+// through `b`
+namespace Bench {
+
+namespace {
+    // acos in degrees, Abramowitz & Stegun 4.4.45 (abs error < 0.004°).
+    // Only drives the strafe-angle bonus, so no libm call per player.
+    inline float fastAcosDegrees(float x) {
+        float a = std::fabs(x);
+        float r = std::sqrt(1.0f - a) * (1.5707288f + a * (-0.2121144f + a * (0.0742610f + a * -0.0187293f)));
+        if (x < 0.0f) r = 3.14159265f - r;
+        return r * 57.2957795f;
+    }
+
+    const float SMALL_SPEED = 1e-6f;
+}
+
+static void stepScalar(MovementBatch& b, size_t begin, size_t end, float dt) {
+    using namespace Physics;
+
+    for (size_t i = begin; i < end; ++i) {
+        float vx = b.velX[i], vy = b.velY[i], vz = b.velZ[i];
+        float wx = b.wishX[i], wz = b.wishZ[i];
+        bool hasWish = (wx * wx + wz * wz) > 0.0f;
+        bool wasGround = b.onGround[i] != 0;
+
+        // Ground state
+        bool ground = b.posY[i] <= PLAYER_HEIGHT + GROUND_TOLERANCE;
+        if (ground && vy <= 0.0f) {
+            vy = 0.0f;
+            b.posY[i] = PLAYER_HEIGHT;
+        }
+
+        // Jump
+        if (b.wishJump[i] && ground) {
+            vy = JUMP_IMPULSE;
+            ground = false;
+        }
+        b.wishJump[i] = 0;
+
+        float hs = std::sqrt(vx * vx + vz * vz);
+        if (ground) {
+            if (!hasWish) {
+                if (hs < 0.1f) {
+                    vx = 0.0f;
+                    vz = 0.0f;
+                } else {
+                    float drop = std::max(hs, GROUND_FRICTION) * GROUND_FRICTION * b.surfaceFriction[i] * dt;
+                    float scale = std::max(0.0f, hs - drop) / hs;
+                    vx *= scale;
+                    vz *= scale;
+                }
+            } else {
+                float add = MAX_GROUND_SPEED - (vx * wx + vz * wz);
+                if (add > 0.0f) {
+                    float accel = std::min(GROUND_ACCELERATION * MAX_GROUND_SPEED * dt, add);
+                    vx += wx * accel;
+                    vz += wz * accel;
+                }
+            }
+            if (!wasGround) b.airTime[i] = 0.0f;
+        } else {
+            if (hasWish) {
+                float rate = AIR_ACCELERATION;
+                if (hs >= 1.0f) {
+                    float d = std::max(-1.0f, std::min(1.0f, (vx * wx + vz * wz) / hs));
+                    float angle = fastAcosDegrees(d);
+                    if (angle >= 20.0f && angle <= 60.0f) {
+                        float factor = std::max(0.5f, 1.0f - std::fabs(angle - OPTIMAL_STRAFE_ANGLE) / 30.0f);
+                        rate = AIR_ACCELERATION * (1.0f + factor * 0.5f);
+                    }
+                }
+                float add = AIR_MAX_SPEED - (vx * wx + vz * wz);
+                if (add > 0.0f) {
+                    float accel = std::min(rate * AIR_MAX_SPEED * dt, add);
+                    vx += wx * accel;
+                    vz += wz * accel;
+                }
+                float cs = std::sqrt(vx * vx + vz * vz);
+                if (cs > MAX_AIR_SPEED_CAP) {
+                    vx *= MAX_AIR_SPEED_CAP / cs;
+                    vz *= MAX_AIR_SPEED_CAP / cs;
+                }
+            }
+            float airFriction = 1.0f - AIR_FRICTION * dt;
+            vx *= airFriction;
+            vz *= airFriction;
+            b.airTime[i] += dt;
+            vy -= GRAVITY * dt;
+        }
+
+        b.posX[i] += vx * dt;
+        b.posY[i] = std::max(PLAYER_HEIGHT, b.posY[i] + vy * dt);
+        b.posZ[i] += vz * dt;
+        b.velX[i] = vx; b.velY[i] = vy; b.velZ[i] = vz;
+        b.speed[i] = std::sqrt(vx * vx + vz * vz);
+        b.onGround[i] = ground ? 1 : 0;
+    }
+}
+
+#if defined(__SSE2__)
+namespace {
+    inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    inline __m128 loadMask(const uint8_t* flags) {
+        __m128i v = _mm_setr_epi32(flags[0], flags[1], flags[2], flags[3]);
+        return _mm_castsi128_ps(_mm_cmpgt_epi32(v, _mm_setzero_si128()));
+    }
+
+    inline __m128 fastAcosDegrees(__m128 x) {
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        __m128 a = _mm_andnot_ps(signBit, x);
+        __m128 poly = _mm_add_ps(_mm_set1_ps(0.0742610f), _mm_mul_ps(a, _mm_set1_ps(-0.0187293f)));
+        poly = _mm_add_ps(_mm_set1_ps(-0.2121144f), _mm_mul_ps(a, poly));
+        poly = _mm_add_ps(_mm_set1_ps(1.5707288f), _mm_mul_ps(a, poly));
+        __m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), a)), poly);
+        __m128 negative = _mm_cmplt_ps(x, _mm_setzero_ps());
+        r = select(negative, _mm_sub_ps(_mm_set1_ps(3.14159265f), r), r);
+        return _mm_mul_ps(r, _mm_set1_ps(57.2957795f));
+    }
+}
+
+static void stepSSE(MovementBatch& b, size_t begin, size_t end, float dt) {
+    using namespace Physics;
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 dtv = _mm_set1_ps(dt);
+    const __m128 playerHeight = _mm_set1_ps(PLAYER_HEIGHT);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+
+    for (size_t i = begin; i < end; i += 4) {
+        __m128 px = _mm_loadu_ps(&b.posX[i]), py = _mm_loadu_ps(&b.posY[i]), pz = _mm_loadu_ps(&b.posZ[i]);
+        __m128 vx = _mm_loadu_ps(&b.velX[i]), vy = _mm_loadu_ps(&b.velY[i]), vz = _mm_loadu_ps(&b.velZ[i]);
+        __m128 wx = _mm_loadu_ps(&b.wishX[i]), wz = _mm_loadu_ps(&b.wishZ[i]);
+        __m128 air = _mm_loadu_ps(&b.airTime[i]);
+        __m128 hasWish = _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(wx, wx), _mm_mul_ps(wz, wz)), zero);
+        __m128 wasGround = loadMask(&b.onGround[i]);
+
+        // Ground state
+        __m128 ground = _mm_cmple_ps(py, _mm_set1_ps(PLAYER_HEIGHT + GROUND_TOLERANCE));
+        __m128 snap = _mm_and_ps(ground, _mm_cmple_ps(vy, zero));
+        vy = _mm_andnot_ps(snap, vy);
+        py = select(snap, playerHeight, py);
+
+        // Jump
+        __m128 jumped = _mm_and_ps(loadMask(&b.wishJump[i]), ground);
+        vy = select(jumped, _mm_set1_ps(JUMP_IMPULSE), vy);
+        ground = _mm_andnot_ps(jumped, ground);
+
+        __m128 hs = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vz, vz)));
+        __m128 invHs = _mm_div_ps(one, _mm_max_ps(hs, _mm_set1_ps(SMALL_SPEED)));
+        __m128 along = _mm_add_ps(_mm_mul_ps(vx, wx), _mm_mul_ps(vz, wz));
+
+        // Ground: friction without input, acceleration with input
+        __m128 drop = _mm_mul_ps(_mm_max_ps(hs, _mm_set1_ps(GROUND_FRICTION)),
+                                 _mm_mul_ps(_mm_set1_ps(GROUND_FRICTION * dt), _mm_loadu_ps(&b.surfaceFriction[i])));
+        __m128 frictionScale = _mm_mul_ps(_mm_max_ps(zero, _mm_sub_ps(hs, drop)), invHs);
+        frictionScale = _mm_andnot_ps(_mm_cmplt_ps(hs, _mm_set1_ps(0.1f)), frictionScale);
+        frictionScale = select(hasWish, one, frictionScale);
+
+        __m128 groundAdd = _mm_sub_ps(_mm_set1_ps(MAX_GROUND_SPEED), along);
+        __m128 groundAccel = _mm_min_ps(_mm_set1_ps(GROUND_ACCELERATION * MAX_GROUND_SPEED * dt), groundAdd);
+        groundAccel = _mm_and_ps(_mm_and_ps(hasWish, _mm_cmpgt_ps(groundAdd, zero)), groundAccel);
+
+        __m128 gvx = _mm_add_ps(_mm_mul_ps(vx, frictionScale), _mm_mul_ps(wx, groundAccel));
+        __m128 gvz = _mm_add_ps(_mm_mul_ps(vz, frictionScale), _mm_mul_ps(wz, groundAccel));
+
+        // Air: strafe bonus in the 20-60° window, speed cap, air friction
+        __m128 d = _mm_max_ps(_mm_set1_ps(-1.0f), _mm_min_ps(one, _mm_mul_ps(along, invHs)));
+        __m128 angle = fastAcosDegrees(d);
+        __m128 goodAngle = _mm_and_ps(_mm_cmpge_ps(angle, _mm_set1_ps(20.0f)), _mm_cmple_ps(angle, _mm_set1_ps(60.0f)));
+        goodAngle = _mm_and_ps(goodAngle, _mm_cmpge_ps(hs, one));
+        __m128 offset = _mm_andnot_ps(signBit, _mm_sub_ps(angle, _mm_set1_ps(OPTIMAL_STRAFE_ANGLE)));
+        __m128 factor = _mm_max_ps(_mm_set1_ps(0.5f), _mm_sub_ps(one, _mm_mul_ps(offset, _mm_set1_ps(1.0f / 30.0f))));
+        __m128 rate = _mm_mul_ps(_mm_set1_ps(AIR_ACCELERATION), _mm_add_ps(one, _mm_mul_ps(factor, _mm_set1_ps(0.5f))));
+        rate = select(goodAngle, rate, _mm_set1_ps(AIR_ACCELERATION));
+
+        __m128 airAdd = _mm_sub_ps(_mm_set1_ps(AIR_MAX_SPEED), along);
+        __m128 airAccel = _mm_min_ps(_mm_mul_ps(rate, _mm_set1_ps(AIR_MAX_SPEED * dt)), airAdd);
+        airAccel = _mm_and_ps(_mm_and_ps(hasWish, _mm_cmpgt_ps(airAdd, zero)), airAccel);
+        __m128 avx = _mm_add_ps(vx, _mm_mul_ps(wx, airAccel));
+        __m128 avz = _mm_add_ps(vz, _mm_mul_ps(wz, airAccel));
+
+        __m128 cs = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(avx, avx), _mm_mul_ps(avz, avz)));
+        __m128 capMask = _mm_and_ps(hasWish, _mm_cmpgt_ps(cs, _mm_set1_ps(MAX_AIR_SPEED_CAP)));
+        __m128 capScale = select(capMask, _mm_div_ps(_mm_set1_ps(MAX_AIR_SPEED_CAP), _mm_max_ps(cs, _mm_set1_ps(SMALL_SPEED))), one);
+        capScale = _mm_mul_ps(capScale, _mm_set1_ps(1.0f - AIR_FRICTION * dt));
+        avx = _mm_mul_ps(avx, capScale);
+        avz = _mm_mul_ps(avz, capScale);
+
+        vx = select(ground, gvx, avx);
+        vz = select(ground, gvz, avz);
+        vy = select(ground, vy, _mm_sub_ps(vy, _mm_set1_ps(GRAVITY * dt)));
+        __m128 landed = _mm_andnot_ps(wasGround, ground);
+        air = select(ground, _mm_andnot_ps(landed, air), _mm_add_ps(air, dtv));
+
+        // Integrate, floor clamp
+        px = _mm_add_ps(px, _mm_mul_ps(vx, dtv));
+        py = _mm_max_ps(playerHeight, _mm_add_ps(py, _mm_mul_ps(vy, dtv)));
+        pz = _mm_add_ps(pz, _mm_mul_ps(vz, dtv));
+
+        _mm_storeu_ps(&b.posX[i], px); _mm_storeu_ps(&b.posY[i], py); _mm_storeu_ps(&b.posZ[i], pz);
+        _mm_storeu_ps(&b.velX[i], vx); _mm_storeu_ps(&b.velY[i], vy); _mm_storeu_ps(&b.velZ[i], vz);
+        _mm_storeu_ps(&b.airTime[i], air);
+        _mm_storeu_ps(&b.speed[i], _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vz, vz))));
+
+        int groundBits = _mm_movemask_ps(ground);
+        for (int lane = 0; lane < 4; ++lane) {
+            b.onGround[i + lane] = (groundBits >> lane) & 1;
+            b.wishJump[i + lane] = 0;
+        }
+    }
+}
+#endif
+
+void legacyStep(MovementBatch& b, float dt) {
+    size_t simdEnd = 0;
+#if defined(__SSE2__)
+    simdEnd = b.size() & ~size_t(3);
+    stepSSE(b, 0, simdEnd, dt);
+#endif
+    stepScalar(b, simdEnd, b.size(), dt);
+}
+
+}
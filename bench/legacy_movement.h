@@ -0,0 +1,11 @@
+#pragma once
+
+#include "movement_batch.h"
+
+namespace Bench {
+
+    // MovementBatch::step as it was before movement rulesets: one kernel
+    // reading the Physics:: constants directly, jumps at the start of the
+    // step. The rulesets check measures the per-profile kernels against it.
+    void legacyStep(MovementBatch& batch, float deltaTime);
+}
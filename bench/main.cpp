@@ -0,0 +1,57 @@
+#include "bench_checks.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+namespace {
+    // Positive integer argument `i`, or `fallback` when absent
+    uint32_t count(int argc, char** argv, int i, int fallback) {
+        return static_cast<uint32_t>(i < argc ? std::max(1, std::atoi(argv[i])) : fallback);
+    }
+
+    void printUsage() {
+        std::cout << "Usage: trueshot_bench <check> [args]\n"
+                  << "  replay <file> [passes]\n"
+                  << "  hitscan [players] [rays]\n"
+                  << "  pellets [shots] [pellets]\n"
+                  << "  sweeps [sweeps]\n"
+                  << "  slide [moves]\n"
+                  << "  resim [rollbacks] [ticks]\n"
+                  << "  controllers [ticks]\n"
+                  << "  parity [players] [ticks]\n"
+                  << "  movement [players]\n"
+                  << "  rulesets [players]\n"
+                  << "  projectiles [live] [ticks]\n"
+                  << "  grid [players]\n"
+                  << "Exit code 0 when the check passed." << std::endl;
+    }
+}
+
+// Headless benchmarks and regression checks, kept out of the game and
+// server executables. Each prints its timings and a mismatch count.
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        printUsage();
+        return 2;
+    }
+    const char* check = argv[1];
+    if (std::strcmp(check, "replay") == 0 && argc > 2) return Bench::replay(argv[2], count(argc, argv, 3, 1));
+    if (std::strcmp(check, "hitscan") == 0) return Bench::hitscan(count(argc, argv, 2, 64), count(argc, argv, 3, 100000));
+    if (std::strcmp(check, "pellets") == 0) return Bench::pellets(count(argc, argv, 2, 20000), count(argc, argv, 3, 9));
+    if (std::strcmp(check, "sweeps") == 0) return Bench::sweeps(count(argc, argv, 2, 20000));
+    if (std::strcmp(check, "slide") == 0) return Bench::slide(count(argc, argv, 2, 20000));
+    if (std::strcmp(check, "resim") == 0)
+        return Bench::resimulate(count(argc, argv, 2, 2000), std::min(64u, count(argc, argv, 3, 32)));
+    if (std::strcmp(check, "controllers") == 0) return Bench::controllers(count(argc, argv, 2, 2000));
+    if (std::strcmp(check, "parity") == 0) return Bench::parity(count(argc, argv, 2, 64), count(argc, argv, 3, 2000));
+    if (std::strcmp(check, "movement") == 0) return Bench::movement(count(argc, argv, 2, 0));
+    if (std::strcmp(check, "rulesets") == 0) return Bench::rulesets(count(argc, argv, 2, 1024));
+    if (std::strcmp(check, "projectiles") == 0)
+        return Bench::projectiles(count(argc, argv, 2, 0), count(argc, argv, 3, 400));
+    if (std::strcmp(check, "grid") == 0) return Bench::grid(count(argc, argv, 2, 0));
+
+    printUsage();
+    return 2;
+}
@@ -0,0 +1,241 @@
+#include "bench_checks.h"
+#include "bench_common.h"
+#include "legacy_movement.h"
+#include "Network/PlayerMovement.h"
+#include "movement_batch.h"
+#include "player_controller.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+namespace Bench {
+
+namespace {
+    // Spread over the arena, a quarter of them starting in the air, most
+    // holding a movement key
+    MovementBatch batchPlayers(size_t players, Physics::MovementRuleset ruleset) {
+        Random random;
+        MovementBatch batch(players, ruleset);
+        for (size_t i = 0; i < players; ++i) {
+            float height = (i % 4 == 0) ? 20.0f + random.symmetric() * 10.0f : 0.0f;
+            size_t p = batch.add(glm::vec3(random.symmetric() * 40.0f, Physics::PLAYER_HEIGHT + height,
+                                           random.symmetric() * 40.0f));
+            batch.velX[p] = random.symmetric() * 300.0f;
+            batch.velZ[p] = random.symmetric() * 300.0f;
+            glm::vec2 move = (i % 5 == 0) ? glm::vec2(0.0f) : glm::vec2(random.symmetric(), random.symmetric());
+            batch.setInput(p, random.symmetric() * 180.0f, move, false);
+        }
+        return batch;
+    }
+
+    // WASD as PlayerController::processInput reads it
+    glm::vec2 moveInput(uint32_t buttons) {
+        auto down = [buttons](InputAction action) { return (buttons >> static_cast<uint32_t>(action)) & 1u; };
+        glm::vec2 move(0.0f);
+        if (down(InputAction::MOVE_FORWARD)) move.y += 1.0f;
+        if (down(InputAction::MOVE_BACK)) move.y -= 1.0f;
+        if (down(InputAction::MOVE_LEFT)) move.x -= 1.0f;
+        if (down(InputAction::MOVE_RIGHT)) move.x += 1.0f;
+        if (glm::length(move) > 1.0f) move = glm::normalize(move);
+        return move;
+    }
+
+    // A third of them jump every 32 ticks, most part-way through the step
+    // unless `subStep` is off
+    void jump(MovementBatch& batch, uint32_t tick, bool subStep = true) {
+        if (tick % 32 != 0) return;
+        for (size_t i = 0; i < batch.size(); i += 3) {
+            batch.wishJump[i] = 1;
+            batch.jumpOffset[i] = subStep ? static_cast<float>((i / 3) % 4) * 0.25f : 0.0f;
+        }
+    }
+
+    // Maximum relative error 1e-3, absolute below 1
+    bool near(float a, float b) { return std::fabs(a - b) <= 1e-3f * std::max(1.0f, std::fabs(b)); }
+
+    bool sameState(const MovementBatch& a, const MovementBatch& b, size_t i) {
+        return near(a.posX[i], b.posX[i]) && near(a.posY[i], b.posY[i]) && near(a.posZ[i], b.posZ[i]) &&
+               near(a.velX[i], b.velX[i]) && near(a.velY[i], b.velY[i]) && near(a.velZ[i], b.velZ[i]) &&
+               near(a.airTime[i], b.airTime[i]) && a.onGround[i] == b.onGround[i];
+    }
+
+    // step() against stepReference() for one ruleset. Both kernels start
+    // from the same state every tick and the SIMD result carries on, so one
+    // rounding difference can't snowball into later ticks.
+    uint32_t checkKernels(Physics::MovementRuleset ruleset, const char* name, size_t players, uint32_t ticks) {
+        const MovementBatch start = batchPlayers(players, ruleset);
+        const float dt = start.getFixedTimestep();
+
+        MovementBatch batch = start;
+        double stepNs = bestOfNs([&]() {
+            batch = start;
+            for (uint32_t t = 0; t < ticks; ++t) {
+                jump(batch, t);
+                batch.step(dt);
+            }
+        });
+        double referenceNs = bestOfNs([&]() {
+            batch = start;
+            for (uint32_t t = 0; t < ticks; ++t) {
+                jump(batch, t);
+                batch.stepReference(dt);
+            }
+        });
+
+        uint32_t mismatches = 0;
+        MovementBatch simd = start;
+        for (uint32_t t = 0; t < ticks; ++t) {
+            jump(simd, t);
+            MovementBatch scalar = simd;
+            simd.step(dt);
+            scalar.stepReference(dt);
+            for (size_t i = 0; i < players; ++i) {
+                if (!sameState(simd, scalar, i)) ++mismatches;
+            }
+        }
+
+        const double playerTicks = static_cast<double>(players) * ticks;
+        std::cout << "Movement " << name << ", " << players << " players, " << ticks << " ticks: "
+                  << stepNs / playerTicks << " ns/player-tick, scalar " << referenceNs / playerTicks
+                  << " ns/player-tick" << std::endl;
+        return mismatches;
+    }
+
+    // The competitive 64 profile against the kernel it replaced, which read
+    // the Physics:: globals directly: same state every tick (jumps only at
+    // the start of the step, the old kernel has no sub-step jumps), and
+    // whether templating on the profile costs anything
+    uint32_t checkLegacy(size_t players, uint32_t ticks) {
+        const MovementBatch start = batchPlayers(players, Physics::MovementRuleset::COMPETITIVE_64);
+        const float dt = start.getFixedTimestep();
+
+        MovementBatch batch = start;
+        double profileNs = bestOfNs([&]() {
+            batch = start;
+            for (uint32_t t = 0; t < ticks; ++t) {
+                jump(batch, t, false);
+                batch.step(dt);
+            }
+        });
+        double legacyNs = bestOfNs([&]() {
+            batch = start;
+            for (uint32_t t = 0; t < ticks; ++t) {
+                jump(batch, t, false);
+                legacyStep(batch, dt);
+            }
+        });
+
+        uint32_t mismatches = 0;
+        MovementBatch profile = start;
+        for (uint32_t t = 0; t < ticks; ++t) {
+            jump(profile, t, false);
+            MovementBatch legacy = profile;
+            profile.step(dt);
+            legacyStep(legacy, dt);
+            for (size_t i = 0; i < players; ++i) {
+                if (!sameState(profile, legacy, i)) ++mismatches;
+            }
+        }
+
+        const double playerTicks = static_cast<double>(players) * ticks;
+        std::cout << "Movement competitive64, " << players << " players, " << ticks << " ticks: "
+                  << profileNs / playerTicks << " ns/player-tick, raw globals " << legacyNs / playerTicks
+                  << " ns/player-tick" << std::endl;
+        return mismatches;
+    }
+}
+
+int parity(uint32_t players, uint32_t ticks) {
+    // Controllers without a collision world, so both only clamp to the
+    // floor; the old ±45 arena walls are the controller's alone
+    std::vector<PlayerController> controllers(players);
+    std::vector<float> yaw(players);
+    std::vector<uint8_t> jumpHeld(players, 0);
+    Net::PlayerMovement movement(players);
+    Random random;
+    for (uint32_t p = 0; p < players; ++p) {
+        controllers[p].setReplaying(true);
+        controllers[p].setPosition(
+            glm::vec3(random.symmetric() * 40.0f, Physics::PLAYER_HEIGHT, random.symmetric() * 40.0f));
+        yaw[p] = random.symmetric() * 180.0f;
+    }
+
+    auto outside = [](float x, float z) { return std::fabs(x) >= 45.0f || std::fabs(z) >= 45.0f; };
+    uint32_t mismatches = 0, compared = 0, atWalls = 0, jumps = 0;
+    for (uint32_t t = 0; t < ticks; ++t) {
+        // Every tick starts from the controller's state, as the server's
+        // rows start from its entity columns, so a rounding difference can't
+        // snowball into later ticks
+        movement.Clear();
+        for (uint32_t p = 0; p < players; ++p) {
+            const MovementState& state = controllers[p].getMovementState();
+            ScriptedTick scripted = scriptedTick(p, t);
+            yaw[p] += scripted.turn;
+            bool held = (scripted.buttons >> static_cast<uint32_t>(InputAction::JUMP)) & 1u;
+            glm::vec2 move = moveInput(scripted.buttons);
+
+            Net::InputState in{};
+            in.forward = move.y;
+            in.right = move.x;
+            in.jump = held && !jumpHeld[p];
+            in.jumpOffset = static_cast<uint8_t>(scripted.jumpOffset * 256.0f);
+            in.yaw = yaw[p];
+            jumpHeld[p] = held ? 1 : 0;
+            if (in.jump && state.onGround) ++jumps;
+            movement.Add({state.position.x, state.position.y - Physics::PLAYER_HEIGHT, state.position.z},
+                         {state.velocity.x, state.velocity.y, state.velocity.z}, in);
+
+            PlayerTickInput input;
+            input.buttons = scripted.buttons;
+            input.yaw = yaw[p];
+            input.jumpOffset = in.jumpOffset / 256.0f;
+            controllers[p].simulateTick(input);
+        }
+        movement.Step();
+
+        for (uint32_t p = 0; p < players; ++p) {
+            const MovementState& state = controllers[p].getMovementState();
+            Net::Vec3 pos = movement.Position(p), vel = movement.Velocity(p);
+            if (state.hitWall || outside(state.position.x, state.position.z) || outside(pos.x, pos.z)) {
+                ++atWalls;
+                continue;
+            }
+            ++compared;
+            bool same = near(pos.x, state.position.x) && near(pos.y + Physics::PLAYER_HEIGHT, state.position.y) &&
+                        near(pos.z, state.position.z) && near(vel.x, state.velocity.x) &&
+                        near(vel.y, state.velocity.y) && near(vel.z, state.velocity.z);
+            if (!same) ++mismatches;
+        }
+    }
+
+    std::cout << "Parity " << players << " players, " << ticks << " ticks: " << compared << " player-ticks compared, "
+              << atWalls << " at the walls skipped, " << jumps << " jumps" << std::endl;
+    return report("Server/controller", mismatches);
+}
+
+int movement(uint32_t players) {
+    const uint32_t sizes[] = {10, 100, 10000};
+    uint32_t mismatches = 0;
+    for (uint32_t size : sizes) {
+        if (players != 0) size = players;
+        uint32_t ticks = std::max(64u, 4000000u / size);
+        mismatches += checkKernels(Physics::MovementRuleset::COMPETITIVE_64, "competitive64", size, ticks);
+        if (players != 0) break;
+    }
+    return report("Scalar/SSE", mismatches);
+}
+
+int rulesets(uint32_t players) {
+    uint32_t ticks = std::max(64u, 4000000u / players);
+    uint32_t mismatches = 0;
+    for (uint8_t r = 0; r < static_cast<uint8_t>(Physics::MovementRuleset::COUNT); ++r) {
+        Physics::MovementRuleset ruleset = static_cast<Physics::MovementRuleset>(r);
+        mismatches += checkKernels(ruleset, Physics::rulesetName(ruleset), players, ticks);
+    }
+    int result = report("Ruleset scalar/SSE", mismatches);
+    return report("Profile/raw globals", checkLegacy(players, ticks)) | result;
+}
+
+}
@@ -0,0 +1,143 @@
+#include "bench_checks.h"
+#include "bench_common.h"
+#include "arena.h"
+#include "collision_world.h"
+#include "physics_types.h"
+#include "projectile_system.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <memory>
+#include <vector>
+
+namespace Bench {
+
+namespace {
+    const double TICK_BUDGET_US = 1000.0;
+
+    // Tops the pool up to `live`: every kind, thrown from anywhere in the
+    // arena at chest height, mostly level, at up to throwing speed
+    void throwGrenades(ProjectileSystem& system, uint32_t live, Random& random) {
+        const uint32_t kinds = static_cast<uint32_t>(ProjectileKind::COUNT);
+        while (system.size() < live) {
+            ProjectileKind kind = static_cast<ProjectileKind>(random.index(kinds));
+            glm::vec3 position(random.symmetric() * 44.0f, 0.2f + random.unit() * 1.5f, random.symmetric() * 44.0f);
+            glm::vec3 direction(random.symmetric(), random.symmetric() * 0.4f, random.symmetric());
+            float length = glm::length(direction);
+            direction = length > 0.0f ? direction / length : glm::vec3(1.0f, 0.0f, 0.0f);
+            float speed = (0.2f + random.unit() * 0.8f) * Physics::GRENADE_THROW_SPEED;
+            if (!system.spawn(kind, position, direction * speed, random.index(64))) break;
+        }
+    }
+
+    bool sameEvent(const ProjectileEvent& a, const ProjectileEvent& b) {
+        return a.type == b.type && a.kind == b.kind && a.material == b.material && a.owner == b.owner &&
+               a.position == b.position && a.speed == b.speed;
+    }
+
+    // step() reports a tick's contacts round by round, stepReference()
+    // projectile by projectile: compared in a common order
+    std::vector<ProjectileEvent> sortedEvents(const ProjectileSystem& system) {
+        std::vector<ProjectileEvent> events(system.getEvents(), system.getEvents() + system.getEventCount());
+        std::sort(events.begin(), events.end(), [](const ProjectileEvent& a, const ProjectileEvent& b) {
+            if (a.position.x != b.position.x) return a.position.x < b.position.x;
+            if (a.position.z != b.position.z) return a.position.z < b.position.z;
+            if (a.position.y != b.position.y) return a.position.y < b.position.y;
+            return a.type < b.type;
+        });
+        return events;
+    }
+
+    // step() against stepReference() with `live` grenades kept in the air
+    // for `ticks` ticks. Both start from the same pool every tick; the
+    // packet sweep visits triangles in the same order as sweepSphere(), so
+    // results must be bit-identical. Returns the mismatches, `stepUs` the
+    // cost of a step() tick.
+    uint32_t checkProjectiles(const CollisionWorld& world, uint32_t live, uint32_t ticks, double& stepUs) {
+        const float dt = Physics::FIXED_TIMESTEP;
+        std::unique_ptr<ProjectileSystem> batched(new ProjectileSystem());
+        std::unique_ptr<ProjectileSystem> single(new ProjectileSystem());
+        batched->setCollisionWorld(&world);
+        single->setCollisionWorld(&world);
+
+        // Refills are timed too, they are the same in both
+        double stepNs = bestOfNs([&]() {
+            Random random;
+            batched->clear();
+            for (uint32_t t = 0; t < ticks; ++t) {
+                throwGrenades(*batched, live, random);
+                batched->clearEvents();
+                batched->step(dt);
+            }
+        });
+        double referenceNs = bestOfNs([&]() {
+            Random random;
+            single->clear();
+            for (uint32_t t = 0; t < ticks; ++t) {
+                throwGrenades(*single, live, random);
+                single->clearEvents();
+                single->stepReference(dt);
+            }
+        });
+
+        Random random;
+        batched->clear();
+        uint32_t mismatches = 0, bounces = 0, detonations = 0, belowFloor = 0, overflows = 0;
+        for (uint32_t t = 0; t < ticks; ++t) {
+            throwGrenades(*batched, live, random);
+            batched->clearEvents();
+            *single = *batched;
+            const uint32_t dropped = batched->getDroppedEvents();
+            batched->step(dt);
+            single->stepReference(dt);
+
+            if (batched->size() != single->size() || batched->getEventCount() != single->getEventCount()) {
+                ++mismatches;
+                continue;
+            }
+            for (uint32_t i = 0; i < batched->size(); ++i) {
+                if (batched->getPosition(i) != single->getPosition(i) ||
+                    batched->getVelocity(i) != single->getVelocity(i) || batched->getKind(i) != single->getKind(i))
+                    ++mismatches;
+                // Inside the walls nothing may fall through the floor
+                glm::vec3 p = batched->getPosition(i);
+                if (std::fabs(p.x) < 45.0f && std::fabs(p.z) < 45.0f && p.y < 0.0f) ++belowFloor;
+            }
+            // Which events a full buffer drops depends on that order too
+            const bool overflow = batched->getDroppedEvents() != dropped;
+            if (overflow) ++overflows;
+            std::vector<ProjectileEvent> batchedEvents = sortedEvents(*batched), singleEvents = sortedEvents(*single);
+            for (size_t e = 0; e < batchedEvents.size(); ++e) {
+                if (!overflow && !sameEvent(batchedEvents[e], singleEvents[e])) ++mismatches;
+                if (batchedEvents[e].type == ProjectileEvent::Type::Bounce) ++bounces; else ++detonations;
+            }
+        }
+
+        stepUs = stepNs / ticks / 1000.0;
+        std::cout << "Projectiles " << live << " live, " << ticks << " ticks (" << world.getTriangles().size()
+                  << " triangles): " << stepUs << " us/tick, per-projectile sweeps " << referenceNs / ticks / 1000.0
+                  << " us/tick, " << bounces << " bounces, " << detonations << " detonations, " << overflows
+                  << " ticks over MAX_EVENTS, " << belowFloor << " below the floor" << std::endl;
+        return mismatches + belowFloor;
+    }
+}
+
+int projectiles(uint32_t live, uint32_t ticks) {
+    CollisionWorld world;
+    buildArena(world, 300);
+
+    const uint32_t sizes[] = {100, ProjectileSystem::CAPACITY};
+    uint32_t mismatches = 0, overBudget = 0;
+    for (uint32_t size : sizes) {
+        if (live != 0) size = live < ProjectileSystem::CAPACITY ? live : ProjectileSystem::CAPACITY;
+        double stepUs = 0.0;
+        mismatches += checkProjectiles(world, size, ticks, stepUs);
+        if (stepUs >= TICK_BUDGET_US) ++overBudget;
+        if (live != 0) break;
+    }
+    int result = report("Batched/per-projectile", mismatches);
+    return report("Over the 1 ms tick budget", overBudget) | result;
+}
+
+}
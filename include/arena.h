@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+
+class CollisionWorld;
+
+// Floor plus walls just outside the old ±45 play area, tall enough that a
+// jump (apex ~57 units) can't clear them. The floor is split by material so
+// footsteps change sound when crossing the middle. `crates` scatters that
+// many boxes over the floor (benchmarks want a deeper BVH). Builds `world`.
+void buildArena(CollisionWorld& world, uint32_t crates = 0);
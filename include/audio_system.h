@@ -10,6 +10,7 @@
 class FPSCamera;
 class PlayerController;
 class WeaponSystem;
+struct ProjectileEvent;
 
 class AudioSystem {
 public:
@@ -35,6 +36,11 @@ public:
     int playSoundEvent(Audio::AudioEvent event, const glm::vec3& position = glm::vec3(0.0f), 
                        float volume = 1.0f);
     
+    // Streaming sources (voice chat); samples are mono float PCM
+    int createStreamingSource(Audio::AudioCategory category = Audio::AudioCategory::VOICE, int sampleRate = 48000);
+    bool queueStreamSamples(int sourceId, const float* samples, size_t count);
+    size_t getQueuedStreamSamples(int sourceId) const;
+    
     // Source control
     void stopSound(int sourceId);
     void pauseSound(int sourceId);
@@ -56,6 +62,10 @@ public:
                         const std::string& reloadPhase = "start");
     void onWeaponDraw(const std::string& weaponName, const glm::vec3& position);
     void onBulletImpact(const glm::vec3& position, Audio::SurfaceMaterial material);
+    void onGrenadeBounce(const glm::vec3& position, Audio::SurfaceMaterial material, float impactSpeed);
+    void onGrenadeDetonate(const std::string& grenadeName, const glm::vec3& position);
+    // One ProjectileSystem update's bounces and detonations
+    void onProjectileEvents(const ProjectileEvent* events, uint32_t count);
     
     // Movement audio
     void onFootstep(const glm::vec3& position, Audio::SurfaceMaterial surface, 
@@ -100,6 +110,7 @@ private:
     void cleanupFinishedSources();
     void updateSourcesPosition();
     void updateEnvironmentalEffects();
+    void updateStreamingSources(float deltaTime);
     
     // Sound loading helpers
     std::shared_ptr<AudioClip> loadAudioFile(const std::string& filePath);
@@ -164,6 +175,7 @@ private:
     int m_NextSourceId = 1;
     static const int MAX_SOURCES = 64;      // Limit concurrent sounds
     static const int MAX_PRIORITY_SOURCES = 16; // Reserved for critical sounds
+    static constexpr float MAX_STREAM_BUFFER_SECONDS = 0.5f; // Cap on queued voice latency
     
     // Performance tracking
     AudioMetrics m_Metrics;
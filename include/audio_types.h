@@ -142,6 +142,14 @@ struct AudioSource {
     float occlusionLevel = 0.0f;    // 0.0 = clear, 1.0 = fully blocked
     float obstructionLevel = 0.0f;  // Partial blocking (through walls)
     
+    // Streaming (voice chat): PCM queued by a producer, consumed at streamSampleRate.
+    // streamBuffer is a ring sized once when the source is created
+    bool isStreaming = false;
+    int streamSampleRate = 48000;
+    std::vector<float> streamBuffer;
+    size_t streamReadPos = 0;       // Oldest queued sample
+    size_t streamQueued = 0;        // Samples queued from streamReadPos on
+    
     // Unique identifier
     int sourceId = -1;
 };
@@ -220,6 +228,7 @@ struct AudioMetrics {
     
     // Quality metrics
     int droppedSounds = 0;          // Sounds that couldn't play due to limits
+    int streamUnderruns = 0;        // Streaming sources that ran dry
     int occludedSounds = 0;         // Sounds currently occluded
     float compressionRatio = 0.0f;  // Audio compression efficiency
 };
@@ -0,0 +1,175 @@
+#pragma once
+
+#include "physics_types.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Result of a sweep: first contact along the motion
+struct SweepHit {
+    bool hit = false;
+    float fraction = 1.0f;          // 0..1 of the requested motion
+    glm::vec3 point{0.0f};          // Contact point on the surface
+    glm::vec3 normal{0.0f};         // Surface normal at the contact, facing the mover
+    uint32_t triangle = 0;          // Index into CollisionWorld triangles (BVH order)
+};
+
+// Surface straight below a point: the walkable "heightfield" view of the level
+struct GroundSample {
+    bool hit = false;
+    float height = 0.0f;            // World y of the surface
+    glm::vec3 normal{0.0f, 1.0f, 0.0f};
+    uint8_t material = 0;           // Level-defined id (the game uses Audio::SurfaceMaterial)
+    uint32_t triangle = 0;
+};
+
+// First surface along a ray (hitscan, line of sight)
+struct RayHit {
+    bool hit = false;
+    float distance = 0.0f;          // Along the (unit) ray direction
+    glm::vec3 point{0.0f};
+    glm::vec3 normal{0.0f};         // Facing the ray origin
+    uint8_t material = 0;
+    uint32_t triangle = 0;
+    bool entering = false;          // Crossed the front face: going into solid geometry
+};
+
+// Outcome of a moveAndSlide call
+struct SlideResult {
+    glm::vec3 position{0.0f};       // Capsule base (feet)
+    glm::vec3 velocity{0.0f};       // Velocity with blocked components removed
+    bool onGround = false;
+    glm::vec3 groundNormal{0.0f, 1.0f, 0.0f};
+    bool hitWall = false;
+    glm::vec3 wallNormal{0.0f};
+};
+
+// Static level geometry: one-sided triangles (front face = CCW winding) in
+// a flattened BVH. Players are vertical capsules, swept as a stack of
+// spheres spaced one radius apart. Queries use a fixed traversal stack and
+// never allocate. Each triangle carries a one-byte material id, kept in its
+// own array so collision queries never load it.
+class CollisionWorld {
+public:
+    struct Triangle {
+        glm::vec3 a, b, c;
+        glm::vec3 normal;
+    };
+
+    void clear();
+    void addTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, uint8_t material = 0);
+    void addQuad(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d,
+                 uint8_t material = 0);
+    void addBox(const glm::vec3& min, const glm::vec3& max, uint8_t material = 0);   // Outward-facing faces
+    void build();                                                 // Must be called after adding geometry
+
+    // Sphere / capsule sweeps. `feet` is the bottom of the capsule.
+    bool sweepSphere(const glm::vec3& center, float radius, const glm::vec3& delta, SweepHit& hit) const;
+    bool sweepCapsule(const glm::vec3& feet, float radius, float height, const glm::vec3& delta, SweepHit& hit) const;
+    // sweepCapsule against every triangle, no BVH: the reference the tree
+    // is checked against (trueshot_bench), orders of magnitude slower
+    bool sweepCapsuleLinear(const glm::vec3& feet, float radius, float height, const glm::vec3& delta,
+                            SweepHit& hit) const;
+
+    // Player move: slide along walls, walk up slopes up to the walkable
+    // limit, step over ledges up to STEP_HEIGHT, snap down to the ground.
+    // Moves shorter than the capsule radius can't tunnel, so they take a
+    // discrete move + depenetration; longer ones are swept, split into
+    // substeps of at most CCD_SUBSTEP_DISTANCE.
+    SlideResult moveAndSlide(const glm::vec3& feet, const glm::vec3& velocity, float deltaTime,
+                             bool wasOnGround, float radius = Physics::PLAYER_RADIUS,
+                             float height = Physics::PLAYER_HEIGHT) const;
+
+    // Push the capsule out of any front-facing triangle it overlaps.
+    // `normal` receives the last push direction; false if nothing overlapped.
+    bool depenetrate(glm::vec3& feet, glm::vec3& normal, float radius = Physics::PLAYER_RADIUS,
+                     float height = Physics::PLAYER_HEIGHT) const;
+
+    // Ground probe straight down from the feet; true on a walkable surface
+    bool findGround(const glm::vec3& feet, float maxDistance, SweepHit& hit,
+                    float radius = Physics::PLAYER_RADIUS, float height = Physics::PLAYER_HEIGHT) const;
+
+    // Highest upward-facing surface on the vertical line through `point`,
+    // between point.y and point.y - maxDistance. A ray, not a capsule: it
+    // answers "what is underfoot" (height, normal, material), not collision.
+    bool traceGround(const glm::vec3& point, float maxDistance, GroundSample& sample) const;
+
+    // Nearest triangle, either face, hit by origin + t * direction for
+    // t in [0, maxDistance]. `direction` must be unit length. Children are
+    // visited near first and anything beyond the current hit is skipped.
+    bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, RayHit& hit) const;
+
+    // Every surface along the ray within maxDistance, nearest first: the
+    // nearest `maxHits` from one traversal, skipping nodes beyond the last
+    // kept hit once the list is full. Entry and exit points alternate
+    // through closed solids (`entering`); a ray through a shared edge
+    // reports it once. Returns the number of hits written.
+    uint32_t raycastAll(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                        RayHit* hits, uint32_t maxHits) const;
+
+    // raycast() for a bundle of rays (shotgun pellets, probes from nearby
+    // origins), one traversal per MAX_PACKET_RAYS. Each node is tested for
+    // four rays at a time and only descended by the rays that enter it
+    // before their own current hit, so rays drop out independently.
+    // Fills hits[0, count), returns how many hit. Coherent rays are the
+    // fast case; scattered ones are still correct, just not faster.
+    static const uint32_t MAX_PACKET_RAYS = 16;
+    uint32_t raycastPacket(const glm::vec3* origins, const glm::vec3* directions, uint32_t count,
+                           float maxDistance, RayHit* hits) const;
+
+    // sweepSphere() for a batch of unrelated spheres (projectiles), one
+    // traversal per MAX_PACKET_SPHERES. Nodes and leaf triangles are
+    // tested against four swept bounds at a time, and only the spheres
+    // that overlap go on; triangles are visited in query order, so every
+    // result is exactly what sweepSphere() returns. Nearby spheres are the
+    // fast case. Fills hits[0, count), returns how many hit.
+    static const uint32_t MAX_PACKET_SPHERES = 8;
+    uint32_t sweepSpherePacket(const glm::vec3* centers, const float* radii, const glm::vec3* deltas,
+                               uint32_t count, SweepHit* hits) const;
+
+    uint8_t getMaterial(uint32_t triangle) const { return m_Materials[triangle]; }
+
+    const std::vector<Triangle>& getTriangles() const { return m_Triangles; }
+    size_t getNodeCount() const { return m_Nodes.size(); }
+
+private:
+    // 32 bytes: two nodes per cache line. Leaf when count > 0, then
+    // `first` indexes m_Triangles; otherwise children are first, first + 1.
+    struct Node {
+        glm::vec3 min;
+        uint32_t first;
+        glm::vec3 max;
+        uint32_t count;
+    };
+
+    static const uint32_t MAX_LEAF_TRIANGLES = 4;
+    static const uint32_t MAX_STACK_DEPTH = 64;
+    static constexpr uint32_t MAX_CAPSULE_SPHERES = 16;
+
+    void subdivide(uint32_t nodeIndex, std::vector<uint32_t>& order,
+                   const std::vector<glm::vec3>& centroids, uint32_t depth);
+    void updateBounds(Node& node, const std::vector<uint32_t>& order) const;
+
+    template <typename Visitor>
+    void query(const glm::vec3& boxMin, const glm::vec3& boxMax, Visitor&& visit) const;
+
+    uint32_t capsuleSpheres(const glm::vec3& feet, float radius, float height, glm::vec3* centers) const;
+    void slide(SlideResult& result, glm::vec3 remaining, bool wasOnGround, float radius, float height) const;
+
+    bool sweepSpheres(const glm::vec3* centers, uint32_t count, float radius,
+                      const glm::vec3& delta, SweepHit& hit) const;
+
+#if defined(__SSE2__)
+    uint32_t tracePacket(const glm::vec3* origins, const glm::vec3* directions, uint32_t count,
+                         float maxDistance, RayHit* hits) const;     // count <= MAX_PACKET_RAYS
+    uint32_t sweepPacket(const glm::vec3* centers, const float* radii, const glm::vec3* deltas,
+                         uint32_t count, SweepHit* hits) const;     // count <= MAX_PACKET_SPHERES
+#endif
+    void fillRayHit(const glm::vec3& origin, const glm::vec3& direction, uint32_t triangle, float distance,
+                    RayHit& hit) const;
+
+    std::vector<Triangle> m_Triangles;
+    std::vector<uint8_t> m_Materials;       // Parallel to m_Triangles
+    std::vector<Node> m_Nodes;
+};
@@ -9,6 +9,7 @@ public:
 
     void processMouseMovement(float xoffset, float yoffset);
     void setPosition(const glm::vec3& pos);
+    void setViewAngles(float yaw, float pitch);
     glm::vec3 getForward() const;
     glm::mat4 getViewMatrix() const;
 
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "input_source.h"
+#include "input_event_queue.h"
+
+#include <GLFW/glfw3.h>
+#include <cstdint>
+
+// Keyboard/mouse input of a GLFW window, split across two threads.
+//
+// The thread that owns the window (GLFW only delivers events there) runs
+// pump(): it wakes on every event, or at least every millisecond, and the
+// callbacks push timestamped events into a lock-free queue. The simulation
+// thread calls beginFrame() to drain them, then reads held state, press
+// timestamps and mouse motion without ever touching GLFW's key state.
+//
+// Mouse motion never takes the last BUTTON_RESERVE slots of the queue; when
+// it can't get in, deltas are summed on the input thread until it can. A
+// button event that finds the queue full is kept per action and resent, in
+// order, on the next callback or pump wakeup, so a release is never lost.
+class GlfwInputSource : public InputSource {
+public:
+    explicit GlfwInputSource(GLFWwindow* window);
+
+    // Input thread: returns when the window is asked to close
+    void pump(double rateHz = 1000.0);
+
+    // Simulation thread: call once per frame before reading input, with
+    // the frame's glfwGetTime()
+    void beginFrame(double sampleTime);
+    void takeMouseDelta(float& dx, float& dy);
+    // Simulation thread: a fixed tick has run on everything drained so far;
+    // `time` (glfwGetTime) closes their latency samples
+    void onTickConsumed(double time);
+
+    bool isDown(InputAction action) const override;
+    float pressAge(InputAction action) const override;
+
+    // Event-to-tick latency since the previous call
+    struct LatencyStats {
+        float averageMs = 0.0f;
+        float maxMs = 0.0f;
+        uint32_t events = 0;
+        uint32_t queueFull = 0;             // Pushes held back by a full queue, all time
+    };
+    LatencyStats takeLatencyStats();
+
+private:
+    static const uint32_t ACTION_COUNT = static_cast<uint32_t>(InputAction::COUNT);
+    static const uint32_t BUTTON_RESERVE = 64;  // Queue slots mouse motion leaves free
+
+    static void keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods);
+    static void mouseButtonCallback(GLFWwindow* window, int button, int action, int mods);
+    static void cursorPosCallback(GLFWwindow* window, double x, double y);
+    void pushAction(InputAction action, bool pressed);
+    void deferAction(uint32_t index, bool pressed, double time);
+    void flushDeferred();
+
+    GLFWwindow* m_Window;
+    InputEventQueue m_Queue;
+
+    // Input thread only
+    bool m_FirstCursor = true;
+    double m_LastCursorX = 0.0;
+    double m_LastCursorY = 0.0;
+    uint8_t m_BindingsDown[ACTION_COUNT] = {};  // Bound keys/buttons held, per action
+    uint32_t m_DeferredPress = 0;           // Button events waiting for queue room
+    uint32_t m_DeferredRelease = 0;
+    uint32_t m_DeferredPressLast = 0;       // Set when both wait and the press came last
+    double m_DeferredPressTime[ACTION_COUNT] = {};
+    double m_DeferredReleaseTime[ACTION_COUNT] = {};
+    float m_DeferredDX = 0.0f;              // Mouse motion waiting for queue room
+    float m_DeferredDY = 0.0f;
+    double m_DeferredMoveTime = 0.0;        // Oldest motion in the sum
+    bool m_HasDeferredMove = false;
+
+    // Simulation thread only
+    double m_SampleTime = 0.0;
+    uint32_t m_Held = 0;
+    uint32_t m_FramePresses = 0;            // Pressed since the previous sample
+    double m_FramePressTime[ACTION_COUNT] = {};
+    float m_MouseDX = 0.0f;
+    float m_MouseDY = 0.0f;
+    uint32_t m_UnconsumedCount = 0;         // Drained, not yet seen by a tick
+    double m_UnconsumedTimeSum = 0.0;
+    double m_UnconsumedOldest = 0.0;
+    double m_LatencySum = 0.0;
+    double m_LatencyMax = 0.0;
+    uint32_t m_LatencyCount = 0;
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include "weapon_types.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+class CollisionWorld;
+class RandomStream;
+
+// Instant-hit shots against the level and player hitboxes
+namespace Hitscan {
+    // A shootable player: upright body at `feet`, facing `yaw` (degrees,
+    // same convention as PlayerController)
+    struct Target {
+        int id = -1;
+        glm::vec3 feet{0.0f};
+        float yaw = 0.0f;
+    };
+
+    // One body part, in the target's local frame (x right, y up, z forward).
+    // A capsule with a == b is a sphere.
+    struct Hitbox {
+        HitResult::HitLocation location;
+        glm::vec3 a, b;
+        float radius;
+    };
+
+    const uint32_t HITBOX_COUNT = 7;
+    const Hitbox* getHitboxes();                // HITBOX_COUNT entries
+
+    // Ray against a capsule; `t` is the entry distance along the unit
+    // `direction`, `normal` the outward surface normal there
+    bool rayCapsule(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& a,
+                    const glm::vec3& b, float radius, float& t, glm::vec3& normal);
+
+    // Every target's hitboxes posed in world space, as struct-of-arrays
+    // capsules: LANES slots per target, the last one padding. Rebuild it
+    // whenever the poses change (each tick, or once per rewound tick for
+    // lag compensation); raycasts then only read it.
+    // A raycast first rejects targets by their bounding spheres, four at a
+    // time, then tests each survivor's capsules in one iteration, two SSE2
+    // registers of four; the scalar path is the reference and the fallback
+    // for non-SSE builds.
+    // Both restart the ray at the bounding sphere, so the capsule math stays
+    // in float precision however far away the shooter is.
+    class HitboxSet {
+    public:
+        static const uint32_t LANES = 8;
+
+        void build(const Target* targets, uint32_t count);
+        void clear();
+        uint32_t size() const { return static_cast<uint32_t>(m_Ids.size()); }
+
+        // Nearest hitbox closer than `maxDistance`; fills hitPoint, hitNormal,
+        // distance, hitLocation, isHeadshot and targetId of `result`.
+        // `ignoreId` skips the shooter.
+        bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                     int ignoreId, HitResult& result) const;
+        bool raycastScalar(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                           int ignoreId, HitResult& result) const;
+
+    private:
+        bool enterBounds(uint32_t target, const glm::vec3& origin, const glm::vec3& direction,
+                         float maxDistance, float& skip) const;
+        void fillHit(uint32_t slot, const glm::vec3& origin, const glm::vec3& direction, float t,
+                     HitResult& result) const;
+
+        // Per capsule slot, target * LANES + hitbox
+        std::vector<float> m_AX, m_AY, m_AZ;
+        std::vector<float> m_BX, m_BY, m_BZ;
+        std::vector<float> m_Radius;
+        // Per target; bounding sphere centers are padded to a multiple of four
+        std::vector<int> m_Ids;
+        std::vector<float> m_CX, m_CY, m_CZ;
+    };
+
+    // How costly a surface is to shoot through, per meter, relative to wood.
+    // Indexed by material id (Audio::SurfaceMaterial).
+    float getMaterialDensity(uint8_t material);
+
+    const uint32_t MAX_SURFACES = 16;           // Entry/exit points a penetrating trace considers
+
+    // The nearest hit along the ray within `maxRange`, world or player.
+    // The level goes first and its distance caps the hitbox tests.
+    // With `penetration` > 0 the level is collected once as ordered entry
+    // and exit points (CollisionWorld::raycastAll), and the bullet crosses
+    // each wall whose thickness x density it can still afford, looking for
+    // players between walls; damageScale and penetrations record the cost.
+    // `damage` is left at 0 for the caller.
+    HitResult trace(const CollisionWorld* world, const HitboxSet* hitboxes, const glm::vec3& origin,
+                    const glm::vec3& direction, float maxRange, int ignoreId = -1, float penetration = 0.0f);
+
+    // trace() for rays fired together (shotgun pellets): the level is
+    // traced as ray packets, then each ray against the hitboxes. Pellets
+    // don't penetrate.
+    void tracePacket(const CollisionWorld* world, const HitboxSet* hitboxes, const glm::vec3* origins,
+                     const glm::vec3* directions, uint32_t count, float maxRange, int ignoreId,
+                     HitResult* results);
+
+    // Spread cone of a shot, in degrees: base, plus the moving penalty
+    // scaled by `speedFraction` (speed over full run speed) and the airborne
+    // one, times the ADS reduction at `adsProgress`, plus `recoil` (length
+    // of the accumulated recoil). Never negative.
+    float shotSpread(const Weapons::WeaponStats& stats, float speedFraction, bool airborne,
+                     float adsProgress, float recoil);
+
+    // `direction` turned by a random offset within `spreadDegrees`, uniform
+    // over the cone's disc. Draws the angle, then the radius, from `random`
+    // (nothing if the spread is 0), so the client's prediction and the
+    // server's replay of a shot stream agree.
+    glm::vec3 spreadDirection(const glm::vec3& direction, float spreadDegrees, RandomStream& random);
+}
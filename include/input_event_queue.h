@@ -0,0 +1,58 @@
+#pragma once
+
+#include "input_source.h"
+
+#include <atomic>
+#include <cstdint>
+
+// One raw input event, stamped (glfwGetTime seconds) when the window
+// system delivered it to the input thread.
+struct InputEvent {
+    enum class Type : uint8_t { Press, Release, MouseMove };
+
+    Type type = Type::Press;
+    InputAction action = InputAction::COUNT;
+    float dx = 0.0f;                // MouseMove only, in mouse counts
+    float dy = 0.0f;
+    double time = 0.0;
+};
+
+// Single producer (the input thread) / single consumer (the simulation)
+// ring. Never blocks or allocates. A push that finds the ring full fails and
+// is counted; the producer keeps the event and retries (see
+// GlfwInputSource), the consumer being at least a frame behind.
+class InputEventQueue {
+public:
+    static const uint32_t CAPACITY = 1024;     // Power of two
+
+    // `reserve` slots stay free for other pushes: mouse motion passes the
+    // room it leaves to button events
+    bool push(const InputEvent& event, uint32_t reserve = 0) {
+        uint32_t head = m_Head.load(std::memory_order_relaxed);
+        if (head - m_Tail.load(std::memory_order_acquire) + reserve >= CAPACITY) {
+            m_Full.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        m_Events[head & (CAPACITY - 1)] = event;
+        m_Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(InputEvent& event) {
+        uint32_t tail = m_Tail.load(std::memory_order_relaxed);
+        if (tail == m_Head.load(std::memory_order_acquire)) return false;
+        event = m_Events[tail & (CAPACITY - 1)];
+        m_Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    uint32_t getFullCount() const { return m_Full.load(std::memory_order_relaxed); }
+
+private:
+    static_assert((CAPACITY & (CAPACITY - 1)) == 0, "CAPACITY must be a power of two");
+
+    alignas(64) std::atomic<uint32_t> m_Head{0};
+    alignas(64) std::atomic<uint32_t> m_Tail{0};
+    std::atomic<uint32_t> m_Full{0};
+    InputEvent m_Events[CAPACITY];
+};
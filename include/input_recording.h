@@ -0,0 +1,63 @@
+#pragma once
+
+#include "player_controller.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class CollisionWorld;
+
+// One rendered frame of player input, as PlayerController saw it: the frame
+// time, the held buttons, the view angles after mouse look and recoil, and
+// how long before the frame's sample jump was pressed.
+struct RecordedFrame {
+    float deltaTime = 0.0f;
+    uint32_t buttons = 0;           // Bit per InputAction
+    float yaw = 0.0f;
+    float pitch = 0.0f;
+    float jumpAge = 0.0f;           // Sub-frame timestamp of a jump press
+};
+
+struct ReplayResult {
+    bool checksumMatch = false;
+    uint64_t checksum = 0;
+    uint32_t ticks = 0;             // Physics ticks per pass
+    double nsPerTick = 0.0;         // Best pass
+};
+
+// Captures a session's input to a compact binary file and replays it
+// headlessly through a fresh PlayerController. The final-state checksum is
+// stored on save, so a replay tells whether physics changes altered the
+// outcome, and how long each tick took.
+class InputRecording {
+public:
+    void begin(const PlayerController& player);
+    void addFrame(float deltaTime, const InputSource& input, const PlayerController& player);
+    void finish(const PlayerController& player);        // Stores the expected checksum
+
+    bool save(const std::string& path) const;
+    bool load(const std::string& path);
+
+    // Plays every frame `passes` times, each from the recorded start state
+    ReplayResult replay(const CollisionWorld* world, int passes = 1) const;
+
+    // Bit-exact hash of the state that matters for movement feel
+    static uint64_t checksum(const PlayerController& player);
+
+    size_t getFrameCount() const { return m_Frames.size(); }
+    uint64_t getExpectedChecksum() const { return m_Checksum; }
+
+private:
+    static const uint32_t MAGIC = 0x52495354;          // "TSIR"
+    static const uint16_t VERSION = 2;
+
+    void replayPass(PlayerController& player) const;
+
+    glm::vec3 m_StartPosition{0.0f};
+    float m_StartYaw = 0.0f;
+    float m_StartPitch = 0.0f;
+    uint64_t m_Checksum = 0;
+    std::vector<RecordedFrame> m_Frames;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+// Actions the gameplay code reads, independent of any windowing library
+enum class InputAction : uint8_t {
+    MOVE_FORWARD,
+    MOVE_BACK,
+    MOVE_LEFT,
+    MOVE_RIGHT,
+    JUMP,
+    CROUCH,
+    FIRE,
+    AIM,
+    RELOAD,
+    INSPECT,
+    SLOT_1,
+    SLOT_2,
+    SLOT_3,
+    SLOT_4,
+    SLOT_5,
+    VOLUME_UP,
+    VOLUME_DOWN,
+    AUDIO_DEBUG,
+    THROW_GRENADE,
+    SLOT_6,             // After the others: recordings store actions by index
+    COUNT
+};
+
+// Source of held-button state for one player. The client polls a window
+// (GlfwInputSource); a server or bot fills a StateInputSource instead.
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+    virtual bool isDown(InputAction action) const = 0;
+
+    // Seconds between the press of `action` and the moment this frame's
+    // input was sampled, for presses since the previous sample. 0 when the
+    // source has no timestamps: the press then counts as happening at the
+    // sample, which is where polling would have seen it.
+    virtual float pressAge(InputAction) const { return 0.0f; }
+};
+
+// Plain bitmask of held actions, set by code (network input, bots, replays)
+class StateInputSource : public InputSource {
+public:
+    bool isDown(InputAction action) const override {
+        return (m_Held >> static_cast<uint32_t>(action)) & 1u;
+    }
+    float pressAge(InputAction action) const override {
+        return m_PressAge[static_cast<uint32_t>(action)];
+    }
+    void setPressAge(InputAction action, float age) { m_PressAge[static_cast<uint32_t>(action)] = age; }
+
+    void set(InputAction action, bool down) {
+        uint32_t bit = 1u << static_cast<uint32_t>(action);
+        m_Held = down ? (m_Held | bit) : (m_Held & ~bit);
+    }
+    void clear() {
+        m_Held = 0;
+        for (float& age : m_PressAge) age = 0.0f;
+    }
+
+    // Snapshot another source (e.g. the window) into this mask
+    void capture(const InputSource& source) {
+        m_Held = 0;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(InputAction::COUNT); ++i) {
+            InputAction action = static_cast<InputAction>(i);
+            if (source.isDown(action)) m_Held |= 1u << i;
+            m_PressAge[i] = source.pressAge(action);
+        }
+    }
+
+    uint32_t getMask() const { return m_Held; }
+    void setMask(uint32_t mask) { m_Held = mask; }
+
+private:
+    uint32_t m_Held = 0;
+    float m_PressAge[static_cast<uint32_t>(InputAction::COUNT)] = {};
+};
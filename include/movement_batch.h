@@ -0,0 +1,62 @@
+#pragma once
+
+#include "physics_types.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+// Struct-of-arrays movement for many players stepped together (the
+// server's players, client prediction). Same rules as
+// PlayerController::updatePhysics without a collision world, sub-step jumps
+// included, minus audio and metrics: the kernel only clamps to the floor,
+// walls are resolved by the caller after step(). trueshot_bench parity
+// checks the two tick for tick.
+// With SSE2 four players are processed per iteration; the remainder and
+// non-SSE builds take the scalar path, which uses the same math.
+// The kernels are instantiated per movement profile (physics_types.h); the
+// ruleset is a per-match choice, dispatched once per step().
+class MovementBatch {
+public:
+    explicit MovementBatch(size_t capacity = 0,
+                           Physics::MovementRuleset ruleset = Physics::MovementRuleset::COMPETITIVE_64);
+
+    void setRuleset(Physics::MovementRuleset ruleset) { m_Ruleset = ruleset; }
+    Physics::MovementRuleset getRuleset() const { return m_Ruleset; }
+    float getFixedTimestep() const;     // Step size the ruleset is tuned for
+
+    size_t add(const glm::vec3& position);
+    void clear();
+    size_t size() const { return m_Count; }
+
+    // Wish direction from view yaw (degrees) and WASD input, as PlayerController
+    // does. `jumpAt` is when in the next step jump was pressed (0-1).
+    void setInput(size_t i, float yaw, const glm::vec2& moveInput, bool jumpPressed, float jumpAt = 0.0f);
+
+    void step(float deltaTime);
+
+    // The scalar kernel for every player: what non-SSE builds run, and the
+    // reference step() is checked against (trueshot_bench)
+    void stepReference(float deltaTime);
+
+    // Columns, valid for [0, size())
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> velX, velY, velZ;
+    std::vector<float> wishX, wishZ;        // Normalized, zero when no movement key is held
+    std::vector<float> surfaceFriction;
+    std::vector<float> airTime;
+    std::vector<float> speed;               // Horizontal speed after the last step
+    std::vector<uint8_t> onGround;
+    std::vector<uint8_t> wishJump;
+    std::vector<float> jumpOffset;          // When in the step the jump was pressed (0-1)
+
+private:
+    template <typename Profile> void stepProfile(float deltaTime);
+    template <typename Profile> void stepScalar(size_t begin, size_t end, float deltaTime);
+#if defined(__SSE2__)
+    template <typename Profile> void stepSSE(size_t begin, size_t end, float deltaTime);
+#endif
+
+    size_t m_Count = 0;
+    Physics::MovementRuleset m_Ruleset;
+};
@@ -1,41 +1,136 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <cstdint>
+#include <cstring>
 
 // Constantes physiques optimisées pour strafe jumping
 namespace Physics {
     // Movement constants
-    const float GRAVITY = 800.0f;                  // units/sec²
-    const float JUMP_IMPULSE = 301.993377f;        // Exact CS value
+    constexpr float GRAVITY = 800.0f;                  // units/sec²
+    constexpr float JUMP_IMPULSE = 301.993377f;        // Exact CS value
     
     // Ground movement
-    const float MAX_GROUND_SPEED = 250.0f;         // units/sec
-    const float GROUND_ACCELERATION = 10.0f;
-    const float GROUND_FRICTION = 4.0f;
+    constexpr float MAX_GROUND_SPEED = 250.0f;         // units/sec
+    constexpr float GROUND_ACCELERATION = 10.0f;
+    constexpr float GROUND_FRICTION = 4.0f;
     
     // Air movement (optimisé pour bunny hop)
-    const float AIR_MAX_SPEED = 30.0f;             // Max speed from WASD in air
-    const float AIR_ACCELERATION = 12.0f;          // Air strafe acceleration
-    const float AIR_FRICTION = 0.25f;              // Minimal air friction
+    constexpr float AIR_MAX_SPEED = 30.0f;             // Max speed from WASD in air
+    constexpr float AIR_ACCELERATION = 12.0f;          // Air strafe acceleration
+    constexpr float AIR_FRICTION = 0.25f;              // Minimal air friction
     
     // Strafe jumping optimizations
-    const float OPTIMAL_STRAFE_ANGLE = 30.0f;      // Degrees - optimal mouse/movement angle
-    const float MAX_AIR_SPEED_CAP = 3000.0f;       // Absolute maximum (pour éviter les bugs)
-    const float BHOP_SPEED_LOSS = 0.95f;           // 5% loss on bad landing
+    constexpr float OPTIMAL_STRAFE_ANGLE = 30.0f;      // Degrees - optimal mouse/movement angle
+    constexpr float MAX_AIR_SPEED_CAP = 3000.0f;       // Absolute maximum (pour éviter les bugs)
+    constexpr float BHOP_SPEED_LOSS = 0.95f;           // 5% loss on bad landing
     
     // Fixed timestep pour consistency
-    const float TICK_RATE = 64.0f;                 // 64 tick/sec
-    const float FIXED_TIMESTEP = 1.0f / TICK_RATE;
+    constexpr float TICK_RATE = 64.0f;                 // 64 tick/sec
+    constexpr float FIXED_TIMESTEP = 1.0f / TICK_RATE;
+    constexpr int MAX_STEPS_PER_FRAME = 8;             // Beyond this (125 ms) time is dropped, not caught up
     
     // Ground detection améliorée
-    const float GROUND_TRACE_DISTANCE = 2.0f;      
-    const float PLAYER_HEIGHT = 1.8f;
-    const float PLAYER_RADIUS = 0.3f;
-    const float GROUND_TOLERANCE = 0.1f;           // Tolerance pour "on ground"
+    constexpr float GROUND_TRACE_DISTANCE = 2.0f;      
+    constexpr float PLAYER_HEIGHT = 1.8f;
+    constexpr float PLAYER_RADIUS = 0.3f;
+    constexpr float GROUND_TOLERANCE = 0.1f;           // Tolerance pour "on ground"
     
+    // Level collision
+    constexpr float STEP_HEIGHT = 0.45f;               // Max ledge walked up without jumping
+    constexpr float GROUND_CELL_SIZE = 2.0f;           // Surface material cache granularity (XZ)
+    constexpr float WALKABLE_NORMAL_Y = 0.7f;          // ~45° steepest walkable slope
+    constexpr float COLLISION_SKIN = 0.01f;            // Gap kept between capsule and geometry
+    constexpr int MAX_SLIDE_ITERATIONS = 4;
+    constexpr float CCD_SUBSTEP_DISTANCE = 2.0f;       // Longest swept move per substep
+    constexpr int MAX_CCD_SUBSTEPS = 32;               // Covers MAX_AIR_SPEED_CAP at 64 tick
+    constexpr int DEPENETRATION_ITERATIONS = 4;
+
+    // Grenades
+    constexpr float GRENADE_GRAVITY_SCALE = 0.4f;      // Fraction of GRAVITY
+    constexpr float GRENADE_THROW_SPEED = 675.0f;      // units/sec
+    constexpr float GRENADE_REST_SPEED = 20.0f;        // Slower floor impacts roll instead of bouncing
+    constexpr float GRENADE_ROLL_FRICTION = 200.0f;    // units/sec² while rolling
+    constexpr float GRENADE_STOP_SPEED = 5.0f;
+
+    // View
+    constexpr float MOUSE_SENSITIVITY = 0.1f;          // Degrees per mouse count
+    constexpr float MAX_PITCH = 89.0f;
+
     // Collision improvements
-    const float WALL_BOUNCE_FACTOR = 0.8f;         // Bounce off walls
-    const float MIN_WALL_SPEED = 50.0f;            // Min speed to bounce
+    constexpr float WALL_BOUNCE_FACTOR = 0.8f;         // Bounce off walls
+    constexpr float MIN_WALL_SPEED = 50.0f;            // Min speed to bounce
+
+    // Movement rulesets. A profile is a set of compile-time tuning values;
+    // kernels templated on it get every constant folded in, one
+    // instantiation per profile, and a match picks its ruleset at start.
+    struct Competitive64 {
+        static constexpr float TICK_RATE = Physics::TICK_RATE;
+        static constexpr float GRAVITY = Physics::GRAVITY;
+        static constexpr float JUMP_IMPULSE = Physics::JUMP_IMPULSE;
+        static constexpr float MAX_GROUND_SPEED = Physics::MAX_GROUND_SPEED;
+        static constexpr float GROUND_ACCELERATION = Physics::GROUND_ACCELERATION;
+        static constexpr float GROUND_FRICTION = Physics::GROUND_FRICTION;
+        static constexpr float AIR_MAX_SPEED = Physics::AIR_MAX_SPEED;
+        static constexpr float AIR_ACCELERATION = Physics::AIR_ACCELERATION;
+        static constexpr float AIR_FRICTION = Physics::AIR_FRICTION;
+        static constexpr float OPTIMAL_STRAFE_ANGLE = Physics::OPTIMAL_STRAFE_ANGLE;
+        static constexpr float MAX_AIR_SPEED_CAP = Physics::MAX_AIR_SPEED_CAP;
+    };
+
+    // Twice the tick rate. Each step loses JUMP_IMPULSE * dt / 2 of jump
+    // height to the integration, so the impulse is lowered to keep the
+    // 64 tick apex (54.6 units): the same crates are reachable.
+    struct Competitive128 : Competitive64 {
+        static constexpr float TICK_RATE = 128.0f;
+        static constexpr float JUMP_IMPULSE = 298.82f;
+    };
+
+    // Forgiving public servers: more air control, quicker stops, and bunny
+    // hops top out at a sprint instead of MAX_AIR_SPEED_CAP
+    struct Casual : Competitive64 {
+        static constexpr float GROUND_FRICTION = 6.0f;
+        static constexpr float AIR_ACCELERATION = 20.0f;
+        static constexpr float MAX_AIR_SPEED_CAP = 400.0f;
+    };
+
+    enum class MovementRuleset : uint8_t {
+        COMPETITIVE_64,
+        COMPETITIVE_128,
+        CASUAL,
+        COUNT
+    };
+
+    // Calls fn(Profile{}) with the profile matching `ruleset`
+    template <typename Fn>
+    inline auto withProfile(MovementRuleset ruleset, Fn&& fn) {
+        switch (ruleset) {
+            case MovementRuleset::COMPETITIVE_128: return fn(Competitive128{});
+            case MovementRuleset::CASUAL: return fn(Casual{});
+            case MovementRuleset::COMPETITIVE_64:
+            default: return fn(Competitive64{});
+        }
+    }
+
+    // Ruleset names as given on the command line
+    inline const char* rulesetName(MovementRuleset ruleset) {
+        switch (ruleset) {
+            case MovementRuleset::COMPETITIVE_128: return "competitive128";
+            case MovementRuleset::CASUAL: return "casual";
+            case MovementRuleset::COMPETITIVE_64:
+            default: return "competitive64";
+        }
+    }
+
+    inline bool parseRuleset(const char* name, MovementRuleset& ruleset) {
+        for (uint8_t r = 0; r < static_cast<uint8_t>(MovementRuleset::COUNT); ++r) {
+            if (std::strcmp(name, rulesetName(static_cast<MovementRuleset>(r))) == 0) {
+                ruleset = static_cast<MovementRuleset>(r);
+                return true;
+            }
+        }
+        return false;
+    }
 }
 
 struct MovementState {
@@ -45,6 +140,8 @@ struct MovementState {
     
     bool onGround = false;
     bool wishJump = false;
+    uint32_t wishJumpTick = 0;          // Tick the jump press falls in
+    float wishJumpFraction = 0.0f;      // ...and how far into it (0-1)
     bool wasOnGround = false;           // Previous frame ground state
     
     float surfaceFriction = 1.0f;
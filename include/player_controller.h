@@ -2,31 +2,90 @@
 
 #include "physics_types.h"
 #include "audio_system.h"
+#include "input_source.h"
 
 #include <glm/glm.hpp>
-#include <GLFW/glfw3.h>
+
+#include <cstdint>
+#include <type_traits>
 
 class FPSCamera;
+class CollisionWorld;
+
+// Everything a fixed physics step reads or writes. Copying it is a complete
+// rollback point; the frame accumulator and render blend are not included,
+// they belong to the frame, not to the simulation.
+struct PlayerSimState {
+    MovementState movement;
+    MovementInput input;
+    float yaw = 0.0f;
+    float pitch = 0.0f;
+    float gameTime = 0.0f;
+    float groundTime = 0.0f;
+    float lastFootstepTime = 0.0f;
+    glm::vec3 lastFootstepPos{0.0f};
+    bool wasOnGroundAudio = true;
+    uint32_t tick = 0;
+};
+static_assert(std::is_trivially_copyable<PlayerSimState>::value, "PlayerSimState must stay memcpy-able");
 
+// One tick of player commands, as sent over the network or recorded
+struct PlayerTickInput {
+    uint32_t buttons = 0;           // Bit per InputAction
+    float yaw = 0.0f;
+    float pitch = 0.0f;
+    float jumpOffset = 0.0f;        // When in the tick jump was pressed (0-1)
+};
+
+// Self-contained: all movement state lives in the instance and the camera is
+// optional, so a server or bot host can run any number of controllers.
 class PlayerController {
 public:
-    PlayerController(FPSCamera* camera);
+    explicit PlayerController(FPSCamera* camera = nullptr);
 
     // Main update function - fixed timestep
     void update(float deltaTime);
     
     // Input processing
-    void processInput(GLFWwindow* window, float deltaTime);
+    void processInput(const InputSource& input, float deltaTime);
     void processMouseInput(float xOffset, float yOffset);
 
+    // Rollback: save/restore the full simulation state, step one tick with
+    // explicit input, or rewind to a recorded tick and replay. Replayed
+    // ticks play no sounds and print nothing.
+    PlayerSimState saveState() const;
+    void restoreState(const PlayerSimState& state);
+    void simulateTick(const PlayerTickInput& input);
+    bool resimulate(uint32_t fromTick, const PlayerTickInput* inputs, size_t count);
+    uint32_t getTick() const { return m_Tick; }
+    void setReplaying(bool replaying) { m_Replaying = replaying; }    // Silent, for headless playback
+
+    // View angles (degrees), owned here and pushed to the camera if any
+    void addViewAngles(float yawDelta, float pitchDelta);
+    void setViewAngles(float yaw, float pitch);
+    float getYaw() const { return m_Yaw; }
+    float getPitch() const { return m_Pitch; }
+    glm::vec3 getViewForward() const;
+
     // Getters
     glm::vec3 getPosition() const { return m_State.position; }
+    // Between the last two physics steps, for rendering and the camera
+    glm::vec3 getRenderPosition() const { return m_RenderPosition; }
+    float getInterpolationAlpha() const { return m_TimeAccumulator / Physics::FIXED_TIMESTEP; }
+    float getDroppedTime() const { return m_DroppedTime; }
+    // Eye position at an input event `inputAge` seconds before this frame's
+    // sample, extrapolated from the last step. Call before update(deltaTime).
+    glm::vec3 getPositionAtInput(float inputAge, float deltaTime) const;
     glm::vec3 getVelocity() const { return m_State.velocity; }
     float getSpeed() const { return m_State.speed; }
     bool isOnGround() const { return m_State.onGround; }
+    // Material underfoot; traced against the level only when the feet change cell
+    Audio::SurfaceMaterial getGroundSurface();
 
     // Setters
     void setAudioSystem(AudioSystem* audioSystem) { m_AudioSystem = audioSystem; }
+    void setCollisionWorld(const CollisionWorld* world) { m_World = world; m_GroundCache.valid = false; }
+    void setPosition(const glm::vec3& position);
     
     // Debug info
     const MovementState& getMovementState() const { return m_State; }
@@ -60,20 +119,50 @@ private:
     
     // Input processing amélioré
     void updateInputTiming(float deltaTime);
+    void scheduleJump(float secondsAhead);      // Relative to the start of the next tick
+
+    // One fixed step, recorded in the rollback history
+    void stepTick();
+    AudioSystem* audio() const { return m_Replaying ? nullptr : m_AudioSystem; }
 
 private:
     MovementState m_State;
     MovementInput m_Input;
     FPSCamera* m_Camera;
     AudioSystem* m_AudioSystem = nullptr;
+    const CollisionWorld* m_World = nullptr;   // Level geometry; falls back to the flat test arena when null
+
+    // View angles, same convention as FPSCamera
+    float m_Yaw = -90.0f;
+    float m_Pitch = 0.0f;
 
     // Pour le timing des sauts et autres mécaniques
     float m_GameTime = 0.0f;
+    float m_GroundTime = 0.0f;          // Time grounded since last hop (bhop combo reset)
+    bool m_WasOnGroundAudio = true;     // Ground state at last jump/land sound check
 
     // Footstep tracking
     float m_LastFootstepTime = 0.0f;
     glm::vec3 m_LastFootstepPos{0.0f};
+
+    // Last ground trace, keyed by cell. Derived from the level only, so it
+    // survives rollback and is not part of PlayerSimState.
+    struct GroundCache {
+        bool valid = false;
+        int32_t cellX = 0, cellY = 0, cellZ = 0;
+        Audio::SurfaceMaterial surface = Audio::SurfaceMaterial::CONCRETE;
+    };
+    GroundCache m_GroundCache;
     
     // Fixed timestep accumulator
     float m_TimeAccumulator = 0.0f;
+    float m_DroppedTime = 0.0f;         // Simulation time skipped by the per-frame step cap
+    glm::vec3 m_PreviousPosition{0.0f}; // Position before the last physics step
+    glm::vec3 m_RenderPosition{0.0f};
+
+    // Rollback history: state at the start of each of the last HISTORY_TICKS ticks
+    static const uint32_t HISTORY_TICKS = 64;
+    PlayerSimState m_History[HISTORY_TICKS];
+    uint32_t m_Tick = 0;
+    bool m_Replaying = false;
 };
@@ -0,0 +1,121 @@
+#pragma once
+
+#include "collision_world.h"
+#include "physics_types.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+
+enum class ProjectileKind : uint8_t {
+    HE_GRENADE,
+    FLASHBANG,
+    SMOKE,
+    MOLOTOV,
+    COUNT
+};
+
+// Per-kind ballistics, indexed by ProjectileKind
+struct ProjectileSpec {
+    const char* name;               // Sound prefix ("he_grenade_detonate"...)
+    float radius;
+    float fuse;                     // Seconds until detonation
+    float elasticity;               // Fraction of normal speed kept on a bounce
+    float friction;                 // Fraction of tangential speed lost on a bounce
+    bool detonateOnGround;          // Molotov: breaks on the first walkable impact
+    bool detonateAtRest;            // Smoke: pops once it stops rolling
+};
+
+// Something the rest of the game should hear about (AudioSystem::onProjectileEvents,
+// the server's CombatEventBatch)
+struct ProjectileEvent {
+    enum class Type : uint8_t { Bounce, Detonate };
+
+    Type type = Type::Bounce;
+    ProjectileKind kind = ProjectileKind::HE_GRENADE;
+    uint8_t material = 0;           // Surface hit, CollisionWorld material id (Bounce)
+    uint32_t owner = 0;
+    glm::vec3 position{0.0f};
+    float speed = 0.0f;             // Impact speed into the surface (Bounce)
+};
+
+// Thrown grenades as a fixed-capacity struct-of-arrays pool, stepped at
+// Physics::TICK_RATE. A tick integrates every live projectile together
+// (SSE2 when available), sweeps them all against the level BVH in packets
+// of neighbours (CollisionWorld::sweepSpherePacket) and moves the ones that
+// hit nothing four at a time. The rest bounce or roll in rounds, each
+// round's sweeps again one batch, up to MAX_BOUNCES_PER_TICK contacts, so a
+// tick's events come round by round. Expired ones are removed by swapping
+// the last into the hole. Nothing allocates after construction; spawns
+// beyond CAPACITY fail.
+class ProjectileSystem {
+public:
+    static const uint32_t CAPACITY = 512;
+    static const uint32_t MAX_EVENTS = 256;        // Per update(); extra events are dropped
+    static const int MAX_BOUNCES_PER_TICK = 3;
+
+    static const ProjectileSpec& getSpec(ProjectileKind kind);
+
+    void setCollisionWorld(const CollisionWorld* world) { m_World = world; }
+
+    bool spawn(ProjectileKind kind, const glm::vec3& position, const glm::vec3& velocity, uint32_t owner = 0);
+    void clear();
+
+    // Runs whole fixed ticks for the frame time; events restart every call
+    void update(float deltaTime);
+    void step(float deltaTime);                     // One tick, adds to this update's events
+    // The same tick with scalar integration and one sweep per projectile:
+    // the reference step() is checked against (trueshot_bench)
+    void stepReference(float deltaTime);
+    void clearEvents() { m_EventCount = 0; }        // For callers driving step() directly
+
+    uint32_t size() const { return m_Count; }
+    glm::vec3 getPosition(uint32_t i) const { return glm::vec3(m_PosX[i], m_PosY[i], m_PosZ[i]); }
+    glm::vec3 getVelocity(uint32_t i) const { return glm::vec3(m_VelX[i], m_VelY[i], m_VelZ[i]); }
+    ProjectileKind getKind(uint32_t i) const { return m_Kind[i]; }
+
+    const ProjectileEvent* getEvents() const { return m_Events; }
+    uint32_t getEventCount() const { return m_EventCount; }
+    uint32_t getDroppedEvents() const { return m_DroppedEvents; }
+
+private:
+    void integrate(float deltaTime);
+    void sortByCell();
+    void sweepBatch(uint32_t count);                // m_Order[0, count) along their m_Delta
+    void advance();
+    void sweep(uint32_t i, float deltaTime);        // stepReference(): sweeps and contacts of one projectile
+    bool bounce(uint32_t i, const SweepHit& hit);
+    void settle(uint32_t i, float deltaTime);
+    void expire();
+    void remove(uint32_t i);
+    void pushEvent(ProjectileEvent::Type type, uint32_t i, const glm::vec3& position, uint8_t material, float speed);
+
+    const CollisionWorld* m_World = nullptr;    // Flat floor at y = 0 when null
+    float m_TimeAccumulator = 0.0f;
+
+    // Live projectiles occupy [0, m_Count)
+    uint32_t m_Count = 0;
+    alignas(16) float m_PosX[CAPACITY], m_PosY[CAPACITY], m_PosZ[CAPACITY];
+    alignas(16) float m_VelX[CAPACITY], m_VelY[CAPACITY], m_VelZ[CAPACITY];
+    alignas(16) float m_Fuse[CAPACITY];
+    // Within a step: the move still to sweep, the part of the tick left
+    // for it and its last sweep. m_Free is 1 where the first sweep hit
+    // nothing, so advance() takes the whole move; the others go through
+    // bounce() and finish in settle().
+    alignas(16) float m_DeltaX[CAPACITY], m_DeltaY[CAPACITY], m_DeltaZ[CAPACITY];
+    alignas(16) float m_Free[CAPACITY];
+    float m_Remaining[CAPACITY];
+    bool m_Grounded[CAPACITY];
+    SweepHit m_Hits[CAPACITY];
+    // Indices still moving, in cell order so each sweep packet holds neighbours
+    static const uint32_t CELL_KEYS = 256;
+    uint16_t m_Cell[CAPACITY];
+    uint16_t m_Order[CAPACITY];
+    ProjectileKind m_Kind[CAPACITY];
+    uint32_t m_Owner[CAPACITY];
+    bool m_Detonate[CAPACITY];
+    bool m_AtRest[CAPACITY];
+
+    ProjectileEvent m_Events[MAX_EVENTS];
+    uint32_t m_EventCount = 0;
+    uint32_t m_DroppedEvents = 0;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstdint>
+#include <cmath>
+
+// Small deterministic generator (PCG32, XSH-RR output) for gameplay
+// randomness that client and server must agree on: the same seed gives the
+// same sequence on every machine. 16 bytes of state, a multiply and a
+// rotate per draw; cheap enough to build one per shot.
+class RandomStream {
+public:
+    explicit RandomStream(uint64_t seed = 0, uint64_t stream = 0) { reset(seed, stream); }
+
+    // Distinct `stream` values give independent sequences for one seed
+    void reset(uint64_t seed, uint64_t stream = 0) {
+        m_State = 0;
+        m_Increment = (stream << 1) | 1u;
+        nextU32();
+        m_State += mix(seed);
+        nextU32();
+    }
+
+    uint32_t nextU32() {
+        uint64_t old = m_State;
+        m_State = old * 6364136223846793005ull + m_Increment;
+        uint32_t xorShifted = static_cast<uint32_t>(((old >> 18) ^ old) >> 27);
+        uint32_t rotation = static_cast<uint32_t>(old >> 59);
+        return (xorShifted >> rotation) | (xorShifted << ((32 - rotation) & 31));
+    }
+
+    // [0, 1), 24 bits so every value is exact in a float
+    float nextFloat() { return static_cast<float>(nextU32() >> 8) * (1.0f / 16777216.0f); }
+    float range(float low, float high) { return low + (high - low) * nextFloat(); }
+
+    // Gaussian with mean 0 (Box-Muller, one value per two draws)
+    float normal(float stddev) {
+        float u = 1.0f - nextFloat();               // (0, 1], log() stays finite
+        float v = nextFloat();
+        return stddev * std::sqrt(-2.0f * std::log(u)) * std::cos(6.28318530718f * v);
+    }
+
+    // splitmix64 finalizer: spreads nearby seeds (player ids, shot numbers)
+    // over the whole state space
+    static uint64_t mix(uint64_t value) {
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+
+private:
+    uint64_t m_State = 0;
+    uint64_t m_Increment = 1;
+};
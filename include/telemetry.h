@@ -0,0 +1,158 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+
+// Structured, non-blocking logging for the simulation.
+//
+// A log call writes a fixed-size binary record (format literal + raw
+// arguments) into a ring owned by the calling thread and returns: no lock,
+// no allocation, no syscall. A background drain thread formats records
+// ("{}" placeholders) and writes them out in batches. When a ring is full
+// the record is dropped and counted rather than blocking the caller.
+//
+// Levels below TRUESHOT_LOG_LEVEL compile to nothing.
+
+#define TRUESHOT_LOG_DEBUG 0
+#define TRUESHOT_LOG_INFO  1
+#define TRUESHOT_LOG_WARN  2
+#define TRUESHOT_LOG_ERROR 3
+
+#ifndef TRUESHOT_LOG_LEVEL
+#ifdef NDEBUG
+#define TRUESHOT_LOG_LEVEL TRUESHOT_LOG_INFO
+#else
+#define TRUESHOT_LOG_LEVEL TRUESHOT_LOG_DEBUG
+#endif
+#endif
+
+namespace Telemetry {
+
+enum class Level : uint8_t {
+    Debug = TRUESHOT_LOG_DEBUG,
+    Info = TRUESHOT_LOG_INFO,
+    Warn = TRUESHOT_LOG_WARN,
+    Error = TRUESHOT_LOG_ERROR
+};
+
+const uint32_t MAX_ARGS = 8;
+const uint32_t TEXT_BYTES = 64;             // Inline storage for string arguments
+const uint32_t RING_CAPACITY = 512;         // Records per thread, power of two
+const uint32_t MAX_THREADS = 8;             // Live threads beyond this drop their records
+
+struct Arg {
+    enum class Type : uint8_t { Int, Uint, Float, Text };
+    Type type;
+    union {
+        int64_t i;
+        uint64_t u;
+        double f;
+        uint32_t text;                      // Offset into Record::text
+    };
+};
+
+struct Record {
+    uint64_t timestampNs;
+    const char* format;                     // Must be a string literal
+    Level level;
+    uint8_t argCount;
+    uint16_t textUsed;
+    Arg args[MAX_ARGS];
+    char text[TEXT_BYTES];
+};
+
+// Background drain thread; records logged before start() wait in the rings
+void start();
+void stop();        // Drains everything, then joins
+void flush();       // Drains on the calling thread (shutdown, tests)
+
+// Slot in the calling thread's ring, or nullptr if full
+Record* beginRecord(Level level, const char* format);
+void commitRecord();
+
+namespace Detail {
+    inline void pushText(Record& record, const char* value, size_t length) {
+        Arg& arg = record.args[record.argCount++];
+        arg.type = Arg::Type::Text;
+        if (record.textUsed >= TEXT_BYTES) {
+            // Out of room: point at the previous terminator, renders empty
+            arg.text = TEXT_BYTES - 1;
+            return;
+        }
+        arg.text = record.textUsed;
+        size_t room = TEXT_BYTES - record.textUsed - 1;
+        if (length > room) length = room;
+        std::memcpy(record.text + record.textUsed, value, length);
+        record.textUsed = static_cast<uint16_t>(record.textUsed + length);
+        record.text[record.textUsed++] = '\0';
+    }
+
+    inline void push(Record& record, const char* value) {
+        if (!value) value = "(null)";
+        pushText(record, value, std::strlen(value));
+    }
+
+    inline void push(Record& record, const std::string& value) {
+        pushText(record, value.data(), value.size());
+    }
+
+    template <typename T>
+    inline typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type
+    push(Record& record, T value) {
+        Arg& arg = record.args[record.argCount++];
+        if constexpr (std::is_enum<T>::value) {
+            arg.type = Arg::Type::Int;
+            arg.i = static_cast<int64_t>(value);
+        } else if constexpr (std::is_floating_point<T>::value) {
+            arg.type = Arg::Type::Float;
+            arg.f = static_cast<double>(value);
+        } else if constexpr (std::is_signed<T>::value) {
+            arg.type = Arg::Type::Int;
+            arg.i = static_cast<int64_t>(value);
+        } else {
+            arg.type = Arg::Type::Uint;
+            arg.u = static_cast<uint64_t>(value);
+        }
+    }
+
+    inline void pushAll(Record&) {}
+
+    template <typename T, typename... Rest>
+    inline void pushAll(Record& record, const T& value, const Rest&... rest) {
+        push(record, value);
+        pushAll(record, rest...);
+    }
+}
+
+template <typename... Args>
+inline void log(Level level, const char* format, const Args&... args) {
+    static_assert(sizeof...(Args) <= MAX_ARGS, "Too many log arguments");
+    Record* record = beginRecord(level, format);
+    if (!record) return;
+    Detail::pushAll(*record, args...);
+    commitRecord();
+}
+
+} // namespace Telemetry
+
+#if TRUESHOT_LOG_LEVEL <= TRUESHOT_LOG_DEBUG
+#define TS_LOG_DEBUG(...) ::Telemetry::log(::Telemetry::Level::Debug, __VA_ARGS__)
+#else
+#define TS_LOG_DEBUG(...) ((void)0)
+#endif
+
+#if TRUESHOT_LOG_LEVEL <= TRUESHOT_LOG_INFO
+#define TS_LOG_INFO(...) ::Telemetry::log(::Telemetry::Level::Info, __VA_ARGS__)
+#else
+#define TS_LOG_INFO(...) ((void)0)
+#endif
+
+#if TRUESHOT_LOG_LEVEL <= TRUESHOT_LOG_WARN
+#define TS_LOG_WARN(...) ::Telemetry::log(::Telemetry::Level::Warn, __VA_ARGS__)
+#else
+#define TS_LOG_WARN(...) ((void)0)
+#endif
+
+#define TS_LOG_ERROR(...) ::Telemetry::log(::Telemetry::Level::Error, __VA_ARGS__)
@@ -0,0 +1,86 @@
+#pragma once
+
+#include "weapon_types.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Weapon definitions are authored as text (data/weapons.txt), compiled
+// offline by tools/weapon_compiler into a versioned binary blob, and mapped
+// read-only at startup; WeaponConfig records are used in place.
+//
+// Blob layout: Header, then `count` WeaponConfig records, then every
+// weapon's RecoilPoints. The hash covers everything after the header, so
+// two machines running the same balance data report the same value.
+namespace WeaponData {
+    const uint32_t MAGIC = 0x44575354;          // "TSWD"
+    const uint16_t VERSION = 1;
+    const uint32_t MAX_WEAPONS = 64;
+
+    // Where the game looks, relative to the working directory
+    const char* const BLOB_PATH = "weapons.bin";
+    const char* const TEXT_PATH = "data/weapons.txt";
+
+    struct Header {
+        uint32_t magic;
+        uint16_t version;
+        uint16_t count;
+        uint32_t recordSize;                    // sizeof(WeaponConfig) when compiled
+        uint32_t size;                          // Whole blob, header included
+        uint64_t hash;                          // FNV-1a of the bytes after the header
+    };
+
+    // Text definitions to a blob. On failure `error` names the line.
+    bool compile(const std::string& source, std::vector<uint8_t>& blob, std::string& error);
+
+    // The weapons of one blob, either mapped from a compiled file or
+    // compiled in memory from the text (no tool run needed while iterating
+    // on balance). Records stay valid until close().
+    class Library {
+    public:
+        Library() = default;
+        ~Library() { close(); }
+        Library(const Library&) = delete;
+        Library& operator=(const Library&) = delete;
+
+        bool open(const std::string& blobPath);
+        bool loadText(const std::string& textPath);
+        void close();
+
+        uint32_t size() const { return m_Count; }
+        const Weapons::WeaponConfig* at(uint32_t index) const { return m_Records + index; }
+        const Weapons::WeaponConfig* find(const char* key) const;
+        uint32_t indexOf(const Weapons::WeaponConfig* config) const { return static_cast<uint32_t>(config - m_Records); }
+
+        uint64_t hash() const { return m_Hash; }
+        bool isMapped() const { return m_Mapping != nullptr; }
+        const std::string& getError() const { return m_Error; }     // Why the last open/loadText failed
+
+    private:
+        // Checks the header and every record against the blob bounds
+        bool adopt(const uint8_t* data, size_t size);
+
+        const Weapons::WeaponConfig* m_Records = nullptr;
+        uint32_t m_Count = 0;
+        uint64_t m_Hash = 0;
+        std::string m_Error;
+
+        std::vector<uint8_t> m_Compiled;        // loadText
+        void* m_Mapping = nullptr;              // open: mapped view
+        size_t m_MappingSize = 0;
+#ifdef _WIN32
+        void* m_File = nullptr;
+        void* m_MappingHandle = nullptr;
+#endif
+    };
+
+    // What every player spawns with, the same on client and server: one
+    // weapon per key with full ammo, the AK47 (slot 3) in hand. Weapons
+    // missing from `weapons` leave their slot empty.
+    const char* const DEFAULT_LOADOUT[WeaponInventory::SLOTS] = {
+        "glock", "deagle", "ak47", "m4a4", "awp", "nova"
+    };
+    const int DEFAULT_SLOT = 3;
+    void defaultLoadout(const Library& weapons, WeaponInventory& inventory);
+}
@@ -1,34 +1,38 @@
 #pragma once
 
 #include "weapon_types.h"
+#include "input_source.h"
+#include "hitscan.h"
+#include "random_stream.h"
+#include "weapon_data.h"
 
-#include <GLFW/glfw3.h>
-#include <memory>
-#include <unordered_map>
 
 class FPSCamera;
 class PlayerController;
 class AudioSystem;
+class CollisionWorld;
 
 class WeaponSystem {
 public:
-    WeaponSystem(FPSCamera* camera, PlayerController* player);
+    // `weapons` is the process's one weapon library; it must outlive this
+    WeaponSystem(FPSCamera* camera, PlayerController* player, const WeaponData::Library& weapons);
     ~WeaponSystem();
 
     // Main update loop
     void update(float deltaTime);
     
     // Input processing
-    void processInput(GLFWwindow* window, float deltaTime);
+    void processInput(const InputSource& input, float deltaTime);
     
-    // Weapon management
-    bool equipWeapon(const std::string& weaponName);
-    void switchToWeapon(int slot);
-    void dropWeapon();
+    // Weapon management. Slots are 1-based, like the keys.
+    bool giveWeapon(int slot, const std::string& weaponName);   // Full ammo; drawn if it is the slot in hand
+    bool equipWeapon(const std::string& weaponName);            // Into the slot in hand
+    void switchToWeapon(int slot);                              // Ammo stays with the slot it came from
+    void dropWeapon();                                          // Empties the slot in hand
     
     // Shooting mechanics
     bool canFire() const;
-    void fire();
+    void fire();                                // At the current time and eye position
     HitResult performRaycast(const glm::vec3& origin, const glm::vec3& direction) const;
     float calculateDamage(const HitResult& hit) const;
     
@@ -42,12 +46,25 @@ public:
     
     // Getters
     const Weapons::WeaponConfig* getCurrentWeapon() const;
+    const WeaponData::Library& getWeaponLibrary() const { return m_Weapons; }
     const WeaponState& getWeaponState() const { return m_WeaponState; }
+    const WeaponInventory& getInventory() const { return m_Inventory; }
     glm::vec2 getCurrentSpread() const;
     glm::vec2 getCurrentRecoil() const { return m_WeaponState.currentRecoil; }
 
     // Audio integration
     void setAudioSystem(AudioSystem* audioSystem) { m_AudioSystem = audioSystem; }
+
+    // What shots can hit; both are borrowed and may change between frames
+    void setCollisionWorld(const CollisionWorld* world) { m_World = world; }
+    void setHitboxes(const Hitscan::HitboxSet* hitboxes) { m_Hitboxes = hitboxes; }
+
+    // Spread, recoil and view punch of shot n draw from RandomStream(seed, n)
+    // in a fixed order, so a client given the server's seed for this player
+    // predicts exactly where its bullets go. `shotSequence` is the next shot
+    // number, the server's count when rejoining a match.
+    void setRandomSeed(uint64_t seed, uint32_t shotSequence = 0) { m_RandomSeed = seed; m_ShotSequence = shotSequence; }
+    uint32_t getShotSequence() const { return m_ShotSequence; }
     
     // Debug info
     void printDebugInfo() const;
@@ -61,14 +78,15 @@ private:
     void applyViewPunch();
     
     // Recoil system
-    void addRecoil();
+    void addRecoil(RandomStream& random);
     void resetRecoil();
     glm::vec2 getRecoilPatternPoint(int shotIndex) const;
     void applyRecoilToCamera();
     
     // Accuracy system
     float calculateCurrentSpread() const;
-    glm::vec3 applySpreadToDirection(const glm::vec3& baseDirection) const;
+    glm::vec3 applySpreadToDirection(const glm::vec3& baseDirection, RandomStream& random) const;
+    glm::vec3 applySpreadToDirection(const glm::vec3& baseDirection, float spreadAngle, RandomStream& random) const;
     
     // Animation system
     void updateWeaponSway(float deltaTime);
@@ -82,23 +100,44 @@ private:
     // Input helpers
     void updateInputTiming(float deltaTime);
 
+    // Inventory: the weapon in hand's ammo lives in m_WeaponState and is
+    // written back to its slot when it is put away
+    void stowActive();
+    void drawActive();
+
+    // Shots at their exact time within the frame, from where the eye was then
+    bool canFireAt(float shotTime) const;
+    void fireAt(float shotTime, const glm::vec3& eyePos);
+
+    // One HitResult per pellet, traced together; returns the pellet count
+    static constexpr int MAX_PELLETS = 16;
+    int performPelletRaycast(const glm::vec3& origin, const glm::vec3& direction, RandomStream& random,
+                             HitResult* hits) const;
+
 private:
     // External references
     FPSCamera* m_Camera;
     PlayerController* m_Player;
     // Optional audio system for sound effects
     AudioSystem* m_AudioSystem = nullptr;
+    const CollisionWorld* m_World = nullptr;
+    const Hitscan::HitboxSet* m_Hitboxes = nullptr;
     
-    // Current weapon
-    std::unique_ptr<Weapons::WeaponConfig> m_CurrentWeapon;
+    // Current weapon, a record of m_Weapons, in m_Inventory's active slot
+    const Weapons::WeaponConfig* m_CurrentWeapon = nullptr;
+    WeaponInventory m_Inventory;
     WeaponState m_WeaponState;
     ShootingInput m_Input;
     
-    // Weapon database
-    std::unordered_map<std::string, std::unique_ptr<Weapons::WeaponConfig>> m_WeaponConfigs;
+    // Weapon database, shared
+    const WeaponData::Library& m_Weapons;
     
     // Timing
     float m_GameTime = 0.0f;
+
+    // Shot randomness, see setRandomSeed()
+    uint64_t m_RandomSeed = 0;
+    uint32_t m_ShotSequence = 0;
     
     // Sway & bob
     glm::vec3 m_BaseWeaponPosition{0.5f, -0.3f, 0.8f}; // Relative to camera
@@ -114,19 +153,3 @@ private:
     mutable int m_ShotsFiredThisSecond = 0;
     mutable float m_AverageSpread = 0.0f;
 };
-
-// Weapon factory for creating predefined weapons
-class WeaponFactory {
-public:
-    static std::unique_ptr<Weapons::WeaponConfig> createAK47();
-    static std::unique_ptr<Weapons::WeaponConfig> createM4A4();
-    static std::unique_ptr<Weapons::WeaponConfig> createAWP();
-    static std::unique_ptr<Weapons::WeaponConfig> createGlock();
-    static std::unique_ptr<Weapons::WeaponConfig> createDeagle();
-    
-private:
-    // Recoil pattern generators
-    static std::vector<Weapons::RecoilPoint> generateAK47Pattern();
-    static std::vector<Weapons::RecoilPoint> generateM4A4Pattern();
-    static std::vector<Weapons::RecoilPoint> generateControlledPattern(float verticalStrength, float horizontalVariation, int patternLength);
-};
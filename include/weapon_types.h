@@ -1,6 +1,7 @@
 #pragma once
 
 #include <glm/glm.hpp>
+#include <cstdint>
 #include <vector>
 #include <string>
 
@@ -58,6 +59,16 @@ namespace Weapons {
         float movingSpread = 0.3f;          // Additional spread when moving
         float jumpingSpread = 1.0f;         // Additional spread when airborne
         float crouchingSpread = -0.05f;     // Spread reduction when crouching
+
+        // Pellets (shotguns): rays per shot, scattered over pelletSpread
+        // degrees around the shot direction
+        int pelletCount = 1;
+        float pelletSpread = 0.0f;
+
+        // Penetration: meters of wood-density material a bullet can cross.
+        // Each wall spends thickness x density (Hitscan::getMaterialDensity)
+        // and damage scales with what is left. 0 stops at the first wall.
+        float penetration = 0.0f;
         
         // Recoil
         float recoilMagnitude = 1.0f;       // Overall recoil strength
@@ -84,22 +95,25 @@ namespace Weapons {
         float adsFOVMultiplier = 0.6f;      // FOV zoom when ADS
     };
 
-    // Weapon configuration
+    // One weapon as stored in the weapon blob (see weapon_data.h): plain
+    // data, read in place from the mapped file. Only ever handled by
+    // pointer: the recoil pattern sits at an offset from the record itself,
+    // so a copy would lose it.
     struct WeaponConfig {
-        std::string name;
-        WeaponType type;
+        char key[16] = {};              // Lookup name ("ak47")
+        char name[24] = {};             // Display name, also the sound prefix
+        WeaponType type = WeaponType::RIFLE;
         WeaponStats stats;
-        std::vector<RecoilPoint> recoilPattern;
-        
-        // Audio
-        std::string fireSound;
-        std::string reloadSound;
-        std::string drawSound;
-        
-        // Visual
-        std::string viewModel;
-        std::string worldModel;
-        glm::vec3 muzzleOffset = glm::vec3(0.0f, 0.0f, 1.0f);
+        uint32_t recoilOffset = 0;      // Bytes from this record to its first RecoilPoint
+        uint32_t recoilCount = 0;
+
+        WeaponConfig() = default;
+        WeaponConfig(const WeaponConfig&) = delete;
+        WeaponConfig& operator=(const WeaponConfig&) = delete;
+
+        const RecoilPoint* recoilPattern() const {
+            return reinterpret_cast<const RecoilPoint*>(reinterpret_cast<const char*>(this) + recoilOffset);
+        }
     };
 }
 
@@ -134,6 +148,29 @@ struct WeaponState {
     float stateTimer = 0.0f;
 };
 
+// One inventory slot: which weapon, as an index into the weapon library
+// (WeaponData::Library::at), and the ammo it keeps while holstered.
+// Pointer-free and a few bytes, so a whole loadout fits a column of the
+// server's SoA entity store as well.
+struct WeaponSlot {
+    static const uint8_t EMPTY = 0xFF;
+
+    uint8_t weapon = EMPTY;
+    bool chamberedRound = false;
+    uint16_t currentAmmo = 0;
+    uint16_t reserveAmmo = 0;
+};
+
+// A player's loadout. Switching weapons moves `active`; configs are shared
+// and never copied.
+struct WeaponInventory {
+    static constexpr int SLOTS = 6;     // Keys 1-6
+
+    WeaponSlot slots[SLOTS];
+    int8_t active = -1;                 // Slot in hand, -1 for none
+};
+static_assert(sizeof(WeaponInventory) == 38, "Keep the inventory compact");
+
 // Hit result information
 struct HitResult {
     bool hit = false;
@@ -141,6 +178,7 @@ struct HitResult {
     glm::vec3 hitNormal{0.0f};
     float distance = 0.0f;
     float damage = 0.0f;
+    uint8_t material = 0;           // Level surface id (Audio::SurfaceMaterial) for world hits
     
     // Hit location for damage calculation
     enum HitLocation {
@@ -156,6 +194,10 @@ struct HitResult {
     // Target info (for multiplayer)
     int targetId = -1;
     bool isHeadshot = false;
+
+    // Wallbangs
+    uint8_t penetrations = 0;       // Walls crossed before this hit
+    float damageScale = 1.0f;       // Penetration power left, applied by calculateDamage
 };
 
 // Shooting input state
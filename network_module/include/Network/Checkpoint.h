@@ -0,0 +1,83 @@
+#pragma once
+#include "Network/NetCommon.h"
+#include "Network/Bitstream.h"
+#include "Network/EntityStore.h"
+#include "physics_types.h"
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+namespace Net {
+
+constexpr float RoundDuration = 115.0f; // seconds
+
+// Authoritative match-level state that is not per entity
+struct MatchState {
+    uint32_t roundNumber = 1;
+    float roundTimeRemaining = RoundDuration;
+    uint64_t rngState = 0;
+    uint64_t spreadSeed = 0;    // per-match root of the players' shot RNG seeds
+    Physics::MovementRuleset ruleset = Physics::MovementRuleset::COMPETITIVE_64; // chosen at match start
+};
+
+// splitmix64; cheap, checkpointable match RNG
+inline uint64_t NextRandom(uint64_t& state) {
+    uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    return z ^ (z >> 31);
+}
+
+// Seed of a player's shot spread/recoil stream, sent in Welcome: shot n
+// draws from RandomStream(seed, n) on the client (WeaponSystem) and in the
+// server's replay (ResolveShots). Fixed per id for the match, so a
+// reconnect predicts the same bullets the server keeps simulating.
+inline uint64_t PlayerSpreadSeed(const MatchState& match, PlayerId id) {
+    uint64_t state = match.spreadSeed ^ ((uint64_t)id << 32);
+    return NextRandom(state);
+}
+
+constexpr uint32_t CheckpointMagic = 0x54534350; // "TSCP"
+constexpr uint16_t CheckpointVersion = 7;
+
+// Compact binary image of the match: header, match state, then each entity
+// column written as one contiguous block.
+void SerializeCheckpoint(BitWriter& bw, Tick serverTick, PlayerId nextPlayerId,
+                         const MatchState& match, const EntityStore& store);
+bool DeserializeCheckpoint(BitReader& br, Tick& serverTick, PlayerId& nextPlayerId,
+                           MatchState& match, EntityStore& store);
+bool LoadCheckpointFile(const std::string& path, std::vector<uint8_t>& out);
+
+// Double-buffered checkpoint sink. The tick thread serializes into whichever
+// buffer the disk thread is not writing, then hands it over; the mutex is
+// only held to swap buffer indices, never across file I/O.
+class CheckpointWriter {
+public:
+    ~CheckpointWriter();
+    void Start(const std::string& path);
+    void Stop();
+
+    BitWriter& Begin();   // tick thread: buffer to serialize into
+    void Commit();        // tick thread: publish the buffer filled since Begin()
+
+    uint32_t written() const { return writtenCount.load(); }
+
+private:
+    void threadFunc();
+    bool writeFile(const std::vector<uint8_t>& data);
+
+    std::string path;
+    BitWriter buffers[2];
+    int filling = -1;
+    int pending = -1;
+    int writing = -1;
+    bool running = false;
+    std::atomic<uint32_t> writtenCount{0};
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable cv;
+};
+
+} // namespace Net
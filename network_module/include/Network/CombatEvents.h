@@ -0,0 +1,53 @@
+#pragma once
+#include "Network/NetCommon.h"
+#include "Network/Bitstream.h"
+#include <vector>
+
+namespace Net {
+
+enum class CombatEventType : uint8_t {
+    Fire = 0,
+    Hit  = 1,
+    Kill = 2,
+    // Grenades (the server's ProjectileSystem): weaponId carries the
+    // projectile kind, attacker the thrower, hitLocation the surface
+    // material (bounce), damage the impact speed (bounce)
+    ProjectileBounce = 3,
+    ProjectileDetonate = 4
+};
+
+struct CombatEvent {
+    CombatEventType type = CombatEventType::Fire;
+    uint8_t hitLocation = 0;    // HitResult::HitLocation on the client
+    uint8_t weaponId = 0;
+    PlayerId attacker = 0;
+    PlayerId victim = 0;        // 0 for Fire
+    float damage = 0.0f;
+    Vec3 pos{0, 0, 0};          // muzzle for Fire, impact point otherwise
+};
+
+// All combat events of one server tick, sent as a single reliable packet on
+// Channel::Events. On the wire player ids are interned into a per-batch
+// table and referenced by 8-bit index; positions are quantized to 1/16 unit
+// and damage to 0.1, so an event costs 12 bytes.
+class CombatEventBatch {
+public:
+    static constexpr uint32_t MaxEvents = 256;
+    static constexpr uint32_t MaxIds = 255;        // index 0xFF means "no player"
+    static constexpr float PositionScale = 16.0f;  // +-2048 units range
+    static constexpr float DamageScale = 10.0f;
+
+    CombatEventBatch() { events.reserve(MaxEvents); }
+
+    void Push(const CombatEvent& e) { if(events.size() < MaxEvents) events.push_back(e); }
+    bool Empty() const { return events.empty(); }
+    void Clear() { events.clear(); }
+
+    void Serialize(BitWriter& bw, Tick tick) const;
+    // Decodes a packet body (after the PacketType byte) into `out`, reusing its storage
+    static bool Deserialize(BitReader& br, Tick& tick, std::vector<CombatEvent>& out);
+
+    std::vector<CombatEvent> events;
+};
+
+} // namespace Net
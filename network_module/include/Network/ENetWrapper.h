@@ -13,7 +13,7 @@ struct ENetContext {
     bool createServer(uint16_t port, size_t maxClients = 32);
     bool createClient();
     void destroy();
-    ENetPeer* connect(const std::string& host, uint16_t port, uint32_t timeout=5000);
+    ENetPeer* connect(const std::string& host, uint16_t port, uint32_t timeout=5000, uint32_t data=0);
     void service(std::function<void(ENetEvent&)> handler, uint32_t timeout_ms);
 };
 
@@ -0,0 +1,114 @@
+#pragma once
+#include "Network/NetCommon.h"
+#include "Network/PlayerMovement.h"
+#include "weapon_types.h"
+#include <vector>
+#include <cstdint>
+
+namespace Net {
+
+class SpatialGrid;
+
+// Generation-checked reference to a server entity. The index addresses the
+// sparse slot table; a stale handle (entity removed and slot reused) fails
+// the generation check instead of silently aliasing the new occupant.
+struct EntityHandle {
+    static constexpr uint32_t InvalidIndex = 0xFFFFFFFFu;
+    uint32_t index = InvalidIndex;
+    uint32_t generation = 0;
+    bool valid() const { return index != InvalidIndex; }
+    bool operator==(const EntityHandle& o) const { return index == o.index && generation == o.generation; }
+    bool operator!=(const EntityHandle& o) const { return !(*this == o); }
+};
+
+// Fixed-capacity FIFO of inputs received from a client, drained each tick
+struct InputQueue {
+    static constexpr uint32_t Capacity = 16;
+    InputState items[Capacity];
+    uint32_t head = 0;
+    uint32_t count = 0;
+
+    void push(const InputState& in) {
+        if(count == Capacity) { head = (head + 1) % Capacity; count--; } // drop oldest
+        items[(head + count) % Capacity] = in;
+        count++;
+    }
+    bool pop(InputState& out) {
+        if(count == 0) return false;
+        out = items[head];
+        head = (head + 1) % Capacity;
+        count--;
+        return true;
+    }
+    void clear() { head = 0; count = 0; }
+};
+
+// Dense struct-of-arrays entity table. Live entities occupy [0, size()) in
+// every array so per-tick passes are plain linear loops; removal swaps the
+// last entity into the hole and patches its sparse slot.
+class EntityStore {
+public:
+    static constexpr uint32_t MaxEntities = 64;
+    static constexpr float MaxHealth = 100.0f;
+
+    EntityStore();
+
+    EntityHandle Create(PlayerId id);
+    void Destroy(EntityHandle h);
+    void Clear();
+
+    bool Alive(EntityHandle h) const;
+    // Dense index of a live handle, or -1 if the handle is stale
+    int32_t DenseIndex(EntityHandle h) const;
+    EntityHandle HandleAt(uint32_t dense) const;
+    EntityHandle Find(PlayerId id) const;
+
+    uint32_t size() const { return count; }
+    bool full() const { return count == MaxEntities; }
+
+    // Movement rules ApplyInputs steps players with
+    void SetRuleset(Physics::MovementRuleset ruleset) { movement.SetRuleset(ruleset); }
+
+    // Per-tick passes
+    // Drains the input queues: each input moves its player one client tick
+    // (PlayerMovement) and sets angles/fire/throw
+    void ApplyInputs();
+    // Refreshes `grid` from the positions, then pushes overlapping player
+    // capsules apart; only pairs sharing grid neighbourhoods are tested
+    void SeparatePlayers(SpatialGrid& grid);
+    void BuildSnapshot(Snapshot& out) const;
+
+    // Dense SoA columns, valid for [0, size())
+    std::vector<PlayerId> ids;
+    std::vector<float> posX, posY, posZ;
+    std::vector<float> velX, velY, velZ;
+    std::vector<float> yaw, pitch;
+    std::vector<float> health;
+    std::vector<WeaponInventory> weapons;   // the client's loadout type, slots index WeaponData::Library
+    std::vector<Tick> nextFireTick;         // weapon in hand can't fire (or is reloading) before this
+    std::vector<InputQueue> inputs;
+    std::vector<Tick> lastInputTick;        // last client tick applied, acked in snapshots
+    std::vector<uint8_t> teams;
+    std::vector<uint64_t> voiceMutes;       // bit s set: don't relay the speaker in sparse slot s
+    std::vector<uint8_t> fireRequested;     // any input of this tick had fire held
+    std::vector<uint8_t> fireOffset;        // sub-tick time of that shot, 1/256 tick
+    std::vector<uint8_t> throwRequested;    // a grenade throw was pressed this tick
+    std::vector<uint16_t> latencyTicks;     // one-way latency of the owner, for lag compensation
+    std::vector<uint32_t> reconnectTokens;  // secret the owner presents to reclaim the entity, 0 = none
+    std::vector<uint32_t> shotSequences;    // next shot number of the owner's spread stream
+
+private:
+    void resizeColumns(uint32_t n);
+    void moveDense(uint32_t from, uint32_t to);
+
+    PlayerMovement movement;                // rows of the current ApplyInputs round
+    std::vector<uint32_t> moving;           // dense index of each row
+
+    uint32_t count = 0;
+    std::vector<uint32_t> sparseToDense;    // InvalidIndex when slot is free
+    std::vector<uint32_t> denseToSparse;
+    std::vector<uint32_t> generations;
+    std::vector<uint32_t> freeSlots;
+};
+
+} // namespace Net
@@ -0,0 +1,57 @@
+#pragma once
+#include "Network/NetCommon.h"
+#include "Network/EntityStore.h"
+#include <array>
+#include <cstring>
+
+namespace Net {
+
+// Ring of past entity positions, one frame per server tick. Each frame is a
+// straight copy of the dense position columns so recording is three memcpys.
+class LagCompHistory {
+public:
+    static constexpr uint32_t Frames = 64; // one second at 64 tick
+
+    void Record(Tick tick, const EntityStore& store) {
+        Frame& f = frames[tick % Frames];
+        f.tick = tick;
+        f.count = store.size();
+        std::memcpy(f.ids.data(), store.ids.data(), f.count * sizeof(PlayerId));
+        std::memcpy(f.posX.data(), store.posX.data(), f.count * sizeof(float));
+        std::memcpy(f.posY.data(), store.posY.data(), f.count * sizeof(float));
+        std::memcpy(f.posZ.data(), store.posZ.data(), f.count * sizeof(float));
+    }
+
+    // Position of `id` as recorded at `tick`; false if that tick has been overwritten
+    bool Rewind(Tick tick, PlayerId id, Vec3& out) const {
+        const Frame& f = frames[tick % Frames];
+        if(f.tick != tick) return false;
+        for(uint32_t i = 0; i < f.count; i++) {
+            if(f.ids[i] == id) { out = {f.posX[i], f.posY[i], f.posZ[i]}; return true; }
+        }
+        return false;
+    }
+
+    // Sub-tick rewind: blends `tick` toward `tick + 1` by `fraction` (0-1).
+    // Falls back to the whole tick when the next one isn't recorded yet.
+    bool Rewind(Tick tick, float fraction, PlayerId id, Vec3& out) const {
+        if(!Rewind(tick, id, out)) return false;
+        Vec3 next;
+        if(fraction <= 0.0f || !Rewind(tick + 1, id, next)) return true;
+        out.x += (next.x - out.x) * fraction;
+        out.y += (next.y - out.y) * fraction;
+        out.z += (next.z - out.z) * fraction;
+        return true;
+    }
+
+private:
+    struct Frame {
+        Tick tick = 0xFFFFFFFFu;
+        uint32_t count = 0;
+        std::array<PlayerId, EntityStore::MaxEntities> ids;
+        std::array<float, EntityStore::MaxEntities> posX, posY, posZ;
+    };
+    std::array<Frame, Frames> frames;
+};
+
+} // namespace Net
@@ -9,6 +9,11 @@ namespace Net {
 using Tick = uint32_t;
 using PlayerId = uint32_t;
 
+constexpr float TickRate = 64.0f;
+constexpr float TickDelta = 1.0f / TickRate;
+constexpr float PlayerRadius = 0.4f; // upright capsule, feet at pos.y
+constexpr float PlayerHeight = 1.8f;
+
 struct Vec3 { float x,y,z; };
 
 struct InputState {
@@ -18,6 +23,9 @@ struct InputState {
     float right;   // -1..1
     bool jump;
     bool fire;
+    uint8_t jumpOffset; // when in the tick the press happened, in 1/256 tick
+    uint8_t fireOffset;
+    bool throwGrenade; // press edge, one grenade
     float yaw, pitch; // view angles
 };
 
@@ -29,7 +37,9 @@ struct EntityState {
 };
 
 struct Snapshot {
-    Tick tick;
+    Tick tick;          // last input tick of the receiving client applied by the server
+    Tick serverTick;
+    PlayerId localId;   // receiving client's own entity
     std::vector<EntityState> entities;
 };
 
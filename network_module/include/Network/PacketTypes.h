@@ -1,13 +1,35 @@
 #pragma once
 #include <cstdint>
+#include <cstddef>
 
 namespace Net {
 
 enum class PacketType : uint8_t {
     ClientInput = 0x01,
     Snapshot    = 0x02,
-    Event       = 0x03,
-    RPC         = 0x04
+    Event       = 0x03, // server -> client: CombatEventBatch of one tick
+    RPC         = 0x04,
+    Welcome     = 0x05, // server -> client: assigned PlayerId, server tick, shot RNG seed and next shot number, reconnect token, weapon data hash, movement ruleset
+    Voice       = 0x06, // opaque voice frame, relayed by the server to teammates
+    VoiceMute   = 0x07  // client -> server: stop/resume relaying a speaker to this client
 };
 
+// ENet channels; each has its own ordering so voice and events never
+// queue behind gameplay traffic.
+enum class Channel : uint8_t {
+    Game   = 0,     // inputs, snapshots
+    Voice  = 1,     // unreliable, sequenced voice frames
+    Events = 2      // reliable, ordered combat event batches (one per tick)
+};
+constexpr size_t ChannelCount = 3;
+
+// Voice packet: [PacketType::Voice][PlayerId speaker][uint16_t seq][payload]
+// The speaker field is stamped by the server in place before relaying.
+constexpr size_t VoiceHeaderSize = 1 + sizeof(uint32_t) + sizeof(uint16_t);
+constexpr size_t MaxVoicePayload = 256;
+// One codec frame decodes to 20 ms of mono PCM at VoiceSampleRate
+constexpr int VoiceSampleRate = 48000;
+constexpr float VoiceFrameSeconds = 0.02f;
+constexpr size_t VoiceFrameSamples = 960;
+
 }
@@ -0,0 +1,40 @@
+#pragma once
+#include "Network/NetCommon.h"
+#include "movement_batch.h"
+#include <vector>
+#include <cstdint>
+
+namespace Net {
+
+// Moves players through one client input tick (TickDelta) with the game's
+// MovementBatch kernel, so server simulation and client prediction step
+// exactly what PlayerController::updatePhysics does without a collision
+// world. Rows are filled every tick from the entity columns and read back
+// after Step(); entity positions are the feet, the kernel's are the eye,
+// PlayerHeight above.
+class PlayerMovement {
+public:
+    explicit PlayerMovement(uint32_t capacity = 1);
+
+    // The match's ruleset; one faster than TickRate runs several steps per tick
+    void SetRuleset(Physics::MovementRuleset ruleset) { batch.setRuleset(ruleset); }
+    Physics::MovementRuleset Ruleset() const { return batch.getRuleset(); }
+
+    void Clear();
+    uint32_t size() const { return (uint32_t)batch.size(); }
+
+    // Player at `pos` moving at `vel`, driven by `in`; returns its row
+    uint32_t Add(const Vec3& pos, const Vec3& vel, const InputState& in);
+    // Every row through TickDelta in the ruleset's fixed steps. A jump
+    // happens at its jumpOffset within the tick.
+    void Step();
+
+    Vec3 Position(uint32_t row) const;
+    Vec3 Velocity(uint32_t row) const;
+
+private:
+    MovementBatch batch;
+    std::vector<int32_t> jumpAt;    // jump press in 1/256 tick, -1 = none
+};
+
+} // namespace Net
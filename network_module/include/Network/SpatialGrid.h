@@ -0,0 +1,89 @@
+#pragma once
+#include <cstdint>
+#include <cmath>
+#include <vector>
+
+namespace Net {
+
+// Uniform grid over the XZ plane, hashed into a fixed bucket table so the
+// world needs no bounds. Items are dense indices (EntityStore order, bots,
+// sound sources...) linked into their cell's bucket; Update() only relinks
+// an item when it changes cell, so a tick where most players stay put costs
+// a compare per item. Queries visit cells, then filter by exact distance.
+class SpatialGrid {
+public:
+    static constexpr uint32_t None = 0xFFFFFFFFu;
+
+    explicit SpatialGrid(float cellSize = 4.0f, uint32_t bucketCount = 4096); // bucketCount: power of two
+
+    void Resize(uint32_t n);                        // unlinks items >= n
+    void Update(uint32_t index, float x, float z);  // relinks only on cell change
+    void Clear() { Resize(0); }
+
+    uint32_t size() const { return (uint32_t)itemX.size(); }
+    float CellSize() const { return cellSize; }
+    uint32_t Relinks() const { return relinks; }    // cell changes since construction
+
+    // fn(index) for every item within `radius` of (x, z)
+    template<typename Fn>
+    void Query(float x, float z, float radius, Fn&& fn) const {
+        int32_t x0 = CellOf(x - radius), x1 = CellOf(x + radius);
+        int32_t z0 = CellOf(z - radius), z1 = CellOf(z + radius);
+        float r2 = radius * radius;
+        for(int32_t cz = z0; cz <= z1; cz++) {
+            for(int32_t cx = x0; cx <= x1; cx++) {
+                for(uint32_t i = bucketHead[Bucket(cx, cz)]; i != None; i = next[i]) {
+                    if(itemCellX[i] != cx || itemCellZ[i] != cz) continue; // hash neighbour
+                    float dx = itemX[i] - x, dz = itemZ[i] - z;
+                    if(dx*dx + dz*dz <= r2) fn(i);
+                }
+            }
+        }
+    }
+
+    // fn(a, b) once for every unordered pair closer than `radius`
+    template<typename Fn>
+    void ForEachPair(float radius, Fn&& fn) const {
+        int32_t span = (int32_t)std::ceil(radius / cellSize);
+        float r2 = radius * radius;
+        const uint32_t n = size();
+        for(uint32_t a = 0; a < n; a++) {
+            const int32_t ax = itemCellX[a], az = itemCellZ[a];
+            if(ax == Unlinked) continue;
+            // Own cell plus the "forward" half of the neighbourhood; the
+            // other half sees this pair from the other side
+            for(int32_t cz = az; cz <= az + span; cz++) {
+                for(int32_t cx = (cz == az ? ax : ax - span); cx <= ax + span; cx++) {
+                    const bool ownCell = cz == az && cx == ax;
+                    for(uint32_t b = bucketHead[Bucket(cx, cz)]; b != None; b = next[b]) {
+                        if(itemCellX[b] != cx || itemCellZ[b] != cz || (ownCell && b <= a)) continue;
+                        float dx = itemX[b] - itemX[a], dz = itemZ[b] - itemZ[a];
+                        if(dx*dx + dz*dz < r2) fn(a, b);
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    static constexpr int32_t Unlinked = INT32_MIN;
+
+    int32_t CellOf(float v) const { return (int32_t)std::floor(v * invCellSize); }
+    uint32_t Bucket(int32_t cx, int32_t cz) const {
+        return ((uint32_t)cx * 73856093u ^ (uint32_t)cz * 19349663u) & bucketMask;
+    }
+    void Link(uint32_t i);
+    void Unlink(uint32_t i);
+
+    float cellSize;
+    float invCellSize;
+    uint32_t bucketMask;
+    uint32_t relinks = 0;
+    std::vector<uint32_t> bucketHead;
+    // Per item, by dense index
+    std::vector<float> itemX, itemZ;
+    std::vector<int32_t> itemCellX, itemCellZ;
+    std::vector<uint32_t> next, prev;
+};
+
+} // namespace Net
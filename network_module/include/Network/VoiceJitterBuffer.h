@@ -0,0 +1,91 @@
+#pragma once
+#include "Network/PacketTypes.h"
+#include <cstdint>
+#include <cstring>
+
+namespace Net {
+
+// Per-speaker reorder/playout buffer for opaque voice frames. Fixed storage,
+// no allocation after construction. Playout starts once `targetDepth`
+// frames are buffered; a missing frame is reported as an empty pop so the
+// decoder can run packet-loss concealment instead of stalling.
+class VoiceJitterBuffer {
+public:
+    static constexpr uint16_t Slots = 16;
+
+    explicit VoiceJitterBuffer(uint16_t targetDepth = 3): targetDepth(targetDepth) {}
+
+    void Push(uint16_t seq, const uint8_t* data, size_t len) {
+        if(len > MaxVoicePayload) return;
+        if(buffered > 0 || playedAny) {
+            int16_t ahead = (int16_t)(seq - nextSeq);
+            if(ahead < 0) {
+                if(playedAny) { lateFrames++; return; }     // already played out
+                nextSeq = seq;                              // reordered while priming
+            } else if(ahead >= (int16_t)Slots) {
+                Reset();                                    // speaker jumped far ahead, resync
+                nextSeq = seq;
+            }
+        } else {
+            nextSeq = seq;
+        }
+
+        Frame& f = frames[seq % Slots];
+        if(f.present && f.seq == seq) return;               // duplicate
+        if(!f.present) buffered++;
+        f.present = true;
+        f.seq = seq;
+        f.len = (uint16_t)len;
+        std::memcpy(f.data, data, len);
+        if(!playing && buffered >= targetDepth) playing = true;
+    }
+
+    // Called once per voice frame period by the audio side. Returns false
+    // while (re)buffering; otherwise outLen is 0 for a lost frame.
+    bool Pop(uint8_t* out, size_t& outLen) {
+        if(!playing) return false;
+        if(buffered == 0) { playing = false; underruns++; return false; }
+        Frame& f = frames[nextSeq % Slots];
+        if(f.present && f.seq == nextSeq) {
+            std::memcpy(out, f.data, f.len);
+            outLen = f.len;
+            f.present = false;
+            buffered--;
+        } else {
+            outLen = 0;
+            lostFrames++;
+        }
+        nextSeq++;
+        playedAny = true;
+        return true;
+    }
+
+    void Reset() {
+        for(auto& f : frames) f.present = false;
+        buffered = 0;
+        playing = false;
+        playedAny = false;
+    }
+
+    uint16_t depth() const { return buffered; }
+    uint32_t lost() const { return lostFrames; }
+    uint32_t late() const { return lateFrames; }
+    uint32_t underrunCount() const { return underruns; }
+
+private:
+    struct Frame {
+        bool present = false;
+        uint16_t seq = 0;
+        uint16_t len = 0;
+        uint8_t data[MaxVoicePayload];
+    };
+    Frame frames[Slots];
+    uint16_t targetDepth;
+    uint16_t nextSeq = 0;
+    uint16_t buffered = 0;
+    bool playing = false;
+    bool playedAny = false;
+    uint32_t lostFrames = 0, lateFrames = 0, underruns = 0;
+};
+
+} // namespace Net
@@ -0,0 +1,165 @@
+#include "Network/Checkpoint.h"
+#include <cstdio>
+#include <iostream>
+#ifdef _WIN32
+#define NOMINMAX
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace Net {
+
+template<typename T>
+static void writeColumn(BitWriter& bw, const std::vector<T>& col, uint32_t n) {
+    bw.write(col.data(), n * sizeof(T));
+}
+
+template<typename T>
+static bool readColumn(BitReader& br, std::vector<T>& col, uint32_t n) {
+    return br.read(col.data(), n * sizeof(T));
+}
+
+void SerializeCheckpoint(BitWriter& bw, Tick serverTick, PlayerId nextPlayerId,
+                         const MatchState& match, const EntityStore& store) {
+    uint32_t n = store.size();
+    bw.writePOD(CheckpointMagic);
+    bw.writePOD(CheckpointVersion);
+    bw.writePOD(serverTick);
+    bw.writePOD(nextPlayerId);
+    bw.writePOD(match.roundNumber);
+    bw.writePOD(match.roundTimeRemaining);
+    bw.writePOD(match.rngState);
+    bw.writePOD(match.spreadSeed);
+    bw.writePOD(match.ruleset);
+    bw.writePOD(n);
+    writeColumn(bw, store.ids, n);
+    writeColumn(bw, store.posX, n); writeColumn(bw, store.posY, n); writeColumn(bw, store.posZ, n);
+    writeColumn(bw, store.velX, n); writeColumn(bw, store.velY, n); writeColumn(bw, store.velZ, n);
+    writeColumn(bw, store.yaw, n); writeColumn(bw, store.pitch, n);
+    writeColumn(bw, store.health, n);
+    writeColumn(bw, store.weapons, n);
+    writeColumn(bw, store.nextFireTick, n);
+    writeColumn(bw, store.teams, n);
+    writeColumn(bw, store.reconnectTokens, n);
+    writeColumn(bw, store.shotSequences, n);
+}
+
+bool DeserializeCheckpoint(BitReader& br, Tick& serverTick, PlayerId& nextPlayerId,
+                           MatchState& match, EntityStore& store) {
+    uint32_t magic = 0; uint16_t version = 0; uint32_t n = 0;
+    if(!br.readPOD(magic) || magic != CheckpointMagic) return false;
+    if(!br.readPOD(version) || version != CheckpointVersion) return false;
+    if(!br.readPOD(serverTick) || !br.readPOD(nextPlayerId)) return false;
+    if(!br.readPOD(match.roundNumber) || !br.readPOD(match.roundTimeRemaining) || !br.readPOD(match.rngState)) return false;
+    Physics::MovementRuleset ruleset;
+    if(!br.readPOD(match.spreadSeed) || !br.readPOD(ruleset) || ruleset >= Physics::MovementRuleset::COUNT) return false;
+    match.ruleset = ruleset;
+    if(!br.readPOD(n) || n > EntityStore::MaxEntities) return false;
+
+    store.Clear();
+    for(uint32_t i = 0; i < n; i++) store.Create(0); // dense slots 0..n-1, filled below
+    bool ok = readColumn(br, store.ids, n)
+        && readColumn(br, store.posX, n) && readColumn(br, store.posY, n) && readColumn(br, store.posZ, n)
+        && readColumn(br, store.velX, n) && readColumn(br, store.velY, n) && readColumn(br, store.velZ, n)
+        && readColumn(br, store.yaw, n) && readColumn(br, store.pitch, n)
+        && readColumn(br, store.health, n)
+        && readColumn(br, store.weapons, n)
+        && readColumn(br, store.nextFireTick, n)
+        && readColumn(br, store.teams, n)
+        && readColumn(br, store.reconnectTokens, n)
+        && readColumn(br, store.shotSequences, n);
+    if(!ok) store.Clear();
+    return ok;
+}
+
+bool LoadCheckpointFile(const std::string& path, std::vector<uint8_t>& out) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if(!f) return false;
+    std::fseek(f, 0, SEEK_END);
+    long size = std::ftell(f);
+    std::fseek(f, 0, SEEK_SET);
+    if(size <= 0) { std::fclose(f); return false; }
+    out.resize((size_t)size);
+    size_t got = std::fread(out.data(), 1, out.size(), f);
+    std::fclose(f);
+    return got == out.size();
+}
+
+CheckpointWriter::~CheckpointWriter() { Stop(); }
+
+void CheckpointWriter::Start(const std::string& p) {
+    if(running) return;
+    path = p;
+    running = true;
+    thread = std::thread(&CheckpointWriter::threadFunc, this);
+}
+
+void CheckpointWriter::Stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(!running) return;
+        running = false;
+    }
+    cv.notify_one();
+    if(thread.joinable()) thread.join();
+}
+
+BitWriter& CheckpointWriter::Begin() {
+    std::lock_guard<std::mutex> lock(mutex);
+    filling = (writing == 0) ? 1 : 0;
+    if(pending == filling) pending = -1; // reclaim an unwritten older checkpoint
+    buffers[filling].buf.clear();        // keeps capacity, no reallocation once warm
+    return buffers[filling];
+}
+
+void CheckpointWriter::Commit() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        if(filling < 0) return;
+        pending = filling;
+        filling = -1;
+    }
+    cv.notify_one();
+}
+
+void CheckpointWriter::threadFunc() {
+    std::unique_lock<std::mutex> lock(mutex);
+    while(true) {
+        cv.wait(lock, [&]{ return pending >= 0 || !running; });
+        if(pending < 0) break; // stopped with nothing left to flush
+        writing = pending;
+        pending = -1;
+        lock.unlock();
+        if(writeFile(buffers[writing].buf)) writtenCount++;
+        lock.lock();
+        writing = -1;
+    }
+}
+
+bool CheckpointWriter::writeFile(const std::vector<uint8_t>& data) {
+    // Write-then-rename so a crash mid-write never leaves a torn checkpoint
+    std::string tmp = path + ".tmp";
+    FILE* f = std::fopen(tmp.c_str(), "wb");
+    if(!f) { std::cerr<<"Checkpoint open failed: "<<tmp<<std::endl; return false; }
+    bool ok = std::fwrite(data.data(), 1, data.size(), f) == data.size();
+    // The bytes must be on disk before the rename makes them the checkpoint
+    ok = ok && std::fflush(f) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(f)) == 0;
+#else
+    ok = ok && fsync(fileno(f)) == 0;
+#endif
+    ok = (std::fclose(f) == 0) && ok;
+    if(!ok) { std::remove(tmp.c_str()); return false; }
+#ifdef _WIN32
+    // Atomic replace; rename() refuses to overwrite an existing file here
+    return MoveFileExA(tmp.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+#endif
+}
+
+} // namespace Net
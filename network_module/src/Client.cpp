@@ -2,8 +2,18 @@
 #include "Network/ENetWrapper.h"
 #include "Network/Bitstream.h"
 #include "Network/PacketTypes.h"
+#include "Network/VoiceJitterBuffer.h"
+#include "Network/CombatEvents.h"
+#include "Network/PlayerMovement.h"
+#include "input_source.h"
+#include "weapon_data.h"
+#include "audio_system.h"
+#include "projectile_system.h"
 #include <iostream>
 #include <deque>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
 
 using namespace Net;
 
@@ -11,9 +21,36 @@ class ClientCore {
 public:
     ENetContext ctx;
     ENetPeer* serverPeer = nullptr;
+    PlayerId localId = 0;
+    uint32_t reconnectToken = 0;  // from Welcome; presented on reconnect so a restarted server hands our entity back
+    uint64_t spreadSeed = 0;      // from Welcome, see onWelcome
+    uint32_t shotSequence = 0;
+    // WeaponData::Library::hash() of the definitions this client predicts
+    // with; 0 skips the check. A Welcome with a different hash is refused.
+    uint64_t weaponHash = 0;
+    bool weaponMismatch = false;
     Tick localTick = 0;
+    bool jumpHeld = false, fireHeld = false, throwHeld = false;  // last tick's buttons, presses are the edges
     std::deque<InputState> pendingInputs;
-    EntityState predicted;
+    EntityState predicted{};
+    PlayerMovement movement;      // steps `predicted` exactly as the server steps our entity
+    std::unordered_map<PlayerId, VoiceJitterBuffer> voiceBuffers; // one per teammate speaking
+    uint16_t voiceSeq = 0;
+    // Voice playback: each speaker gets an AudioSystem streaming source,
+    // fed by PumpVoice. decodeVoice turns a frame (len 0 = lost, conceal)
+    // into up to VoiceFrameSamples of PCM and returns how many it wrote.
+    AudioSystem* audio = nullptr;
+    std::function<size_t(const uint8_t*, size_t, float*)> decodeVoice;
+    std::unordered_map<PlayerId, int> voiceSources;
+    // Called for every combat event in server order; the sample client below
+    // plays them through AudioSystem and keeps its hit markers and kill feed
+    // there too. Without a handler kills are printed.
+    std::function<void(Tick, const CombatEvent&)> onCombatEvent;
+    std::vector<CombatEvent> combatScratch;
+    // Called on every Welcome (first join and reconnects). The game hooks
+    // this to WeaponSystem::setRandomSeed(seed, shotSequence) so predicted
+    // shots use the stream the server replays.
+    std::function<void(PlayerId, uint64_t seed, uint32_t shotSequence)> onWelcome;
 
     bool Start() {
         if (enet_initialize() != 0) { std::cerr<<"ENet init failed"<<std::endl; return false; }
@@ -21,38 +58,141 @@ public:
         return true;
     }
     bool Connect(const std::string& host, uint16_t port) {
-        serverPeer = ctx.connect(host, port);
+        serverPeer = ctx.connect(host, port, 5000, reconnectToken);
         if(!serverPeer) return false;
         ctx.service([&](ENetEvent& ev){ if(ev.type==ENET_EVENT_TYPE_CONNECT) std::cout<<"Connected to server"<<std::endl; }, 500);
         return true;
     }
-    void TickOnce() {
+    // One client tick of `input`, sampled at the end of the tick. Jump and
+    // fire presses carry their sub-tick time from the source's timestamps
+    // (pressAge), so the server jumps and rewinds shots at the moment the
+    // player pressed, not at the tick edge.
+    void TickOnce(const InputSource& input, float yaw, float pitch) {
         ctx.service([&](ENetEvent& ev){ onEvent(ev); }, 1);
-        InputState in{}; in.tick = ++localTick; in.seq = (uint32_t)localTick; in.forward = 1.0f; in.right = 0.0f; in.yaw = 0; in.pitch = 0; in.jump = false; in.fire = false;
+        InputState in{}; in.tick = ++localTick; in.seq = (uint32_t)localTick;
+        in.forward = (input.isDown(InputAction::MOVE_FORWARD) ? 1.0f : 0.0f) - (input.isDown(InputAction::MOVE_BACK) ? 1.0f : 0.0f);
+        in.right = (input.isDown(InputAction::MOVE_RIGHT) ? 1.0f : 0.0f) - (input.isDown(InputAction::MOVE_LEFT) ? 1.0f : 0.0f);
+        bool jumpDown = input.isDown(InputAction::JUMP), fireDown = input.isDown(InputAction::FIRE);
+        in.jump = jumpDown && !jumpHeld;
+        if(in.jump) in.jumpOffset = TickOffset(input.pressAge(InputAction::JUMP));
+        in.fire = fireDown;
+        if(fireDown && !fireHeld) in.fireOffset = TickOffset(input.pressAge(InputAction::FIRE)); // held fire shoots at the tick start
+        bool throwDown = input.isDown(InputAction::THROW_GRENADE);
+        in.throwGrenade = throwDown && !throwHeld;
+        jumpHeld = jumpDown; fireHeld = fireDown; throwHeld = throwDown;
+        in.yaw = yaw; in.pitch = pitch;
         applyInput(predicted, in);
         pendingInputs.push_back(in);
         sendInput(in);
     }
+    // When in the tick a press `age` seconds before its end happened, in 1/256 tick
+    static uint8_t TickOffset(float age) {
+        float fraction = 1.0f - age / TickDelta;
+        return (uint8_t)std::min(255.0f, std::max(0.0f, fraction * 256.0f));
+    }
     void applyInput(EntityState &st, const InputState &in) {
-        float speed = 5.0f; float dt = 1.0f/64.0f;
-        st.pos.x += in.forward * speed * dt;
-        st.pos.z += in.right * speed * dt;
+        movement.Clear();
+        uint32_t row = movement.Add(st.pos, st.vel, in);
+        movement.Step();
+        st.pos = movement.Position(row);
+        st.vel = movement.Velocity(row);
         st.yaw = in.yaw; st.pitch = in.pitch;
     }
     void sendInput(const InputState &in) {
         if(!serverPeer) return;
         BitWriter bw; bw.writePOD((uint8_t)PacketType::ClientInput); bw.writePOD(in);
         ENetPacket* pkt = enet_packet_create(bw.buf.data(), bw.buf.size(), ENET_PACKET_FLAG_RELIABLE);
-        enet_peer_send(serverPeer, 0, pkt);
+        enet_peer_send(serverPeer, (uint8_t)Channel::Game, pkt);
+    }
+    void SendVoiceFrame(const uint8_t* data, size_t len) {
+        if(!serverPeer || len > MaxVoicePayload) return;
+        ENetPacket* pkt = enet_packet_create(nullptr, VoiceHeaderSize + len, 0);
+        uint8_t* w = pkt->data;
+        *w++ = (uint8_t)PacketType::Voice;
+        std::memset(w, 0, sizeof(PlayerId)); w += sizeof(PlayerId); // filled in by the server
+        std::memcpy(w, &voiceSeq, sizeof(uint16_t)); w += sizeof(uint16_t);
+        std::memcpy(w, data, len);
+        voiceSeq++;
+        enet_peer_send(serverPeer, (uint8_t)Channel::Voice, pkt);
+    }
+    void SetVoiceMute(PlayerId speaker, bool muted) {
+        if(!serverPeer) return;
+        BitWriter bw; bw.writePOD((uint8_t)PacketType::VoiceMute); bw.writePOD(speaker); bw.writePOD((uint8_t)(muted ? 1 : 0));
+        ENetPacket* pkt = enet_packet_create(bw.buf.data(), bw.buf.size(), ENET_PACKET_FLAG_RELIABLE);
+        enet_peer_send(serverPeer, (uint8_t)Channel::Game, pkt);
+        if(!muted) return;
+        voiceBuffers.erase(speaker);
+        auto it = voiceSources.find(speaker);
+        if(it == voiceSources.end()) return;
+        if(audio) audio->stopSound(it->second);
+        voiceSources.erase(it);
+    }
+    // Call once per VoiceFrameSeconds from the audio side, never from the
+    // simulation tick: one frame per speaker into its streaming source.
+    void PumpVoice() {
+        if(!audio || !decodeVoice) return;
+        uint8_t frame[MaxVoicePayload];
+        float pcm[VoiceFrameSamples];
+        for(auto &kv : voiceBuffers) {
+            size_t len = 0;
+            if(!kv.second.Pop(frame, len)) continue;
+            size_t samples = std::min(decodeVoice(frame, len, pcm), VoiceFrameSamples);
+            auto src = voiceSources.find(kv.first);
+            if(src != voiceSources.end() && audio->queueStreamSamples(src->second, pcm, samples)) continue;
+            // First frame from this speaker, or the source was evicted
+            int id = audio->createStreamingSource(Audio::AudioCategory::VOICE, VoiceSampleRate);
+            if(id < 0) continue;
+            voiceSources[kv.first] = id;
+            audio->queueStreamSamples(id, pcm, samples);
+        }
     }
     void onEvent(ENetEvent& ev) {
         switch(ev.type) {
             case ENET_EVENT_TYPE_RECEIVE: {
                 if(ev.packet->dataLength < 1) break;
                 uint8_t t = ev.packet->data[0];
-                if(t == (uint8_t)PacketType::Snapshot) {
+                if(t == (uint8_t)PacketType::Welcome) {
+                    BitReader br(ev.packet->data+1, ev.packet->dataLength-1);
+                    Tick serverTick; uint64_t serverWeaponHash; Physics::MovementRuleset ruleset;
+                    if(br.readPOD(localId) && br.readPOD(serverTick) && br.readPOD(spreadSeed)
+                       && br.readPOD(shotSequence) && br.readPOD(reconnectToken) && br.readPOD(serverWeaponHash)
+                       && br.readPOD(ruleset) && ruleset < Physics::MovementRuleset::COUNT) {
+                        if(weaponHash != 0 && serverWeaponHash != weaponHash) {
+                            // Different balance data would mispredict every shot; leave rather than play on it
+                            std::cerr<<"Weapon data mismatch: server "<<std::hex<<serverWeaponHash<<", client "<<weaponHash<<std::dec<<", disconnecting"<<std::endl;
+                            weaponMismatch = true;
+                            enet_peer_disconnect(serverPeer, 0);
+                            serverPeer = nullptr;
+                        } else {
+                            std::cout<<"Joined as player "<<localId<<" at server tick "<<serverTick<<", "<<Physics::rulesetName(ruleset)<<" movement"<<std::endl;
+                            movement.SetRuleset(ruleset);  // predict with the match's rules
+                            if(onWelcome) onWelcome(localId, spreadSeed, shotSequence);
+                        }
+                    }
+                }
+                else if(t == (uint8_t)PacketType::Voice) {
+                    if(ev.packet->dataLength >= VoiceHeaderSize) {
+                        PlayerId speaker; uint16_t seq;
+                        std::memcpy(&speaker, ev.packet->data + 1, sizeof(PlayerId));
+                        std::memcpy(&seq, ev.packet->data + 1 + sizeof(PlayerId), sizeof(uint16_t));
+                        voiceBuffers[speaker].Push(seq, ev.packet->data + VoiceHeaderSize, ev.packet->dataLength - VoiceHeaderSize);
+                    }
+                }
+                else if(t == (uint8_t)PacketType::Event) {
+                    BitReader br(ev.packet->data+1, ev.packet->dataLength-1);
+                    Tick tick;
+                    bool ok = CombatEventBatch::Deserialize(br, tick, combatScratch);
+                    for(size_t i = 0; ok && i < combatScratch.size(); i++) {
+                        const CombatEvent& e = combatScratch[i];
+                        if(onCombatEvent) onCombatEvent(tick, e);
+                        else if(e.type == CombatEventType::Kill)
+                            std::cout<<"Player "<<e.attacker<<" killed player "<<e.victim<<(e.hitLocation == 0 ? " (headshot)" : "")<<std::endl;
+                    }
+                }
+                else if(t == (uint8_t)PacketType::Snapshot) {
                     BitReader br(ev.packet->data+1, ev.packet->dataLength-1);
                     Snapshot s; if(!br.readPOD(s.tick)) break;
+                    if(!br.readPOD(s.serverTick) || !br.readPOD(s.localId)) break;
                     uint32_t n; if(!br.readPOD(n)) break;
                     s.entities.resize(n);
                     for(uint32_t i=0;i<n;i++) {
@@ -62,7 +202,9 @@ public:
                         br.readPOD(s.entities[i].yaw); br.readPOD(s.entities[i].pitch);
                     }
                     for(auto &e : s.entities) {
+                        if(e.id != s.localId) continue;
                         predicted.pos = e.pos;
+                        predicted.vel = e.vel;
                         std::deque<InputState> newPending;
                         for(auto &pin : pendingInputs) {
                             if(pin.tick > s.tick) {
@@ -86,9 +228,69 @@ int main(int argc, char** argv) {
     const char* host = "127.0.0.1";
     if(argc>1) host = argv[1];
     ClientCore c;
+    WeaponData::Library weapons;
+    if(weapons.open(WeaponData::BLOB_PATH) || weapons.loadText(WeaponData::TEXT_PATH)) c.weaponHash = weapons.hash();
     if(!c.Start()) return 1;
     if(!c.Connect(host, 7777)) { std::cerr<<"Connect failed"<<std::endl; return 2; }
-    for(int i=0;i<500;i++) { c.TickOnce(); enet_host_flush(c.ctx.host); enet_host_service(c.ctx.host, nullptr, 5); }
-    return 0;
+    // Teammates' voice plays through the game's AudioSystem. Stand-in codec
+    // until a real one is linked in: G.711 mu-law at 8 kHz, each sample held
+    // for the output rate; a lost frame plays as silence
+    AudioSystem audio;
+    audio.initialize();
+    c.audio = &audio;
+    c.decodeVoice = [](const uint8_t* frame, size_t len, float* pcm) {
+        const size_t hold = VoiceSampleRate / 8000;
+        if(len == 0) { std::fill(pcm, pcm + VoiceFrameSamples, 0.0f); return VoiceFrameSamples; }
+        size_t n = std::min(len, VoiceFrameSamples / hold);
+        for(size_t i=0;i<n;i++) {
+            uint8_t u = (uint8_t)~frame[i];
+            int t = (((u & 0x0F) << 3) + 0x84) << ((u & 0x70) >> 4);
+            std::fill(pcm + i*hold, pcm + (i+1)*hold, (float)((u & 0x80) ? 0x84 - t : t - 0x84) / 32768.0f);
+        }
+        return n * hold;
+    };
+    float voiceClock = 0.0f;
+    // Combat events from the server drive the game's sounds. This client has
+    // no HUD: its hit markers are UI sounds and its kill feed is stdout.
+    c.onCombatEvent = [&](Tick, const CombatEvent& e) {
+        glm::vec3 pos(e.pos.x, e.pos.y, e.pos.z);
+        switch(e.type) {
+            case CombatEventType::Fire:
+                if(e.weaponId < weapons.size()) audio.onWeaponFire(weapons.at(e.weaponId)->name, pos);
+                break;
+            case CombatEventType::Hit:
+                audio.playSoundEvent(Audio::AudioEvent::BULLET_IMPACT_FLESH, pos);
+                if(e.attacker == c.localId) audio.playSound2D(e.hitLocation == 0 ? "hitmarker_head" : "hitmarker");
+                break;
+            case CombatEventType::Kill:
+                if(e.attacker == c.localId) audio.playSoundEvent(Audio::AudioEvent::UI_NOTIFICATION);
+                std::cout<<"Player "<<e.attacker<<" killed player "<<e.victim<<(e.hitLocation == 0 ? " (headshot)" : "")<<std::endl;
+                break;
+            case CombatEventType::ProjectileBounce:
+                audio.onGrenadeBounce(pos, (Audio::SurfaceMaterial)e.hitLocation, e.damage);
+                break;
+            case CombatEventType::ProjectileDetonate:
+                if(e.weaponId < (uint8_t)ProjectileKind::COUNT)
+                    audio.onGrenadeDetonate(ProjectileSystem::getSpec((ProjectileKind)e.weaponId).name, pos);
+                break;
+        }
+    };
+    // Scripted player: runs forward, hops every second, taps fire and
+    // throws a grenade every two seconds, pressing at a different point of
+    // the tick each time
+    StateInputSource input;
+    input.set(InputAction::MOVE_FORWARD, true);
+    for(int i=0;i<500 && !c.weaponMismatch;i++) {
+        input.set(InputAction::JUMP, i % 64 == 10);
+        input.set(InputAction::FIRE, i % 32 < 2);
+        input.set(InputAction::THROW_GRENADE, i % 128 == 40);
+        input.setPressAge(InputAction::JUMP, (i % 5) * TickDelta / 5.0f);
+        input.setPressAge(InputAction::FIRE, (i % 3) * TickDelta / 3.0f);
+        c.TickOnce(input, 0.0f, 0.0f);
+        enet_host_flush(c.ctx.host); enet_host_service(c.ctx.host, nullptr, 5);
+        for(voiceClock += TickDelta; voiceClock >= VoiceFrameSeconds; voiceClock -= VoiceFrameSeconds) c.PumpVoice();
+        audio.update(TickDelta);
+    }
+    return c.weaponMismatch ? 3 : 0;
 }
 #endif
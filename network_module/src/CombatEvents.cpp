@@ -0,0 +1,77 @@
+#include "Network/CombatEvents.h"
+#include "Network/PacketTypes.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Net {
+
+static int16_t quantize(float v, float scale) {
+    float q = std::round(v * scale);
+    q = std::max(-32768.0f, std::min(32767.0f, q));
+    return (int16_t)q;
+}
+
+static uint8_t intern(PlayerId id, PlayerId* table, uint32_t& count) {
+    if(id == 0) return 0xFF;
+    for(uint32_t i = 0; i < count; i++) if(table[i] == id) return (uint8_t)i;
+    if(count == CombatEventBatch::MaxIds) return 0xFF;
+    table[count] = id;
+    return (uint8_t)count++;
+}
+
+void CombatEventBatch::Serialize(BitWriter& bw, Tick tick) const {
+    PlayerId ids[MaxIds];
+    uint32_t idCount = 0;
+    uint8_t attackerIdx[MaxEvents], victimIdx[MaxEvents];
+    uint16_t n = (uint16_t)events.size();
+    for(uint16_t i = 0; i < n; i++) {
+        attackerIdx[i] = intern(events[i].attacker, ids, idCount);
+        victimIdx[i] = intern(events[i].victim, ids, idCount);
+    }
+
+    bw.writePOD((uint8_t)PacketType::Event);
+    bw.writePOD(tick);
+    bw.writePOD((uint8_t)idCount);
+    bw.write(ids, idCount * sizeof(PlayerId));
+    bw.writePOD(n);
+    for(uint16_t i = 0; i < n; i++) {
+        const CombatEvent& e = events[i];
+        bw.writePOD((uint8_t)(((uint8_t)e.type << 4) | (e.hitLocation & 0x0F)));
+        bw.writePOD(e.weaponId);
+        bw.writePOD(attackerIdx[i]);
+        bw.writePOD(victimIdx[i]);
+        float dmg = std::max(0.0f, std::min(6553.5f, e.damage));
+        bw.writePOD((uint16_t)std::lround(dmg * DamageScale));
+        bw.writePOD(quantize(e.pos.x, PositionScale));
+        bw.writePOD(quantize(e.pos.y, PositionScale));
+        bw.writePOD(quantize(e.pos.z, PositionScale));
+    }
+}
+
+bool CombatEventBatch::Deserialize(BitReader& br, Tick& tick, std::vector<CombatEvent>& out) {
+    PlayerId ids[MaxIds];
+    uint8_t idCount = 0;
+    uint16_t n = 0;
+    if(!br.readPOD(tick) || !br.readPOD(idCount)) return false;
+    if(idCount > MaxIds || !br.read(ids, idCount * sizeof(PlayerId))) return false;
+    if(!br.readPOD(n)) return false;
+
+    out.resize(n);
+    for(uint16_t i = 0; i < n; i++) {
+        uint8_t typeLoc, attacker, victim;
+        uint16_t dmg;
+        int16_t x, y, z;
+        CombatEvent& e = out[i];
+        if(!br.readPOD(typeLoc) || !br.readPOD(e.weaponId) || !br.readPOD(attacker) || !br.readPOD(victim)) return false;
+        if(!br.readPOD(dmg) || !br.readPOD(x) || !br.readPOD(y) || !br.readPOD(z)) return false;
+        e.type = (CombatEventType)(typeLoc >> 4);
+        e.hitLocation = typeLoc & 0x0F;
+        e.attacker = attacker < idCount ? ids[attacker] : 0;
+        e.victim = victim < idCount ? ids[victim] : 0;
+        e.damage = dmg / DamageScale;
+        e.pos = {x / PositionScale, y / PositionScale, z / PositionScale};
+    }
+    return true;
+}
+
+} // namespace Net
@@ -1,4 +1,5 @@
         #include "Network/ENetWrapper.h"
+#include "Network/PacketTypes.h"
 #include <iostream>
 namespace Net {
 
@@ -8,13 +9,13 @@ bool ENetContext::createServer(uint16_t port, size_t maxClients) {
     if (host) destroy();
     enet_address_set_host(&address, "0.0.0.0");
     address.port = port;
-    host = enet_host_create(&address, (enet_uint32)maxClients, 2, 0, 0);
+    host = enet_host_create(&address, (enet_uint32)maxClients, ChannelCount, 0, 0);
     if (!host) { std::cerr<<"ENet server create failed"<<std::endl; return false; }
     return true;
 }
 bool ENetContext::createClient() {
     if (host) destroy();
-    host = enet_host_create(nullptr, 1, 2, 0, 0);
+    host = enet_host_create(nullptr, 1, ChannelCount, 0, 0);
     if (!host) { std::cerr<<"ENet client create failed"<<std::endl; return false; }
     return true;
 }
@@ -24,12 +25,12 @@ void ENetContext::destroy() {
         host = nullptr;
     }
 }
-ENetPeer* ENetContext::connect(const std::string& hostName, uint16_t port, uint32_t timeout) {
+ENetPeer* ENetContext::connect(const std::string& hostName, uint16_t port, uint32_t timeout, uint32_t data) {
     if (!host) return nullptr;
     ENetAddress addr;
     enet_address_set_host(&addr, hostName.c_str());
     addr.port = port;
-    return enet_host_connect(host, &addr, 2, 0);
+    return enet_host_connect(host, &addr, ChannelCount, data);
 }
 void ENetContext::service(std::function<void(ENetEvent&)> handler, uint32_t timeout_ms) {
     if (!host) return;
@@ -0,0 +1,205 @@
+#include "Network/EntityStore.h"
+#include "Network/SpatialGrid.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Net {
+
+EntityStore::EntityStore() : movement(MaxEntities) {
+    resizeColumns(MaxEntities);
+    sparseToDense.assign(MaxEntities, EntityHandle::InvalidIndex);
+    denseToSparse.assign(MaxEntities, EntityHandle::InvalidIndex);
+    generations.assign(MaxEntities, 0);
+    freeSlots.reserve(MaxEntities);
+    for(uint32_t i = MaxEntities; i > 0; i--) freeSlots.push_back(i - 1);
+    moving.reserve(MaxEntities);
+}
+
+void EntityStore::resizeColumns(uint32_t n) {
+    ids.resize(n);
+    posX.resize(n); posY.resize(n); posZ.resize(n);
+    velX.resize(n); velY.resize(n); velZ.resize(n);
+    yaw.resize(n); pitch.resize(n);
+    health.resize(n);
+    weapons.resize(n);
+    nextFireTick.resize(n);
+    inputs.resize(n);
+    lastInputTick.resize(n);
+    teams.resize(n);
+    voiceMutes.resize(n);
+    fireRequested.resize(n);
+    fireOffset.resize(n);
+    throwRequested.resize(n);
+    latencyTicks.resize(n);
+    reconnectTokens.resize(n);
+    shotSequences.resize(n);
+}
+
+EntityHandle EntityStore::Create(PlayerId id) {
+    if(freeSlots.empty()) return EntityHandle{};
+    uint32_t slot = freeSlots.back();
+    freeSlots.pop_back();
+
+    uint32_t d = count++;
+    sparseToDense[slot] = d;
+    denseToSparse[d] = slot;
+
+    ids[d] = id;
+    posX[d] = 0.0f; posY[d] = 0.0f; posZ[d] = 0.0f;
+    velX[d] = 0.0f; velY[d] = 0.0f; velZ[d] = 0.0f;
+    yaw[d] = 0.0f; pitch[d] = 0.0f;
+    health[d] = MaxHealth;
+    weapons[d] = WeaponInventory{};
+    nextFireTick[d] = 0;
+    inputs[d].clear();
+    lastInputTick[d] = 0;
+    teams[d] = 0;
+    voiceMutes[d] = 0;
+    fireRequested[d] = 0;
+    fireOffset[d] = 0;
+    throwRequested[d] = 0;
+    latencyTicks[d] = 0;
+    reconnectTokens[d] = 0;
+    shotSequences[d] = 0;
+
+    return EntityHandle{slot, generations[slot]};
+}
+
+void EntityStore::moveDense(uint32_t from, uint32_t to) {
+    ids[to] = ids[from];
+    posX[to] = posX[from]; posY[to] = posY[from]; posZ[to] = posZ[from];
+    velX[to] = velX[from]; velY[to] = velY[from]; velZ[to] = velZ[from];
+    yaw[to] = yaw[from]; pitch[to] = pitch[from];
+    health[to] = health[from];
+    weapons[to] = weapons[from];
+    nextFireTick[to] = nextFireTick[from];
+    inputs[to] = inputs[from];
+    lastInputTick[to] = lastInputTick[from];
+    teams[to] = teams[from];
+    voiceMutes[to] = voiceMutes[from];
+    fireRequested[to] = fireRequested[from];
+    fireOffset[to] = fireOffset[from];
+    throwRequested[to] = throwRequested[from];
+    latencyTicks[to] = latencyTicks[from];
+    reconnectTokens[to] = reconnectTokens[from];
+    shotSequences[to] = shotSequences[from];
+
+    uint32_t slot = denseToSparse[from];
+    denseToSparse[to] = slot;
+    sparseToDense[slot] = to;
+}
+
+void EntityStore::Destroy(EntityHandle h) {
+    int32_t d = DenseIndex(h);
+    if(d < 0) return;
+
+    uint32_t last = count - 1;
+    if((uint32_t)d != last) moveDense(last, (uint32_t)d);
+    denseToSparse[last] = EntityHandle::InvalidIndex;
+    count--;
+
+    sparseToDense[h.index] = EntityHandle::InvalidIndex;
+    generations[h.index]++;
+    // Nobody may keep muting whoever reuses this slot
+    for(uint32_t i = 0; i < count; i++) voiceMutes[i] &= ~(1ull << h.index);
+    freeSlots.push_back(h.index);
+}
+
+void EntityStore::Clear() {
+    while(count > 0) Destroy(HandleAt(count - 1));
+}
+
+bool EntityStore::Alive(EntityHandle h) const {
+    return DenseIndex(h) >= 0;
+}
+
+int32_t EntityStore::DenseIndex(EntityHandle h) const {
+    if(h.index >= MaxEntities) return -1;
+    if(generations[h.index] != h.generation) return -1;
+    uint32_t d = sparseToDense[h.index];
+    if(d == EntityHandle::InvalidIndex) return -1;
+    return (int32_t)d;
+}
+
+EntityHandle EntityStore::HandleAt(uint32_t dense) const {
+    if(dense >= count) return EntityHandle{};
+    uint32_t slot = denseToSparse[dense];
+    return EntityHandle{slot, generations[slot]};
+}
+
+EntityHandle EntityStore::Find(PlayerId id) const {
+    for(uint32_t i = 0; i < count; i++) {
+        if(ids[i] == id) return HandleAt(i);
+    }
+    return EntityHandle{};
+}
+
+void EntityStore::ApplyInputs() {
+    // Every queued input is one client tick, stepped like the client
+    // predicted it. Each round takes one input per player, so a player whose
+    // inputs bunched up catches up within this tick, and one whose inputs are
+    // late stands still until they arrive.
+    for(uint32_t i = 0; i < count; i++) { fireRequested[i] = 0; fireOffset[i] = 0; throwRequested[i] = 0; }
+    for(;;) {
+        movement.Clear();
+        moving.clear();
+        InputState in;
+        for(uint32_t i = 0; i < count; i++) {
+            if(!inputs[i].pop(in)) continue;
+            if(in.fire && !fireRequested[i]) { fireRequested[i] = 1; fireOffset[i] = in.fireOffset; } // first shot of the tick
+            if(in.throwGrenade) throwRequested[i] = 1;
+            yaw[i] = in.yaw;
+            pitch[i] = in.pitch;
+            lastInputTick[i] = in.tick;
+            movement.Add({posX[i], posY[i], posZ[i]}, {velX[i], velY[i], velZ[i]}, in);
+            moving.push_back(i);
+        }
+        if(moving.empty()) break;
+        movement.Step();
+        for(uint32_t r = 0; r < (uint32_t)moving.size(); r++) {
+            uint32_t i = moving[r];
+            Vec3 p = movement.Position(r), v = movement.Velocity(r);
+            posX[i] = p.x; posY[i] = p.y; posZ[i] = p.z;
+            velX[i] = v.x; velY[i] = v.y; velZ[i] = v.z;
+        }
+    }
+}
+
+void EntityStore::SeparatePlayers(SpatialGrid& grid) {
+    grid.Resize(count);
+    for(uint32_t i = 0; i < count; i++) grid.Update(i, posX[i], posZ[i]);
+
+    // Capsules are vertical: the closest points of their axes are separated
+    // horizontally by the XZ distance and vertically by the gap between the
+    // segments (zero when they overlap in height). Overlaps are resolved in
+    // XZ only, half each, so nobody is lifted onto a head.
+    const float minDist = 2.0f * PlayerRadius;
+    const float segment = PlayerHeight - 2.0f * PlayerRadius;
+    grid.ForEachPair(minDist, [&](uint32_t a, uint32_t b) {
+        float dx = posX[b] - posX[a], dz = posZ[b] - posZ[a];
+        float dy = std::max(0.0f, std::fabs(posY[b] - posY[a]) - segment);
+        float horizontal = std::sqrt(dx*dx + dz*dz);
+        float dist = std::sqrt(horizontal*horizontal + dy*dy);
+        if(dist >= minDist) return;
+        if(horizontal < 1e-4f) { dx = 1.0f; dz = 0.0f; horizontal = 1.0f; } // stacked exactly: any fixed axis
+        float push = 0.5f * (minDist - dist) / horizontal;
+        posX[a] -= dx * push; posZ[a] -= dz * push;
+        posX[b] += dx * push; posZ[b] += dz * push;
+    });
+
+    for(uint32_t i = 0; i < count; i++) grid.Update(i, posX[i], posZ[i]);
+}
+
+void EntityStore::BuildSnapshot(Snapshot& out) const {
+    out.entities.resize(count);
+    for(uint32_t i = 0; i < count; i++) {
+        EntityState& e = out.entities[i];
+        e.id = ids[i];
+        e.pos = {posX[i], posY[i], posZ[i]};
+        e.vel = {velX[i], velY[i], velZ[i]};
+        e.yaw = yaw[i];
+        e.pitch = pitch[i];
+    }
+}
+
+} // namespace Net
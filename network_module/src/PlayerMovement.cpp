@@ -0,0 +1,49 @@
+#include "Network/PlayerMovement.h"
+#include "physics_types.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Net {
+
+PlayerMovement::PlayerMovement(uint32_t capacity) : batch(capacity) {
+    jumpAt.reserve(capacity);
+}
+
+void PlayerMovement::Clear() {
+    batch.clear();
+    jumpAt.clear();
+}
+
+uint32_t PlayerMovement::Add(const Vec3& pos, const Vec3& vel, const InputState& in) {
+    uint32_t r = (uint32_t)batch.add(glm::vec3(pos.x, pos.y + PlayerHeight, pos.z));
+    batch.velX[r] = vel.x; batch.velY[r] = vel.y; batch.velZ[r] = vel.z;
+    // Only decides whether a landing resets airTime, which nothing here reads
+    batch.onGround[r] = pos.y <= Physics::GROUND_TOLERANCE ? 1 : 0;
+    batch.setInput(r, in.yaw, glm::vec2(in.right, in.forward), false);
+    jumpAt.push_back(in.jump ? (int32_t)in.jumpOffset : -1);
+    return r;
+}
+
+void PlayerMovement::Step() {
+    // Each jump goes to the step its offset falls in
+    const float stepTime = batch.getFixedTimestep();
+    const int32_t steps = std::max(1, (int32_t)std::lround(TickDelta / stepTime));
+    for(int32_t s = 0; s < steps; s++) {
+        for(uint32_t r = 0; r < size(); r++) {
+            if(jumpAt[r] < 0 || jumpAt[r] * steps / 256 != s) continue;
+            batch.wishJump[r] = 1;
+            batch.jumpOffset[r] = (float)(jumpAt[r] * steps - s * 256) / 256.0f;
+        }
+        batch.step(TickDelta / (float)steps);
+    }
+}
+
+Vec3 PlayerMovement::Position(uint32_t row) const {
+    return {batch.posX[row], batch.posY[row] - PlayerHeight, batch.posZ[row]};
+}
+
+Vec3 PlayerMovement::Velocity(uint32_t row) const {
+    return {batch.velX[row], batch.velY[row], batch.velZ[row]};
+}
+
+} // namespace Net
@@ -2,88 +2,520 @@
 #include "Network/ENetWrapper.h"
 #include "Network/Bitstream.h"
 #include "Network/PacketTypes.h"
-#include <unordered_map>
+#include "Network/EntityStore.h"
+#include "Network/LagCompensation.h"
+#include "Network/Checkpoint.h"
+#include "Network/CombatEvents.h"
+#include "Network/SpatialGrid.h"
+#include "arena.h"
+#include "collision_world.h"
+#include "hitscan.h"
+#include "physics_types.h"
+#include "projectile_system.h"
+#include "random_stream.h"
+#include "weapon_data.h"
 #include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <cmath>
+#include <random>
 
 using namespace Net;
 
+// One weapon of the definitions the clients load (WeaponData::Library),
+// with its timings in ticks. WeaponSlot::weapon is the blob index.
+struct ServerWeapon {
+    const Weapons::WeaponConfig* config;
+    Tick fireInterval, reloadTicks;
+};
+
+constexpr float EyeHeight = 1.7f;
+constexpr Tick NoRewind = 0xFFFFFFFFu;
+
 class ServerCore {
 public:
     ENetContext ctx;
     uint16_t port = 7777;
     Tick serverTick = 0;
-    std::unordered_map<ENetPeer*, PlayerId> peersToId;
+    EntityStore entities;
+    LagCompHistory lagComp;
+    SpatialGrid playerGrid;                // player broadphase, refreshed every tick
+    std::vector<EntityHandle> peerHandles; // indexed by ENetPeer::incomingPeerID
     PlayerId nextPlayerId = 1;
+    float voiceRange = 0.0f;               // 0 = team-wide radio, otherwise proximity radius
+    // Furthest back a shot is rewound. Players lagging more than this are hit
+    // tested at this age (they must lead their targets), never against the
+    // present; it can't exceed what lagComp still holds.
+    uint16_t maxUnlagTicks = LagCompHistory::Frames - 1;
+    Snapshot snapshot;                     // rebuilt in place every tick
+    BitWriter snapshotBody;
+    CombatEventBatch combatEvents;         // gathered during the tick, flushed once at its end
+    CollisionWorld level;                  // the game's arena; only grenades collide with it
+    ProjectileSystem projectiles;          // thrown grenades, not checkpointed
+    BitWriter eventBody;
+    MatchState match;
+    std::string weaponBlobPath = WeaponData::BLOB_PATH;
+    WeaponData::Library weaponData;
+    std::vector<ServerWeapon> weapons;     // indexed like weaponData
+    // Everyone's hitboxes (the client's capsules) posed at one rewind time,
+    // target ids are dense indices. Shooters with the same latency and
+    // sub-tick offset share the build; cleared every tick.
+    Hitscan::HitboxSet rewoundHitboxes;
+    std::vector<Hitscan::Target> rewoundTargets;
+    Tick rewoundTick = NoRewind;
+    uint8_t rewoundOffset = 0;
+
+    // Crash recovery
+    std::string checkpointPath = "trueshot_match.ckpt";
+    Tick checkpointInterval = 32;          // ticks, i.e. twice per second
+    Tick reconnectGrace = 30 * 64;         // ticks a restored player may take to come back
+    CheckpointWriter checkpoints;
+    struct PendingReconnect { EntityHandle handle; Tick deadline; };
+    std::vector<PendingReconnect> pendingReconnects;
+    std::random_device tokenSource;        // reconnect tokens, independent of the match RNG
 
-    bool Start() {
+    bool Start(bool resume = true) {
+        if (!LoadWeapons()) return false;
         if (enet_initialize() != 0) { std::cerr<<"ENet init failed"<<std::endl; return false; }
         if (!ctx.createServer(port)) return false;
-        std::cout<<"Server started on port "<<port<<std::endl;
+        peerHandles.assign(ctx.host->peerCount, EntityHandle{});
+        snapshot.entities.reserve(EntityStore::MaxEntities);
+        snapshotBody.buf.reserve(EntityStore::MaxEntities * sizeof(EntityState));
+        eventBody.buf.reserve(64 + CombatEventBatch::MaxEvents * 12);
+        buildArena(level);
+        projectiles.setCollisionWorld(&level);
+        match.rngState = ((uint64_t)std::random_device{}() << 32) ^ std::random_device{}();
+        match.spreadSeed = NextRandom(match.rngState);
+        if(resume) ResumeFromCheckpoint();   // a resumed match keeps its own ruleset
+        entities.SetRuleset(match.ruleset);
+        checkpoints.Start(checkpointPath);
+        std::cout<<"Server started on port "<<port<<", "<<Physics::rulesetName(match.ruleset)<<" movement"<<std::endl;
+        return true;
+    }
+    bool LoadWeapons() {
+        // The clients' blob, else the text it is compiled from
+        if(!weaponData.open(weaponBlobPath) && !weaponData.loadText(WeaponData::TEXT_PATH)) {
+            std::cerr<<"No weapon definitions: "<<weaponData.getError()<<std::endl;
+            return false;
+        }
+        weapons.clear();
+        for(uint32_t i = 0; i < weaponData.size(); i++) {
+            const Weapons::WeaponConfig* config = weaponData.at(i);
+            Tick fireInterval = (Tick)std::max(1.0f, std::round(60.0f / config->stats.fireRate * TickRate));
+            Tick reloadTicks = (Tick)std::round(config->stats.reloadTime * TickRate);
+            weapons.push_back({config, fireInterval, reloadTicks});
+        }
+        std::cout<<"Loaded "<<weapons.size()<<" weapons"<<std::endl;
+        return true;
+    }
+    bool ResumeFromCheckpoint() {
+        std::vector<uint8_t> data;
+        if(!LoadCheckpointFile(checkpointPath, data)) return false;
+        BitReader br(data.data(), data.size());
+        if(!DeserializeCheckpoint(br, serverTick, nextPlayerId, match, entities)) {
+            std::cerr<<"Ignoring unreadable checkpoint "<<checkpointPath<<std::endl;
+            return false;
+        }
+        // Restored players have no peer yet; keep them until they reconnect
+        for(uint32_t i = 0; i < entities.size(); i++) {
+            pendingReconnects.push_back({entities.HandleAt(i), serverTick + reconnectGrace});
+        }
+        std::cout<<"Resumed match from checkpoint: tick "<<serverTick<<", round "<<match.roundNumber
+                 <<", "<<entities.size()<<" players awaiting reconnect"<<std::endl;
         return true;
     }
     void TickOnce(uint32_t timeout_ms=1) {
         ctx.service([&](ENetEvent& ev){ onEvent(ev); }, timeout_ms);
     }
+    void Simulate() {
+        entities.ApplyInputs();
+        entities.SeparatePlayers(playerGrid);
+        serverTick++;
+        UpdateRound();
+        ExpireReconnects();
+        ResolveShots();
+        ThrowGrenades();
+        StepProjectiles();
+        lagComp.Record(serverTick, entities);
+        BroadcastSnapshot();
+        BroadcastCombatEvents();
+        if(serverTick % checkpointInterval == 0) WriteCheckpoint();
+    }
+    void WriteCheckpoint() {
+        // Only a memcpy of the columns happens here; disk I/O is on the writer thread
+        SerializeCheckpoint(checkpoints.Begin(), serverTick, nextPlayerId, match, entities);
+        checkpoints.Commit();
+    }
+    void UpdateRound() {
+        match.roundTimeRemaining -= TickDelta;
+        if(match.roundTimeRemaining > 0.0f) return;
+        match.roundNumber++;
+        match.roundTimeRemaining = RoundDuration;
+        for(uint32_t i = 0; i < entities.size(); i++) Respawn((uint32_t)i);
+        projectiles.clear();
+        std::cout<<"Round "<<match.roundNumber<<" started"<<std::endl;
+    }
+    void Respawn(uint32_t d) {
+        entities.posX[d] = (float)(NextRandom(match.rngState) % 200) * 0.1f - 10.0f;
+        entities.posY[d] = 0.0f;
+        entities.posZ[d] = (float)(NextRandom(match.rngState) % 200) * 0.1f - 10.0f;
+        entities.velX[d] = 0.0f; entities.velY[d] = 0.0f; entities.velZ[d] = 0.0f;
+        entities.health[d] = EntityStore::MaxHealth;
+        WeaponData::defaultLoadout(weaponData, entities.weapons[d]); // what the client's WeaponSystem starts with
+        entities.nextFireTick[d] = 0;
+    }
+    void ExpireReconnects() {
+        for(size_t i = 0; i < pendingReconnects.size(); ) {
+            if(serverTick < pendingReconnects[i].deadline) { i++; continue; }
+            entities.Destroy(pendingReconnects[i].handle);
+            pendingReconnects[i] = pendingReconnects.back();
+            pendingReconnects.pop_back();
+        }
+    }
+    uint32_t NewReconnectToken() {
+        uint32_t token;
+        do token = tokenSource(); while(token == 0); // 0 is "no token" in connect data
+        return token;
+    }
+    EntityHandle ClaimReconnect(uint32_t token) {
+        for(size_t i = 0; i < pendingReconnects.size(); i++) {
+            EntityHandle h = pendingReconnects[i].handle;
+            int32_t d = entities.DenseIndex(h);
+            if(d < 0 || entities.reconnectTokens[d] != token) continue;
+            pendingReconnects[i] = pendingReconnects.back();
+            pendingReconnects.pop_back();
+            return h;
+        }
+        return EntityHandle{};
+    }
+    void ResolveShots() {
+        rewoundTick = NoRewind;
+        for(uint32_t s = 0; s < entities.size(); s++) {
+            if(!entities.fireRequested[s]) continue;
+            entities.fireRequested[s] = 0;
+            WeaponInventory& inventory = entities.weapons[s];
+            if(inventory.active < 0) continue;
+            WeaponSlot& w = inventory.slots[inventory.active];
+            if(w.weapon >= weapons.size()) continue;
+            const ServerWeapon& weapon = weapons[w.weapon];
+            if(serverTick < entities.nextFireTick[s]) continue;
+            if(w.currentAmmo == 0) {
+                if(w.reserveAmmo == 0) continue;
+                uint16_t n = std::min((uint16_t)weapon.config->stats.magazineSize, w.reserveAmmo);
+                w.currentAmmo = n;
+                w.reserveAmmo -= n;
+                entities.nextFireTick[s] = serverTick + weapon.reloadTicks;
+                continue;
+            }
+            w.currentAmmo--;
+            entities.nextFireTick[s] = serverTick + weapon.fireInterval;
+
+            float yawR = entities.yaw[s] * 0.01745329252f, pitchR = entities.pitch[s] * 0.01745329252f;
+            Vec3 eye{entities.posX[s], entities.posY[s] + EyeHeight, entities.posZ[s]};
+            Vec3 dir = SpreadShot(s, weapon.config->stats,
+                                  {std::cos(yawR) * std::cos(pitchR), std::sin(pitchR), std::sin(yawR) * std::cos(pitchR)});
+            CombatEvent fire;
+            fire.type = CombatEventType::Fire;
+            fire.weaponId = w.weapon;
+            fire.attacker = entities.ids[s];
+            fire.pos = eye;
+            combatEvents.Push(fire);
+            TraceShot(s, eye, dir, weapon.config->stats);
+        }
+    }
+    // An HE grenade per press, from the eye along the view plus the
+    // thrower's velocity, as the game throws it; none past the pool's capacity
+    void ThrowGrenades() {
+        for(uint32_t s = 0; s < entities.size(); s++) {
+            if(!entities.throwRequested[s]) continue;
+            entities.throwRequested[s] = 0;
+            float yawR = entities.yaw[s] * 0.01745329252f, pitchR = entities.pitch[s] * 0.01745329252f;
+            glm::vec3 forward(std::cos(yawR) * std::cos(pitchR), std::sin(pitchR), std::sin(yawR) * std::cos(pitchR));
+            glm::vec3 eye(entities.posX[s], entities.posY[s] + EyeHeight, entities.posZ[s]);
+            glm::vec3 vel(entities.velX[s], entities.velY[s], entities.velZ[s]);
+            projectiles.spawn(ProjectileKind::HE_GRENADE, eye + forward * 0.5f,
+                              forward * Physics::GRENADE_THROW_SPEED + vel, entities.ids[s]);
+        }
+    }
+    // One tick of every grenade; its bounces and detonations go out with
+    // this tick's combat events
+    void StepProjectiles() {
+        projectiles.clearEvents();
+        projectiles.step(TickDelta);
+        const ProjectileEvent* events = projectiles.getEvents();
+        for(uint32_t e = 0; e < projectiles.getEventCount(); e++) {
+            const ProjectileEvent& p = events[e];
+            CombatEvent ev;
+            ev.type = p.type == ProjectileEvent::Type::Bounce ? CombatEventType::ProjectileBounce
+                                                              : CombatEventType::ProjectileDetonate;
+            ev.weaponId = (uint8_t)p.kind;
+            ev.hitLocation = p.material;
+            ev.attacker = p.owner;
+            ev.damage = p.speed;
+            ev.pos = {p.position.x, p.position.y, p.position.z};
+            combatEvents.Push(ev);
+        }
+    }
+    uint8_t ActiveWeapon(uint32_t d) const {
+        const WeaponInventory& inventory = entities.weapons[d];
+        return inventory.active < 0 ? WeaponSlot::EMPTY : inventory.slots[inventory.active].weapon;
+    }
+    // The shooter's next shot of its spread stream, drawn like the client's
+    // WeaponSystem::fireAt. The server only knows the movement part of the
+    // spread: it has no ADS or recoil state.
+    Vec3 SpreadShot(uint32_t s, const Weapons::WeaponStats& stats, const Vec3& aim) {
+        RandomStream random(PlayerSpreadSeed(match, entities.ids[s]), entities.shotSequences[s]++);
+        float speed = std::sqrt(entities.velX[s] * entities.velX[s] + entities.velZ[s] * entities.velZ[s]);
+        float speedFraction = speed > 1.0f ? speed / Physics::MAX_GROUND_SPEED : 0.0f;
+        bool airborne = entities.posY[s] > Physics::GROUND_TOLERANCE;
+        float spread = Hitscan::shotSpread(stats, speedFraction, airborne, 0.0f, 0.0f);
+        glm::vec3 dir = Hitscan::spreadDirection(glm::vec3(aim.x, aim.y, aim.z), spread, random);
+        return {dir.x, dir.y, dir.z};
+    }
+    void PoseHitboxes(Tick tick, uint8_t offset) {
+        if(tick == rewoundTick && offset == rewoundOffset) return;
+        rewoundTargets.resize(entities.size());
+        for(uint32_t t = 0; t < entities.size(); t++) {
+            // Someone who joined after `tick` has no frame there and is
+            // tested where they are now
+            Vec3 p{entities.posX[t], entities.posY[t], entities.posZ[t]};
+            lagComp.Rewind(tick, offset / 256.0f, entities.ids[t], p);
+            Hitscan::Target& target = rewoundTargets[t];
+            target.id = (int)t;
+            target.feet = glm::vec3(p.x, p.y, p.z);
+            target.yaw = entities.yaw[t];   // history keeps positions only
+        }
+        rewoundHitboxes.build(rewoundTargets.data(), (uint32_t)rewoundTargets.size());
+        rewoundTick = tick;
+        rewoundOffset = offset;
+    }
+    void TraceShot(uint32_t s, const Vec3& eye, const Vec3& dir, const Weapons::WeaponStats& stats) {
+        // Targets are checked where the shooter saw them: one-way latency back in
+        // history, then forward to the sub-tick moment of the click
+        Tick rewindTick = serverTick > entities.latencyTicks[s] ? serverTick - entities.latencyTicks[s] : 0;
+        PoseHitboxes(rewindTick, entities.fireOffset[s]);
+        HitResult result;
+        if(!rewoundHitboxes.raycast(glm::vec3(eye.x, eye.y, eye.z), glm::vec3(dir.x, dir.y, dir.z),
+                                    stats.maxRange, (int)s, result)) return;
+        int32_t victim = result.targetId;
+        float best = result.distance;
+
+        float falloff = 1.0f;
+        if(best > stats.optimalRange) {
+            float k = (best - stats.optimalRange) / (stats.maxRange - stats.optimalRange);
+            falloff = std::max(stats.minDamagePercent, 1.0f - k * (1.0f - stats.minDamagePercent));
+        }
+        float multiplier = 1.0f;    // same table as WeaponSystem::calculateDamage
+        switch(result.hitLocation) {
+            case HitResult::HEAD: multiplier = stats.headshotMultiplier; break;
+            case HitResult::CHEST: multiplier = stats.chestMultiplier; break;
+            case HitResult::STOMACH: break;
+            default: multiplier = stats.limbMultiplier; break;
+        }
+        float damage = stats.baseDamage * falloff * multiplier;
+        damage = std::min(damage, entities.health[victim]);
+        entities.health[victim] -= damage;
+
+        CombatEvent hit;
+        hit.type = CombatEventType::Hit;
+        hit.hitLocation = (uint8_t)result.hitLocation;
+        hit.weaponId = ActiveWeapon(s);
+        hit.attacker = entities.ids[s];
+        hit.victim = entities.ids[victim];
+        hit.damage = damage;
+        hit.pos = {result.hitPoint.x, result.hitPoint.y, result.hitPoint.z};
+        combatEvents.Push(hit);
+        if(entities.health[victim] > 0.0f) return;
+
+        hit.type = CombatEventType::Kill;
+        hit.damage = 0.0f;
+        combatEvents.Push(hit);
+        Respawn((uint32_t)victim);
+    }
+    void BroadcastCombatEvents() {
+        // One reliable packet per tick for everyone, on its own channel so a
+        // resend never stalls the unreliable snapshot stream.
+        if(combatEvents.Empty()) return;
+        eventBody.buf.clear();
+        combatEvents.Serialize(eventBody, serverTick);
+        combatEvents.Clear();
+        ENetPacket* pkt = enet_packet_create(eventBody.buf.data(), eventBody.buf.size(), ENET_PACKET_FLAG_RELIABLE);
+        enet_host_broadcast(ctx.host, (uint8_t)Channel::Events, pkt);
+    }
+    EntityHandle handleFor(ENetPeer* peer) const {
+        return peerHandles[peer->incomingPeerID];
+    }
     void onEvent(ENetEvent& ev) {
         switch(ev.type) {
             case ENET_EVENT_TYPE_CONNECT: {
-                auto id = nextPlayerId++;
-                peersToId[ev.peer] = id;
+                // Connect data carries the reconnect token a client got in Welcome
+                // before a server restart; the PlayerId itself is public
+                EntityHandle h = ev.data ? ClaimReconnect(ev.data) : EntityHandle{};
+                if(!h.valid()) {
+                    if(entities.full()) { enet_peer_disconnect(ev.peer, 0); break; }
+                    uint8_t team = PickTeam();
+                    h = entities.Create(nextPlayerId++);
+                    int32_t d = entities.DenseIndex(h);
+                    entities.teams[d] = team;
+                    Respawn((uint32_t)d);
+                }
+                int32_t d = entities.DenseIndex(h);
+                PlayerId id = entities.ids[d];
+                entities.reconnectTokens[d] = NewReconnectToken(); // a token is good for one reclaim
+                peerHandles[ev.peer->incomingPeerID] = h;
                 ev.peer->data = (void*)(uintptr_t)id;
+                // Checkpoint the new token now rather than at the next periodic
+                // write, so a crash in between can't leave the client holding a
+                // token the restarted server never saw.
+                WriteCheckpoint();
+                sendWelcome(ev.peer, id, entities.shotSequences[d], entities.reconnectTokens[d]);
                 std::cout<<"Client connected id="<<id<<std::endl;
                 break;
             }
             case ENET_EVENT_TYPE_RECEIVE: {
-                if(ev.packet->dataLength < 1) break;
-                uint8_t t = ev.packet->data[0];
+                uint8_t t = ev.packet->dataLength > 0 ? ev.packet->data[0] : 0;
                 if(t == (uint8_t)PacketType::ClientInput) {
                     BitReader br(ev.packet->data+1, ev.packet->dataLength-1);
                     InputState in{};
-                    if(br.readPOD(in)) {
-                        Snapshot s; s.tick = in.tick;
-                        EntityState e; e.id = peersToId[ev.peer];
-                        e.pos = {in.forward*5.0f, 0.0f, in.right*5.0f};
-                        e.vel = {0,0,0};
-                        e.yaw = in.yaw; e.pitch = in.pitch;
-                        s.entities.push_back(e);
-                        sendSnapshot(ev.peer, s);
+                    int32_t d = entities.DenseIndex(handleFor(ev.peer));
+                    if(d >= 0 && br.readPOD(in)) {
+                        entities.inputs[d].push(in);
+                        uint32_t latency = ev.peer->roundTripTime / 2 * TickRate / 1000;
+                        entities.latencyTicks[d] = (uint16_t)std::min<uint32_t>(latency, std::min<uint32_t>(maxUnlagTicks, LagCompHistory::Frames - 1));
                     }
                 }
-                enet_packet_destroy(ev.packet);
+                else if(t == (uint8_t)PacketType::Voice) {
+                    RelayVoice(ev);
+                }
+                else if(t == (uint8_t)PacketType::VoiceMute) {
+                    BitReader br(ev.packet->data+1, ev.packet->dataLength-1);
+                    PlayerId target; uint8_t muted;
+                    if(br.readPOD(target) && br.readPOD(muted)) SetVoiceMute(ev.peer, target, muted != 0);
+                }
+                // Relayed packets are owned by ENet until every recipient has sent them
+                if(ev.packet->referenceCount == 0) enet_packet_destroy(ev.packet);
                 break;
             }
             case ENET_EVENT_TYPE_DISCONNECT: {
                 std::cout<<"Client disconnected"<<std::endl;
-                peersToId.erase(ev.peer);
+                entities.Destroy(handleFor(ev.peer));
+                peerHandles[ev.peer->incomingPeerID] = EntityHandle{};
                 ev.peer->data = nullptr;
                 break;
             }
             default: break;
         }
     }
-    void sendSnapshot(ENetPeer* peer, const Snapshot& s) {
+    uint8_t PickTeam() const {
+        uint32_t counts[2] = {0, 0};
+        for(uint32_t i = 0; i < entities.size(); i++) counts[entities.teams[i] & 1]++;
+        return counts[0] <= counts[1] ? 0 : 1;
+    }
+    void RelayVoice(ENetEvent& ev) {
+        // Zero-copy fan-out: the received packet itself is queued on every
+        // recipient (ENet reference-counts it), the payload is never touched.
+        ENetPacket* pkt = ev.packet;
+        if(pkt->dataLength < VoiceHeaderSize || pkt->dataLength > VoiceHeaderSize + MaxVoicePayload) return;
+        EntityHandle from = handleFor(ev.peer);
+        int32_t s = entities.DenseIndex(from);
+        if(s < 0) return;
+        PlayerId speaker = entities.ids[s];
+        std::memcpy(pkt->data + 1, &speaker, sizeof(PlayerId)); // stamped here so clients can't spoof it
+        const uint64_t speakerBit = 1ull << from.index;
+        const float range2 = voiceRange * voiceRange;
+        for(size_t p = 0; p < peerHandles.size(); p++) {
+            int32_t d = entities.DenseIndex(peerHandles[p]);
+            if(d < 0 || d == s) continue;
+            if(entities.teams[d] != entities.teams[s]) continue;
+            if(entities.voiceMutes[d] & speakerBit) continue;
+            if(range2 > 0.0f) {
+                float dx = entities.posX[d] - entities.posX[s];
+                float dy = entities.posY[d] - entities.posY[s];
+                float dz = entities.posZ[d] - entities.posZ[s];
+                if(dx*dx + dy*dy + dz*dz > range2) continue;
+            }
+            enet_peer_send(&ctx.host->peers[p], (uint8_t)Channel::Voice, pkt);
+        }
+    }
+    void SetVoiceMute(ENetPeer* peer, PlayerId target, bool muted) {
+        int32_t d = entities.DenseIndex(handleFor(peer));
+        EntityHandle t = entities.Find(target);
+        if(d < 0 || !t.valid()) return;
+        uint64_t bit = 1ull << t.index;
+        entities.voiceMutes[d] = muted ? (entities.voiceMutes[d] | bit) : (entities.voiceMutes[d] & ~bit);
+    }
+    void BroadcastSnapshot() {
+        // Entity block is serialized once per tick; each peer only gets its
+        // own small header (ack + local id) in front of the shared block.
+        entities.BuildSnapshot(snapshot);
+        snapshotBody.buf.clear();
+        uint32_t n = (uint32_t)snapshot.entities.size();
+        snapshotBody.writePOD(n);
+        for(auto &e: snapshot.entities) {
+            snapshotBody.writePOD(e.id);
+            snapshotBody.writePOD(e.pos.x); snapshotBody.writePOD(e.pos.y); snapshotBody.writePOD(e.pos.z);
+            snapshotBody.writePOD(e.vel.x); snapshotBody.writePOD(e.vel.y); snapshotBody.writePOD(e.vel.z);
+            snapshotBody.writePOD(e.yaw); snapshotBody.writePOD(e.pitch);
+        }
+        for(size_t p = 0; p < peerHandles.size(); p++) {
+            int32_t d = entities.DenseIndex(peerHandles[p]);
+            if(d < 0) continue;
+            sendSnapshot(&ctx.host->peers[p], entities.lastInputTick[d], entities.ids[d]);
+        }
+    }
+    void sendWelcome(ENetPeer* peer, PlayerId id, uint32_t shotSequence, uint32_t reconnectToken) {
         BitWriter bw;
-        bw.writePOD((uint8_t)PacketType::Snapshot);
-        bw.writePOD(s.tick);
-        uint32_t n = (uint32_t)s.entities.size();
-        bw.writePOD(n);
-        for(auto &e: s.entities) {
-            bw.writePOD(e.id);
-            bw.writePOD(e.pos.x); bw.writePOD(e.pos.y); bw.writePOD(e.pos.z);
-            bw.writePOD(e.vel.x); bw.writePOD(e.vel.y); bw.writePOD(e.vel.z);
-            bw.writePOD(e.yaw); bw.writePOD(e.pitch);
-        }
-        ENetPacket* pkt = enet_packet_create(bw.buf.data(), bw.buf.size(), ENET_PACKET_FLAG_UNSEQUENCED);
-        enet_peer_send(peer, 0, pkt);
+        bw.writePOD((uint8_t)PacketType::Welcome);
+        bw.writePOD(id);
+        bw.writePOD(serverTick);
+        bw.writePOD(PlayerSpreadSeed(match, id));
+        bw.writePOD(shotSequence);
+        bw.writePOD(reconnectToken);
+        bw.writePOD(weaponData.hash());    // clients must predict with the same definitions
+        bw.writePOD(match.ruleset);        // ... and the same movement
+        ENetPacket* pkt = enet_packet_create(bw.buf.data(), bw.buf.size(), ENET_PACKET_FLAG_RELIABLE);
+        enet_peer_send(peer, (uint8_t)Channel::Game, pkt);
+    }
+    void sendSnapshot(ENetPeer* peer, Tick ackTick, PlayerId localId) {
+        const size_t headerSize = sizeof(uint8_t) + sizeof(Tick) * 2 + sizeof(PlayerId);
+        ENetPacket* pkt = enet_packet_create(nullptr, headerSize + snapshotBody.buf.size(), ENET_PACKET_FLAG_UNSEQUENCED);
+        uint8_t* w = pkt->data;
+        *w++ = (uint8_t)PacketType::Snapshot;
+        std::memcpy(w, &ackTick, sizeof(Tick)); w += sizeof(Tick);
+        std::memcpy(w, &serverTick, sizeof(Tick)); w += sizeof(Tick);
+        std::memcpy(w, &localId, sizeof(PlayerId)); w += sizeof(PlayerId);
+        std::memcpy(w, snapshotBody.buf.data(), snapshotBody.buf.size());
+        enet_peer_send(peer, (uint8_t)Channel::Game, pkt);
     }
 };
 
 #ifdef TRUESHOT_SERVER
-int main() {
+int main(int argc, char** argv) {
     ServerCore s;
-    if(!s.Start()) return 1;
+    bool resume = true;
+    for(int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if(arg == "--fresh") resume = false;
+        else if(arg == "--checkpoint" && i + 1 < argc) s.checkpointPath = argv[++i];
+        else if(arg == "--weapons" && i + 1 < argc) s.weaponBlobPath = argv[++i];
+        else if(arg == "--ruleset" && i + 1 < argc) {
+            if(!Physics::parseRuleset(argv[++i], s.match.ruleset)) { std::cerr<<"Unknown ruleset "<<argv[i]<<std::endl; return 1; }
+        }
+    }
+    if(!s.Start(resume)) return 1;
+    using Clock = std::chrono::steady_clock;
+    const auto step = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(TickDelta));
+    auto nextTick = Clock::now() + step;
     while(true) {
-        s.TickOnce(5);
+        auto now = Clock::now();
+        if(now < nextTick) {
+            auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(nextTick - now).count();
+            s.TickOnce((uint32_t)wait);
+            continue;
+        }
+        s.Simulate();
+        nextTick += step;
     }
     return 0;
 }
@@ -0,0 +1,47 @@
+#include "Network/SpatialGrid.h"
+
+namespace Net {
+
+SpatialGrid::SpatialGrid(float cellSize, uint32_t bucketCount)
+    : cellSize(cellSize), invCellSize(1.0f / cellSize), bucketMask(bucketCount - 1) {
+    bucketHead.assign(bucketCount, None);
+}
+
+void SpatialGrid::Resize(uint32_t n) {
+    for(uint32_t i = n; i < size(); i++) Unlink(i);
+    itemX.resize(n, 0.0f); itemZ.resize(n, 0.0f);
+    itemCellX.resize(n, Unlinked); itemCellZ.resize(n, Unlinked);
+    next.resize(n, None); prev.resize(n, None);
+}
+
+void SpatialGrid::Update(uint32_t index, float x, float z) {
+    if(index >= size()) Resize(index + 1);
+    itemX[index] = x;
+    itemZ[index] = z;
+    int32_t cx = CellOf(x), cz = CellOf(z);
+    if(cx == itemCellX[index] && cz == itemCellZ[index]) return;
+    Unlink(index);
+    itemCellX[index] = cx;
+    itemCellZ[index] = cz;
+    Link(index);
+    relinks++;
+}
+
+void SpatialGrid::Link(uint32_t i) {
+    uint32_t& head = bucketHead[Bucket(itemCellX[i], itemCellZ[i])];
+    prev[i] = None;
+    next[i] = head;
+    if(head != None) prev[head] = i;
+    head = i;
+}
+
+void SpatialGrid::Unlink(uint32_t i) {
+    if(itemCellX[i] == Unlinked) return;
+    if(prev[i] != None) next[prev[i]] = next[i];
+    else bucketHead[Bucket(itemCellX[i], itemCellZ[i])] = next[i];
+    if(next[i] != None) prev[next[i]] = prev[i];
+    next[i] = prev[i] = None;
+    itemCellX[i] = itemCellZ[i] = Unlinked;
+}
+
+} // namespace Net
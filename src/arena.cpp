@@ -0,0 +1,29 @@
+#include "arena.h"
+#include "collision_world.h"
+#include "audio_types.h"
+
+void buildArena(CollisionWorld& world, uint32_t crates) {
+    const uint8_t concrete = static_cast<uint8_t>(Audio::SurfaceMaterial::CONCRETE);
+    const uint8_t metal = static_cast<uint8_t>(Audio::SurfaceMaterial::METAL);
+    world.addQuad(glm::vec3(-50.0f, 0.0f, -50.0f), glm::vec3(-50.0f, 0.0f, 50.0f),
+                  glm::vec3(0.0f, 0.0f, 50.0f), glm::vec3(0.0f, 0.0f, -50.0f), concrete);
+    world.addQuad(glm::vec3(0.0f, 0.0f, -50.0f), glm::vec3(0.0f, 0.0f, 50.0f),
+                  glm::vec3(50.0f, 0.0f, 50.0f), glm::vec3(50.0f, 0.0f, -50.0f), metal);
+    const float arena = 45.0f + Physics::PLAYER_RADIUS;
+    world.addBox(glm::vec3(-arena - 1.0f, 0.0f, -arena - 1.0f), glm::vec3(-arena, 200.0f, arena + 1.0f), concrete);
+    world.addBox(glm::vec3(arena, 0.0f, -arena - 1.0f), glm::vec3(arena + 1.0f, 200.0f, arena + 1.0f), concrete);
+    world.addBox(glm::vec3(-arena, 0.0f, -arena - 1.0f), glm::vec3(arena, 200.0f, -arena), concrete);
+    world.addBox(glm::vec3(-arena, 0.0f, arena), glm::vec3(arena, 200.0f, arena + 1.0f), concrete);
+
+    uint32_t seed = 12345;
+    auto random = [&seed]() {                   // LCG in [0, 1), same layout every run
+        seed = seed * 1664525u + 1013904223u;
+        return static_cast<float>(seed >> 8) / 16777216.0f;
+    };
+    for (uint32_t i = 0; i < crates; ++i) {
+        glm::vec3 min(random() * 86.0f - 43.0f, 0.0f, random() * 86.0f - 43.0f);
+        glm::vec3 size(0.5f + random() * 1.5f, 0.5f + random() * 2.0f, 0.5f + random() * 1.5f);
+        world.addBox(min, min + size, random() < 0.5f ? concrete : metal);
+    }
+    world.build();
+}
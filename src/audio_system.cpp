@@ -1,7 +1,9 @@
 #include "audio_system.h"
 #include "fps_camera.h"
 #include "player_controller.h"
+#include "projectile_system.h"
 #include "weapon_system.h"
+#include "telemetry.h"
 #include <iostream>
 #include <fstream>
 #include <algorithm>
@@ -97,6 +99,7 @@ void AudioSystem::update(float deltaTime) {
     processAudioQueue();
     
     // Update source positions and effects
+    updateStreamingSources(deltaTime);
     updateSourcesPosition();
     updateEnvironmentalEffects();
     
@@ -118,7 +121,7 @@ void AudioSystem::setListenerFromCamera(FPSCamera* camera, PlayerController* pla
     m_Player = player;
     
     if (camera && player) {
-        glm::vec3 position = player->getPosition();
+        glm::vec3 position = player->getRenderPosition();
         glm::vec3 velocity = player->getVelocity();
         glm::vec3 forward = camera->getForward();
         glm::vec3 up = glm::vec3(0.0f, 1.0f, 0.0f);
@@ -156,7 +159,7 @@ int AudioSystem::playSound(const std::string& soundName, const glm::vec3& positi
         }
         
         if (clipIt == m_AudioClips.end()) {
-            std::cout << "Warning: Sound not found: " << soundName << std::endl;
+            TS_LOG_WARN("Warning: Sound not found: {}", soundName);
             return -1;
         }
     }
@@ -194,10 +197,8 @@ int AudioSystem::playSound(const std::string& soundName, const glm::vec3& positi
     
     // Debug output
     if (m_DebugVisualization) {
-        std::cout << "🔊 Playing: " << soundName 
-                  << " | Pos: (" << position.x << ", " << position.y << ", " << position.z << ")"
-                  << " | Dist: " << distance << "m"
-                  << " | Vol: " << calculatedVolume << std::endl;
+        TS_LOG_DEBUG("🔊 Playing: {} | Pos: ({}, {}, {}) | Dist: {}m | Vol: {}",
+                     soundName, position.x, position.y, position.z, distance, calculatedVolume);
     }
     
     m_Metrics.soundsPlayedThisFrame++;
@@ -206,6 +207,74 @@ int AudioSystem::playSound(const std::string& soundName, const glm::vec3& positi
     return sourceId;
 }
 
+int AudioSystem::createStreamingSource(Audio::AudioCategory category, int sampleRate) {
+    int sourceId = createAudioSource();
+    if (sourceId == -1) return -1;
+    
+    AudioSource* source = getAudioSource(sourceId);
+    source->isStreaming = true;
+    source->streamSampleRate = sampleRate;
+    source->streamBuffer.assign(std::max<size_t>(1, (size_t)(sampleRate * MAX_STREAM_BUFFER_SECONDS)), 0.0f);
+    source->is3D = false;
+    source->looping = true;         // Stays alive while the queue is momentarily empty
+    source->isPlaying = true;
+    source->category = category;
+    source->priority = Audio::Priority::HIGH;
+    
+    return sourceId;
+}
+
+bool AudioSystem::queueStreamSamples(int sourceId, const float* samples, size_t count) {
+    AudioSource* source = getAudioSource(sourceId);
+    if (!source || !source->isStreaming) return false;
+    
+    // Over the latency cap the oldest samples are dropped: skip what the
+    // ring can't hold, then advance the read position past what gets overwritten
+    std::vector<float>& buffer = source->streamBuffer;
+    const size_t capacity = buffer.size();
+    if (count > capacity) {
+        samples += count - capacity;
+        count = capacity;
+    }
+    if (source->streamQueued + count > capacity) {
+        size_t dropped = source->streamQueued + count - capacity;
+        source->streamReadPos = (source->streamReadPos + dropped) % capacity;
+        source->streamQueued -= dropped;
+    }
+    
+    size_t writePos = (source->streamReadPos + source->streamQueued) % capacity;
+    size_t first = std::min(count, capacity - writePos);
+    std::copy(samples, samples + first, buffer.begin() + writePos);
+    std::copy(samples + first, samples + count, buffer.begin());
+    source->streamQueued += count;
+    
+    // In real implementation: alSourceQueueBuffers with the new block
+    return true;
+}
+
+size_t AudioSystem::getQueuedStreamSamples(int sourceId) const {
+    auto it = m_ActiveSources.find(sourceId);
+    if (it == m_ActiveSources.end() || !it->second->isStreaming) return 0;
+    return it->second->streamQueued;
+}
+
+void AudioSystem::updateStreamingSources(float deltaTime) {
+    for (auto& pair : m_ActiveSources) {
+        AudioSource* source = pair.second.get();
+        if (!source->isStreaming || !source->isPlaying) continue;
+        
+        // Simulated playback: consume what the device would have played
+        size_t queued = source->streamQueued;
+        size_t wanted = (size_t)(deltaTime * source->streamSampleRate);
+        if (wanted > queued && queued > 0) {
+            m_Metrics.streamUnderruns++;
+        }
+        size_t played = std::min(wanted, queued);
+        source->streamReadPos = (source->streamReadPos + played) % source->streamBuffer.size();
+        source->streamQueued -= played;
+    }
+}
+
 int AudioSystem::playSound2D(const std::string& soundName, float volume, float pitch) {
     int sourceId = createAudioSource();
     if (sourceId == -1) return -1;
@@ -220,7 +289,7 @@ int AudioSystem::playSound2D(const std::string& soundName, float volume, float p
     source->category = Audio::AudioCategory::UI;
     
     if (m_DebugVisualization) {
-        std::cout << "🔊 Playing 2D: " << soundName << " | Vol: " << volume << std::endl;
+        TS_LOG_DEBUG("🔊 Playing 2D: {} | Vol: {}", soundName, volume);
     }
     
     return sourceId;
@@ -229,7 +298,7 @@ int AudioSystem::playSound2D(const std::string& soundName, float volume, float p
 int AudioSystem::playSoundEvent(Audio::AudioEvent event, const glm::vec3& position, float volume) {
     auto eventIt = m_EventToSound.find(event);
     if (eventIt == m_EventToSound.end()) {
-        std::cout << "Warning: No sound mapped for event: " << (int)event << std::endl;
+        TS_LOG_WARN("Warning: No sound mapped for event: {}", event);
         return -1;
     }
     
@@ -255,8 +324,7 @@ void AudioSystem::onWeaponFire(const std::string& weaponName, const glm::vec3& p
     scheduleDelayedSound(weaponName + "_brass", position, 0.2f, 0.3f);
     
     if (m_DebugVisualization) {
-        std::cout << "🔫 " << weaponName << " fired at (" 
-                  << position.x << ", " << position.y << ", " << position.z << ")" << std::endl;
+        TS_LOG_DEBUG("🔫 {} fired at ({}, {}, {})", weaponName, position.x, position.y, position.z);
     }
 }
 
@@ -276,8 +344,7 @@ void AudioSystem::onWeaponDraw(const std::string& weaponName, const glm::vec3& p
     }
     
     if (m_DebugVisualization) {
-        std::cout << "🔫 " << weaponName << " drew at (" 
-                  << position.x << ", " << position.y << ", " << position.z << ")" << std::endl;
+        TS_LOG_DEBUG("🔫 {} drew at ({}, {}, {})", weaponName, position.x, position.y, position.z);
     }
 }
 
@@ -296,7 +363,7 @@ void AudioSystem::onWeaponReload(const std::string& weaponName, const glm::vec3&
     }
     
     if (m_DebugVisualization) {
-        std::cout << "🔄 " << weaponName << " reload (" << reloadPhase << ")" << std::endl;
+        TS_LOG_DEBUG("🔄 {} reload ({})", weaponName, reloadPhase);
     }
 }
 
@@ -324,6 +391,46 @@ void AudioSystem::onBulletImpact(const glm::vec3& position, Audio::SurfaceMateri
     }
 }
 
+void AudioSystem::onGrenadeBounce(const glm::vec3& position, Audio::SurfaceMaterial material, float impactSpeed) {
+    std::string bounceSound = AudioUtils::getSurfaceSoundName(material, "grenade_bounce");
+    float volume = std::min(1.0f, impactSpeed / 400.0f);
+    int sourceId = playSound(bounceSound, position, volume);
+    
+    if (sourceId != -1) {
+        AudioSource* source = getAudioSource(sourceId);
+        if (source) {
+            source->category = Audio::AudioCategory::SFX;
+            source->settings3D.minDistance = 1.0f;
+            source->settings3D.maxDistance = 40.0f;
+            addPitchVariation(*source, 0.1f);
+        }
+    }
+}
+
+void AudioSystem::onGrenadeDetonate(const std::string& grenadeName, const glm::vec3& position) {
+    int sourceId = playSound(grenadeName + "_detonate", position, 1.0f);
+    
+    if (sourceId != -1) {
+        AudioSource* source = getAudioSource(sourceId);
+        if (source) {
+            source->category = Audio::AudioCategory::SFX;
+            source->settings3D.minDistance = 3.0f;
+            source->settings3D.maxDistance = 150.0f;   // Heard across the map
+        }
+    }
+}
+
+void AudioSystem::onProjectileEvents(const ProjectileEvent* events, uint32_t count) {
+    for (uint32_t e = 0; e < count; ++e) {
+        const ProjectileEvent& event = events[e];
+        if (event.type == ProjectileEvent::Type::Bounce) {
+            onGrenadeBounce(event.position, static_cast<Audio::SurfaceMaterial>(event.material), event.speed);
+        } else {
+            onGrenadeDetonate(ProjectileSystem::getSpec(event.kind).name, event.position);
+        }
+    }
+}
+
 void AudioSystem::onFootstep(const glm::vec3& position, Audio::SurfaceMaterial surface, 
                             float movementSpeed, bool isLocalPlayer) {
     
@@ -372,7 +479,7 @@ void AudioSystem::onFootstep(const glm::vec3& position, Audio::SurfaceMaterial s
     }
     
     if (m_DebugVisualization && !isLocalPlayer) {
-        std::cout << "👟 Footstep on " << (int)surface << " | Speed: " << movementSpeed << std::endl;
+        TS_LOG_DEBUG("👟 Footstep on {} | Speed: {}", surface, movementSpeed);
     }
 }
 
@@ -416,7 +523,7 @@ void AudioSystem::stopSound(int sourceId) {
         // In real implementation: alSourceStop(it->second->alSourceId);
         
         if (m_DebugVisualization) {
-            std::cout << "⏹️ Stopped source " << sourceId << std::endl;
+            TS_LOG_DEBUG("⏹️ Stopped source {}", sourceId);
         }
     }
 }
@@ -490,8 +597,10 @@ void AudioSystem::setupEventMappings() {
     m_EventToSound[Audio::AudioEvent::BULLET_IMPACT_CONCRETE] = "impact_concrete";
     m_EventToSound[Audio::AudioEvent::BULLET_IMPACT_METAL] = "impact_metal";
     m_EventToSound[Audio::AudioEvent::BULLET_IMPACT_WOOD] = "impact_wood";
+    m_EventToSound[Audio::AudioEvent::BULLET_IMPACT_FLESH] = "impact_flesh";
     m_EventToSound[Audio::AudioEvent::UI_SELECT] = "ui_select";
     m_EventToSound[Audio::AudioEvent::UI_HOVER] = "ui_hover";
+    m_EventToSound[Audio::AudioEvent::UI_NOTIFICATION] = "ui_notification";
 }
 
 void AudioSystem::loadDefaultSounds() {
@@ -518,8 +627,18 @@ void AudioSystem::loadDefaultSounds() {
     registerDummySound("impact_concrete", 0.1f);
     registerDummySound("impact_metal", 0.12f);
     registerDummySound("impact_wood", 0.09f);
+    registerDummySound("impact_flesh", 0.08f);
     registerDummySound("ricochet", 0.3f);
     
+    // Grenade sounds
+    registerDummySound("grenade_bounce_concrete", 0.1f);
+    registerDummySound("grenade_bounce_metal", 0.12f);
+    registerDummySound("grenade_bounce_wood", 0.1f);
+    registerDummySound("he_grenade_detonate", 1.2f);
+    registerDummySound("flashbang_detonate", 0.8f);
+    registerDummySound("smoke_detonate", 2.0f);
+    registerDummySound("molotov_detonate", 1.0f);
+    
     // Movement sounds
     registerDummySound("footstep_concrete", 0.05f);
     registerDummySound("footstep_metal", 0.06f);
@@ -530,6 +649,9 @@ void AudioSystem::loadDefaultSounds() {
     // UI sounds
     registerDummySound("ui_select", 0.05f);
     registerDummySound("ui_hover", 0.03f);
+    registerDummySound("ui_notification", 0.3f);
+    registerDummySound("hitmarker", 0.05f);
+    registerDummySound("hitmarker_head", 0.08f);
     
     std::cout << "Loaded " << m_AudioClips.size() << " default sounds" << std::endl;
 }
@@ -608,8 +730,8 @@ void AudioSystem::cleanupFinishedSources() {
             }
         }
         
-        // Check if source is finished
-        if (!source->isPlaying && !source->looping) {
+        // Check if source is finished; a stopped stream goes even though it loops
+        if (!source->isPlaying && (!source->looping || source->isStreaming)) {
             toRemove.push_back(pair.first);
         }
         
@@ -619,7 +741,7 @@ void AudioSystem::cleanupFinishedSources() {
             
             // Check if non-looping sound finished
             auto clipIt = m_AudioClips.find("dummy"); // Would need actual clip lookup
-            if (clipIt != m_AudioClips.end() && !source->looping) {
+            if (clipIt != m_AudioClips.end() && !source->looping && !source->isStreaming) {
                 if (source->currentTime >= clipIt->second->duration) {
                     source->isPlaying = false;
                 }
@@ -775,7 +897,7 @@ void AudioSystem::updateCurrentAudioZone() {
             m_Listener.currentSurface = m_CurrentZone->defaultSurface;
             
             if (m_DebugVisualization) {
-                std::cout << "🏠 Entered audio zone: " << m_CurrentZone->reverb.name << std::endl;
+                TS_LOG_DEBUG("🏠 Entered audio zone: {}", m_CurrentZone->reverb.name);
             }
         }
     }
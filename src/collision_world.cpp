@@ -0,0 +1,987 @@
+#include "collision_world.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Smallest root of a*t^2 + b*t + c in (0, maxRoot)
+    bool lowestRoot(float a, float b, float c, float maxRoot, float& root) {
+        if (std::fabs(a) < 1e-12f) return false;
+        float det = b * b - 4.0f * a * c;
+        if (det < 0.0f) return false;
+        float s = std::sqrt(det);
+        float r1 = (-b - s) / (2.0f * a);
+        float r2 = (-b + s) / (2.0f * a);
+        if (r1 > r2) std::swap(r1, r2);
+        if (r1 > 0.0f && r1 < maxRoot) { root = r1; return true; }
+        if (r2 > 0.0f && r2 < maxRoot) { root = r2; return true; }
+        return false;
+    }
+
+    bool pointInTriangle(const glm::vec3& p, const CollisionWorld::Triangle& tri) {
+        const glm::vec3& n = tri.normal;
+        if (glm::dot(glm::cross(tri.b - tri.a, p - tri.a), n) < 0.0f) return false;
+        if (glm::dot(glm::cross(tri.c - tri.b, p - tri.b), n) < 0.0f) return false;
+        if (glm::dot(glm::cross(tri.a - tri.c, p - tri.c), n) < 0.0f) return false;
+        return true;
+    }
+
+    // Ericson, Real-Time Collision Detection 5.1.5
+    glm::vec3 closestPointOnTriangle(const glm::vec3& p, const CollisionWorld::Triangle& tri) {
+        glm::vec3 ab = tri.b - tri.a, ac = tri.c - tri.a, ap = p - tri.a;
+        float d1 = glm::dot(ab, ap), d2 = glm::dot(ac, ap);
+        if (d1 <= 0.0f && d2 <= 0.0f) return tri.a;
+
+        glm::vec3 bp = p - tri.b;
+        float d3 = glm::dot(ab, bp), d4 = glm::dot(ac, bp);
+        if (d3 >= 0.0f && d4 <= d3) return tri.b;
+
+        float vc = d1 * d4 - d3 * d2;
+        if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return tri.a + ab * (d1 / (d1 - d3));
+
+        glm::vec3 cp = p - tri.c;
+        float d5 = glm::dot(ab, cp), d6 = glm::dot(ac, cp);
+        if (d6 >= 0.0f && d5 <= d6) return tri.c;
+
+        float vb = d5 * d2 - d1 * d6;
+        if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return tri.a + ac * (d2 / (d2 - d6));
+
+        float va = d3 * d6 - d5 * d4;
+        if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+            return tri.b + (tri.c - tri.b) * ((d4 - d3) / ((d4 - d3) + (d5 - d6)));
+        }
+
+        float denom = 1.0f / (va + vb + vc);
+        return tri.a + ab * (vb * denom) + ac * (vc * denom);
+    }
+
+    // Swept sphere vs one-sided triangle (plane, then vertices and edges).
+    // Lowers `best` and fills point/normal when contact happens before it.
+    bool sweepSphereTriangle(const CollisionWorld::Triangle& tri, const glm::vec3& center, float radius,
+                             const glm::vec3& delta, float& best, glm::vec3& point, glm::vec3& normal) {
+        float dist = glm::dot(tri.normal, center - tri.a);
+        float approach = glm::dot(tri.normal, delta);
+        // Back faces and motion away from / parallel to the plane never block
+        if (dist < 0.0f || approach >= 0.0f) return false;
+
+        // Every contact happens once the sphere reaches the plane
+        float t0 = dist > radius ? (dist - radius) / -approach : 0.0f;
+        if (t0 >= best) return false;
+
+        glm::vec3 planePoint = dist > radius ? center - tri.normal * radius + delta * t0
+                                             : center - tri.normal * dist;
+        if (pointInTriangle(planePoint, tri)) {
+            best = t0;
+            point = planePoint;
+            normal = tri.normal;
+            return true;
+        }
+
+        float t = best;
+        bool found = false;
+        float deltaSq = glm::dot(delta, delta);
+        float radiusSq = radius * radius;
+
+        const glm::vec3* verts[3] = {&tri.a, &tri.b, &tri.c};
+        for (int i = 0; i < 3; ++i) {
+            const glm::vec3& p = *verts[i];
+            float b = 2.0f * glm::dot(delta, center - p);
+            float c = glm::dot(p - center, p - center) - radiusSq;
+            float root;
+            if (lowestRoot(deltaSq, b, c, t, root)) {
+                t = root;
+                point = p;
+                found = true;
+            }
+        }
+
+        for (int i = 0; i < 3; ++i) {
+            const glm::vec3& p0 = *verts[i];
+            const glm::vec3& p1 = *verts[(i + 1) % 3];
+            glm::vec3 edge = p1 - p0;
+            glm::vec3 base = p0 - center;
+            float edgeSq = glm::dot(edge, edge);
+            float edgeDotDelta = glm::dot(edge, delta);
+            float edgeDotBase = glm::dot(edge, base);
+
+            float a = edgeSq * -deltaSq + edgeDotDelta * edgeDotDelta;
+            float b = edgeSq * (2.0f * glm::dot(delta, base)) - 2.0f * edgeDotDelta * edgeDotBase;
+            float c = edgeSq * (radiusSq - glm::dot(base, base)) + edgeDotBase * edgeDotBase;
+            float root;
+            if (lowestRoot(a, b, c, t, root)) {
+                float f = (edgeDotDelta * root - edgeDotBase) / edgeSq;
+                if (f >= 0.0f && f <= 1.0f) {
+                    t = root;
+                    point = p0 + edge * f;
+                    found = true;
+                }
+            }
+        }
+
+        if (!found) return false;
+        best = t;
+        glm::vec3 away = center + delta * t - point;
+        float len = glm::length(away);
+        normal = len > 1e-6f ? away / len : tri.normal;
+        return true;
+    }
+}
+
+void CollisionWorld::clear() {
+    m_Triangles.clear();
+    m_Materials.clear();
+    m_Nodes.clear();
+}
+
+void CollisionWorld::addTriangle(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, uint8_t material) {
+    glm::vec3 n = glm::cross(b - a, c - a);
+    float len = glm::length(n);
+    if (len < 1e-8f) return; // Degenerate
+    m_Triangles.push_back({a, b, c, n / len});
+    m_Materials.push_back(material);
+}
+
+void CollisionWorld::addQuad(const glm::vec3& a, const glm::vec3& b, const glm::vec3& c, const glm::vec3& d,
+                             uint8_t material) {
+    addTriangle(a, b, c, material);
+    addTriangle(a, c, d, material);
+}
+
+void CollisionWorld::addBox(const glm::vec3& min, const glm::vec3& max, uint8_t material) {
+    glm::vec3 center = (min + max) * 0.5f;
+    glm::vec3 corner[8];
+    for (int i = 0; i < 8; ++i) {
+        corner[i] = glm::vec3((i & 1) ? max.x : min.x, (i & 2) ? max.y : min.y, (i & 4) ? max.z : min.z);
+    }
+    const int faces[6][4] = {
+        {0, 2, 6, 4}, {1, 5, 7, 3},     // -X, +X
+        {0, 4, 5, 1}, {2, 3, 7, 6},     // -Y, +Y
+        {0, 1, 3, 2}, {4, 6, 7, 5}      // -Z, +Z
+    };
+    for (const auto& f : faces) {
+        const glm::vec3& a = corner[f[0]];
+        const glm::vec3& b = corner[f[1]];
+        const glm::vec3& c = corner[f[2]];
+        const glm::vec3& d = corner[f[3]];
+        // Keep the winding outward whatever the corner order above
+        glm::vec3 faceCenter = (a + b + c + d) * 0.25f;
+        if (glm::dot(glm::cross(b - a, c - a), faceCenter - center) >= 0.0f) {
+            addQuad(a, b, c, d, material);
+        } else {
+            addQuad(a, d, c, b, material);
+        }
+    }
+}
+
+void CollisionWorld::build() {
+    m_Nodes.clear();
+    if (m_Triangles.empty()) return;
+
+    uint32_t count = (uint32_t)m_Triangles.size();
+    std::vector<uint32_t> order(count);
+    std::vector<glm::vec3> centroids(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        order[i] = i;
+        centroids[i] = (m_Triangles[i].a + m_Triangles[i].b + m_Triangles[i].c) / 3.0f;
+    }
+
+    m_Nodes.reserve(count * 2);
+    Node root;
+    root.first = 0;
+    root.count = count;
+    updateBounds(root, order);
+    m_Nodes.push_back(root);
+    subdivide(0, order, centroids, 0);
+
+    // Store triangles in leaf order so each leaf reads a contiguous run
+    std::vector<Triangle> sorted(count);
+    std::vector<uint8_t> materials(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        sorted[i] = m_Triangles[order[i]];
+        materials[i] = m_Materials[order[i]];
+    }
+    m_Triangles.swap(sorted);
+    m_Materials.swap(materials);
+}
+
+void CollisionWorld::updateBounds(Node& node, const std::vector<uint32_t>& order) const {
+    node.min = glm::vec3(1e30f);
+    node.max = glm::vec3(-1e30f);
+    for (uint32_t i = 0; i < node.count; ++i) {
+        const Triangle& t = m_Triangles[order[node.first + i]];
+        node.min = glm::min(node.min, glm::min(t.a, glm::min(t.b, t.c)));
+        node.max = glm::max(node.max, glm::max(t.a, glm::max(t.b, t.c)));
+    }
+}
+
+void CollisionWorld::subdivide(uint32_t nodeIndex, std::vector<uint32_t>& order,
+                               const std::vector<glm::vec3>& centroids, uint32_t depth) {
+    uint32_t first = m_Nodes[nodeIndex].first;
+    uint32_t count = m_Nodes[nodeIndex].count;
+    // Traversal pushes at most one extra node per level
+    if (count <= MAX_LEAF_TRIANGLES || depth >= MAX_STACK_DEPTH - 2) return;
+
+    glm::vec3 cmin(1e30f), cmax(-1e30f);
+    for (uint32_t i = 0; i < count; ++i) {
+        cmin = glm::min(cmin, centroids[order[first + i]]);
+        cmax = glm::max(cmax, centroids[order[first + i]]);
+    }
+    glm::vec3 extent = cmax - cmin;
+    int axis = 0;
+    if (extent.y > extent.x) axis = 1;
+    if (extent.z > extent[axis]) axis = 2;
+
+    // Midpoint split, median when everything lands on one side
+    float split = cmin[axis] + extent[axis] * 0.5f;
+    uint32_t* begin = order.data() + first;
+    uint32_t* end = begin + count;
+    uint32_t* mid = std::partition(begin, end, [&](uint32_t t) { return centroids[t][axis] < split; });
+    if (mid == begin || mid == end) {
+        mid = begin + count / 2;
+        std::nth_element(begin, mid, end, [&](uint32_t l, uint32_t r) { return centroids[l][axis] < centroids[r][axis]; });
+    }
+    uint32_t leftCount = (uint32_t)(mid - begin);
+
+    uint32_t leftIndex = (uint32_t)m_Nodes.size();
+    Node left, right;
+    left.first = first;
+    left.count = leftCount;
+    right.first = first + leftCount;
+    right.count = count - leftCount;
+    updateBounds(left, order);
+    updateBounds(right, order);
+    m_Nodes.push_back(left);
+    m_Nodes.push_back(right);
+
+    m_Nodes[nodeIndex].first = leftIndex;
+    m_Nodes[nodeIndex].count = 0;
+
+    subdivide(leftIndex, order, centroids, depth + 1);
+    subdivide(leftIndex + 1, order, centroids, depth + 1);
+}
+
+template <typename Visitor>
+void CollisionWorld::query(const glm::vec3& boxMin, const glm::vec3& boxMax, Visitor&& visit) const {
+    if (m_Nodes.empty()) return;
+
+    uint32_t stack[MAX_STACK_DEPTH];
+    uint32_t top = 0;
+    stack[top++] = 0;
+    while (top > 0) {
+        const Node& node = m_Nodes[stack[--top]];
+        if (node.max.x < boxMin.x || node.min.x > boxMax.x ||
+            node.max.y < boxMin.y || node.min.y > boxMax.y ||
+            node.max.z < boxMin.z || node.min.z > boxMax.z) {
+            continue;
+        }
+        if (node.count > 0) {
+            for (uint32_t i = 0; i < node.count; ++i) visit(node.first + i);
+        } else {
+            stack[top++] = node.first;
+            stack[top++] = node.first + 1;
+        }
+    }
+}
+
+bool CollisionWorld::sweepSpheres(const glm::vec3* centers, uint32_t count, float radius,
+                                  const glm::vec3& delta, SweepHit& hit) const {
+    glm::vec3 boxMin(1e30f), boxMax(-1e30f);
+    for (uint32_t i = 0; i < count; ++i) {
+        boxMin = glm::min(boxMin, glm::min(centers[i], centers[i] + delta));
+        boxMax = glm::max(boxMax, glm::max(centers[i], centers[i] + delta));
+    }
+    boxMin -= glm::vec3(radius);
+    boxMax += glm::vec3(radius);
+
+    hit = SweepHit();
+    float best = 1.0f;
+    query(boxMin, boxMax, [&](uint32_t t) {
+        const Triangle& tri = m_Triangles[t];
+        for (uint32_t i = 0; i < count; ++i) {
+            glm::vec3 point, normal;
+            if (sweepSphereTriangle(tri, centers[i], radius, delta, best, point, normal)) {
+                hit.hit = true;
+                hit.fraction = best;
+                hit.point = point;
+                hit.normal = normal;
+                hit.triangle = t;
+            }
+        }
+    });
+    return hit.hit;
+}
+
+bool CollisionWorld::sweepSphere(const glm::vec3& center, float radius, const glm::vec3& delta, SweepHit& hit) const {
+    return sweepSpheres(&center, 1, radius, delta, hit);
+}
+
+uint32_t CollisionWorld::capsuleSpheres(const glm::vec3& feet, float radius, float height, glm::vec3* centers) const {
+    // Spheres one radius apart from the bottom cap to the top cap
+    float span = std::max(0.0f, height - 2.0f * radius);
+    uint32_t count = std::min(MAX_CAPSULE_SPHERES, 1u + (uint32_t)std::ceil(span / radius));
+    for (uint32_t i = 0; i < count; ++i) {
+        float h = count > 1 ? span * (float)i / (float)(count - 1) : 0.0f;
+        centers[i] = feet + glm::vec3(0.0f, radius + h, 0.0f);
+    }
+    return count;
+}
+
+bool CollisionWorld::sweepCapsule(const glm::vec3& feet, float radius, float height,
+                                  const glm::vec3& delta, SweepHit& hit) const {
+    glm::vec3 centers[MAX_CAPSULE_SPHERES];
+    uint32_t count = capsuleSpheres(feet, radius, height, centers);
+    return sweepSpheres(centers, count, radius, delta, hit);
+}
+
+bool CollisionWorld::sweepCapsuleLinear(const glm::vec3& feet, float radius, float height,
+                                        const glm::vec3& delta, SweepHit& hit) const {
+    glm::vec3 centers[MAX_CAPSULE_SPHERES];
+    uint32_t count = capsuleSpheres(feet, radius, height, centers);
+    hit = SweepHit();
+    float best = 1.0f;
+    for (uint32_t t = 0; t < m_Triangles.size(); ++t) {
+        for (uint32_t i = 0; i < count; ++i) {
+            glm::vec3 point, normal;
+            if (sweepSphereTriangle(m_Triangles[t], centers[i], radius, delta, best, point, normal)) {
+                hit.hit = true;
+                hit.fraction = best;
+                hit.point = point;
+                hit.normal = normal;
+                hit.triangle = t;
+            }
+        }
+    }
+    return hit.hit;
+}
+
+bool CollisionWorld::depenetrate(glm::vec3& feet, glm::vec3& normal, float radius, float height) const {
+    bool moved = false;
+    for (int iteration = 0; iteration < Physics::DEPENETRATION_ITERATIONS; ++iteration) {
+        glm::vec3 centers[MAX_CAPSULE_SPHERES];
+        uint32_t count = capsuleSpheres(feet, radius, height, centers);
+        glm::vec3 boxMin = feet - glm::vec3(radius, 0.0f, radius);
+        glm::vec3 boxMax = feet + glm::vec3(radius, height, radius);
+
+        // Resolve the deepest overlap, then re-query from the new position
+        float deepest = 0.0f;
+        glm::vec3 push(0.0f);
+        query(boxMin, boxMax, [&](uint32_t t) {
+            const Triangle& tri = m_Triangles[t];
+            for (uint32_t i = 0; i < count; ++i) {
+                if (glm::dot(tri.normal, centers[i] - tri.a) < 0.0f) continue; // Behind: can't be pushed through
+                glm::vec3 closest = closestPointOnTriangle(centers[i], tri);
+                glm::vec3 away = centers[i] - closest;
+                float dist = glm::length(away);
+                float depth = radius - dist;
+                if (depth <= deepest) continue;
+                deepest = depth;
+                push = dist > 1e-6f ? away / dist : tri.normal;
+            }
+        });
+        if (deepest <= 0.0f) break;
+
+        feet += push * (deepest + Physics::COLLISION_SKIN);
+        normal = push;
+        moved = true;
+    }
+    return moved;
+}
+
+bool CollisionWorld::findGround(const glm::vec3& feet, float maxDistance, SweepHit& hit,
+                                float radius, float height) const {
+    if (!sweepCapsule(feet, radius, height, glm::vec3(0.0f, -maxDistance, 0.0f), hit)) return false;
+    return hit.normal.y >= Physics::WALKABLE_NORMAL_Y;
+}
+
+bool CollisionWorld::traceGround(const glm::vec3& point, float maxDistance, GroundSample& sample) const {
+    sample = GroundSample();
+    float lowest = point.y - maxDistance;
+    glm::vec3 boxMin(point.x, lowest, point.z);
+    glm::vec3 boxMax(point.x, point.y, point.z);
+
+    query(boxMin, boxMax, [&](uint32_t t) {
+        const Triangle& tri = m_Triangles[t];
+        if (tri.normal.y <= 1e-4f) return;      // Walls and ceilings
+
+        // Inside the triangle's XZ projection (CCW seen from above)
+        auto side = [&](const glm::vec3& p0, const glm::vec3& p1) {
+            return (p1.z - p0.z) * (point.x - p0.x) - (p1.x - p0.x) * (point.z - p0.z);
+        };
+        if (side(tri.a, tri.b) < 0.0f || side(tri.b, tri.c) < 0.0f || side(tri.c, tri.a) < 0.0f) return;
+
+        // Plane height at (x, z)
+        float y = tri.a.y - (tri.normal.x * (point.x - tri.a.x) + tri.normal.z * (point.z - tri.a.z)) / tri.normal.y;
+        if (y > point.y || y < lowest || (sample.hit && y <= sample.height)) return;
+
+        sample.hit = true;
+        sample.height = y;
+        sample.normal = tri.normal;
+        sample.material = m_Materials[t];
+        sample.triangle = t;
+    });
+    return sample.hit;
+}
+
+namespace {
+    // Entry distance of a ray into an AABB, or a negative value on a miss
+    inline float rayBoxEntry(const glm::vec3& origin, const glm::vec3& invDir,
+                             const glm::vec3& boxMin, const glm::vec3& boxMax, float maxDistance) {
+        glm::vec3 t0 = (boxMin - origin) * invDir;
+        glm::vec3 t1 = (boxMax - origin) * invDir;
+        glm::vec3 tNear = glm::min(t0, t1);
+        glm::vec3 tFar = glm::max(t0, t1);
+        float enter = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, 0.0f));
+        float exit = std::min(std::min(tFar.x, tFar.y), std::min(tFar.z, maxDistance));
+        return enter <= exit ? enter : -1.0f;
+    }
+
+    // Möller-Trumbore, both faces
+    inline bool rayTriangle(const glm::vec3& origin, const glm::vec3& direction,
+                            const CollisionWorld::Triangle& tri, float& t) {
+        glm::vec3 e1 = tri.b - tri.a;
+        glm::vec3 e2 = tri.c - tri.a;
+        glm::vec3 p = glm::cross(direction, e2);
+        float det = glm::dot(e1, p);
+        if (std::fabs(det) < 1e-9f) return false;
+        float invDet = 1.0f / det;
+        glm::vec3 s = origin - tri.a;
+        float u = glm::dot(s, p) * invDet;
+        if (u < 0.0f || u > 1.0f) return false;
+        glm::vec3 q = glm::cross(s, e1);
+        float v = glm::dot(direction, q) * invDet;
+        if (v < 0.0f || u + v > 1.0f) return false;
+        t = glm::dot(e2, q) * invDet;
+        return t >= 0.0f;
+    }
+}
+
+bool CollisionWorld::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                             RayHit& hit) const {
+    hit = RayHit();
+    if (m_Nodes.empty()) return false;
+
+    // Infinite components are fine: the slab test then only uses the other axes
+    glm::vec3 invDir(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+    float best = maxDistance;
+
+    // Entry distance kept with each node: a hit found meanwhile may cull it
+    uint32_t stack[MAX_STACK_DEPTH];
+    float entry[MAX_STACK_DEPTH];
+    uint32_t top = 0;
+    float tRoot = rayBoxEntry(origin, invDir, m_Nodes[0].min, m_Nodes[0].max, best);
+    if (tRoot >= 0.0f) { stack[top] = 0; entry[top++] = tRoot; }
+    while (top > 0) {
+        --top;
+        if (entry[top] > best) continue;
+        const Node& node = m_Nodes[stack[top]];
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                float t;
+                if (!rayTriangle(origin, direction, m_Triangles[i], t) || t > best) continue;
+                best = t;
+                hit.hit = true;
+                hit.triangle = i;
+            }
+            continue;
+        }
+
+        // Push the far child first so the near one is popped next
+        const Node& left = m_Nodes[node.first];
+        const Node& right = m_Nodes[node.first + 1];
+        float tLeft = rayBoxEntry(origin, invDir, left.min, left.max, best);
+        float tRight = rayBoxEntry(origin, invDir, right.min, right.max, best);
+        bool leftFirst = tLeft <= tRight;
+        float tFar = leftFirst ? tRight : tLeft, tNear = leftFirst ? tLeft : tRight;
+        uint32_t farChild = leftFirst ? node.first + 1 : node.first;
+        uint32_t nearChild = leftFirst ? node.first : node.first + 1;
+        if (tFar >= 0.0f) { stack[top] = farChild; entry[top++] = tFar; }
+        if (tNear >= 0.0f) { stack[top] = nearChild; entry[top++] = tNear; }
+    }
+
+    if (!hit.hit) return false;
+    fillRayHit(origin, direction, hit.triangle, best, hit);
+    return true;
+}
+
+void CollisionWorld::fillRayHit(const glm::vec3& origin, const glm::vec3& direction, uint32_t triangle,
+                                float distance, RayHit& hit) const {
+    const Triangle& tri = m_Triangles[triangle];
+    hit.hit = true;
+    hit.triangle = triangle;
+    hit.distance = distance;
+    hit.point = origin + direction * distance;
+    hit.entering = glm::dot(tri.normal, direction) < 0.0f;
+    hit.normal = hit.entering ? tri.normal : -tri.normal;
+    hit.material = m_Materials[triangle];
+}
+
+uint32_t CollisionWorld::raycastAll(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                                    RayHit* hits, uint32_t maxHits) const {
+    if (m_Nodes.empty() || maxHits == 0) return 0;
+
+    // Sorted by distance; only distance and triangle until the end
+    const float SAME_HIT = 1e-4f;
+    uint32_t count = 0;
+    auto cull = [&]() { return count == maxHits ? hits[count - 1].distance : maxDistance; };
+    auto insert = [&](uint32_t triangle, float t) {
+        bool entering = glm::dot(m_Triangles[triangle].normal, direction) < 0.0f;
+        uint32_t at = count;
+        while (at > 0 && hits[at - 1].distance > t) --at;
+        // The same crossing through the other triangle of an edge
+        for (uint32_t k = at > 0 ? at - 1 : 0; k < count && hits[k].distance <= t + SAME_HIT; ++k) {
+            if (std::fabs(hits[k].distance - t) < SAME_HIT && hits[k].entering == entering) return;
+        }
+        if (at == maxHits) return;
+        for (uint32_t k = std::min(count, maxHits - 1); k > at; --k) hits[k] = hits[k - 1];
+        if (count < maxHits) ++count;
+        hits[at].distance = t;
+        hits[at].triangle = triangle;
+        hits[at].entering = entering;
+    };
+
+    glm::vec3 invDir(1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z);
+    uint32_t stack[MAX_STACK_DEPTH];
+    float entry[MAX_STACK_DEPTH];
+    uint32_t top = 0;
+    float tRoot = rayBoxEntry(origin, invDir, m_Nodes[0].min, m_Nodes[0].max, maxDistance);
+    if (tRoot >= 0.0f) { stack[top] = 0; entry[top++] = tRoot; }
+    while (top > 0) {
+        --top;
+        if (entry[top] > cull()) continue;
+        const Node& node = m_Nodes[stack[top]];
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                float t;
+                if (!rayTriangle(origin, direction, m_Triangles[i], t) || t > cull()) continue;
+                insert(i, t);
+            }
+            continue;
+        }
+
+        const Node& left = m_Nodes[node.first];
+        const Node& right = m_Nodes[node.first + 1];
+        float limit = cull();
+        float tLeft = rayBoxEntry(origin, invDir, left.min, left.max, limit);
+        float tRight = rayBoxEntry(origin, invDir, right.min, right.max, limit);
+        bool leftFirst = tLeft <= tRight;
+        float tFar = leftFirst ? tRight : tLeft, tNear = leftFirst ? tLeft : tRight;
+        uint32_t farChild = leftFirst ? node.first + 1 : node.first;
+        uint32_t nearChild = leftFirst ? node.first : node.first + 1;
+        if (tFar >= 0.0f) { stack[top] = farChild; entry[top++] = tFar; }
+        if (tNear >= 0.0f) { stack[top] = nearChild; entry[top++] = tNear; }
+    }
+
+    for (uint32_t k = 0; k < count; ++k) fillRayHit(origin, direction, hits[k].triangle, hits[k].distance, hits[k]);
+    return count;
+}
+
+uint32_t CollisionWorld::raycastPacket(const glm::vec3* origins, const glm::vec3* directions, uint32_t count,
+                                       float maxDistance, RayHit* hits) const {
+    uint32_t hitCount = 0;
+    for (uint32_t first = 0; first < count; first += MAX_PACKET_RAYS) {
+        uint32_t n = count - first < MAX_PACKET_RAYS ? count - first : MAX_PACKET_RAYS;
+#if defined(__SSE2__)
+        // A lone ray gains nothing from the packet bookkeeping
+        if (n > 1) {
+            hitCount += tracePacket(origins + first, directions + first, n, maxDistance, hits + first);
+            continue;
+        }
+#endif
+        for (uint32_t i = first; i < first + n; ++i) {
+            if (raycast(origins[i], directions[i], maxDistance, hits[i])) ++hitCount;
+        }
+    }
+    return hitCount;
+}
+
+uint32_t CollisionWorld::sweepSpherePacket(const glm::vec3* centers, const float* radii, const glm::vec3* deltas,
+                                           uint32_t count, SweepHit* hits) const {
+    uint32_t hitCount = 0;
+    for (uint32_t first = 0; first < count; first += MAX_PACKET_SPHERES) {
+        uint32_t n = count - first < MAX_PACKET_SPHERES ? count - first : MAX_PACKET_SPHERES;
+#if defined(__SSE2__)
+        if (n > 1) {
+            hitCount += sweepPacket(centers + first, radii + first, deltas + first, n, hits + first);
+            continue;
+        }
+#endif
+        for (uint32_t i = first; i < first + n; ++i) {
+            if (sweepSphere(centers[i], radii[i], deltas[i], hits[i])) ++hitCount;
+        }
+    }
+    return hitCount;
+}
+
+#if defined(__SSE2__)
+namespace {
+    const uint32_t PACKET_GROUPS = CollisionWorld::MAX_PACKET_RAYS / 4;
+    static_assert(CollisionWorld::MAX_PACKET_RAYS % 4 == 0 && CollisionWorld::MAX_PACKET_RAYS <= 32,
+                  "Ray masks are 32-bit, rays go in groups of four");
+
+    // Rays as four-wide groups; lanes past the ray count have best < 0 so
+    // no box test ever accepts them
+    struct RayPacket {
+        alignas(16) float ox[CollisionWorld::MAX_PACKET_RAYS], oy[CollisionWorld::MAX_PACKET_RAYS],
+                          oz[CollisionWorld::MAX_PACKET_RAYS];
+        alignas(16) float dx[CollisionWorld::MAX_PACKET_RAYS], dy[CollisionWorld::MAX_PACKET_RAYS],
+                          dz[CollisionWorld::MAX_PACKET_RAYS];
+        alignas(16) float ix[CollisionWorld::MAX_PACKET_RAYS], iy[CollisionWorld::MAX_PACKET_RAYS],
+                          iz[CollisionWorld::MAX_PACKET_RAYS];
+        alignas(16) float best[CollisionWorld::MAX_PACKET_RAYS];
+        alignas(16) int32_t triangle[CollisionWorld::MAX_PACKET_RAYS];     // -1 until hit
+    };
+
+    inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    // Four bits of a ray mask as a lane mask
+    inline __m128 laneMask(uint32_t bits) {
+        __m128i lanes = _mm_and_si128(_mm_set1_epi32(static_cast<int>(bits)), _mm_setr_epi32(1, 2, 4, 8));
+        return _mm_castsi128_ps(_mm_cmpgt_epi32(lanes, _mm_setzero_si128()));
+    }
+
+    // Rays of `rays` that enter the box before their current hit, and the
+    // smallest such entry (for near-first ordering)
+    inline uint32_t packetBoxTest(const RayPacket& p, uint32_t rays, const glm::vec3& boxMin,
+                                  const glm::vec3& boxMax, float& nearest) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 minX = _mm_set1_ps(boxMin.x), minY = _mm_set1_ps(boxMin.y), minZ = _mm_set1_ps(boxMin.z);
+        const __m128 maxX = _mm_set1_ps(boxMax.x), maxY = _mm_set1_ps(boxMax.y), maxZ = _mm_set1_ps(boxMax.z);
+        __m128 nearestEntry = _mm_set1_ps(std::numeric_limits<float>::infinity());
+        uint32_t result = 0;
+        for (uint32_t g = 0; g < PACKET_GROUPS; ++g) {
+            const uint32_t bits = (rays >> (4 * g)) & 0xFu;
+            if (!bits) continue;
+            const uint32_t o = 4 * g;
+            __m128 ox = _mm_load_ps(&p.ox[o]), oy = _mm_load_ps(&p.oy[o]), oz = _mm_load_ps(&p.oz[o]);
+            __m128 ix = _mm_load_ps(&p.ix[o]), iy = _mm_load_ps(&p.iy[o]), iz = _mm_load_ps(&p.iz[o]);
+            __m128 t0x = _mm_mul_ps(_mm_sub_ps(minX, ox), ix), t1x = _mm_mul_ps(_mm_sub_ps(maxX, ox), ix);
+            __m128 t0y = _mm_mul_ps(_mm_sub_ps(minY, oy), iy), t1y = _mm_mul_ps(_mm_sub_ps(maxY, oy), iy);
+            __m128 t0z = _mm_mul_ps(_mm_sub_ps(minZ, oz), iz), t1z = _mm_mul_ps(_mm_sub_ps(maxZ, oz), iz);
+            __m128 enter = _mm_max_ps(_mm_max_ps(_mm_min_ps(t0x, t1x), _mm_min_ps(t0y, t1y)),
+                                      _mm_max_ps(_mm_min_ps(t0z, t1z), zero));
+            __m128 exit = _mm_min_ps(_mm_min_ps(_mm_max_ps(t0x, t1x), _mm_max_ps(t0y, t1y)),
+                                     _mm_min_ps(_mm_max_ps(t0z, t1z), _mm_load_ps(&p.best[o])));
+            __m128 inside = _mm_and_ps(_mm_cmple_ps(enter, exit), laneMask(bits));
+            nearestEntry = _mm_min_ps(nearestEntry, select(inside, enter, nearestEntry));
+            result |= static_cast<uint32_t>(_mm_movemask_ps(inside)) << o;
+        }
+        nearestEntry = _mm_min_ps(nearestEntry, _mm_shuffle_ps(nearestEntry, nearestEntry, _MM_SHUFFLE(2, 3, 0, 1)));
+        nearestEntry = _mm_min_ps(nearestEntry, _mm_shuffle_ps(nearestEntry, nearestEntry, _MM_SHUFFLE(1, 0, 3, 2)));
+        nearest = _mm_cvtss_f32(nearestEntry);
+        return result;
+    }
+
+    // rayTriangle() for the rays of `rays`, keeping each one's nearest hit
+    inline void packetTriangleTest(RayPacket& p, uint32_t rays, const CollisionWorld::Triangle& tri, int32_t index) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 e1x = _mm_set1_ps(tri.b.x - tri.a.x), e1y = _mm_set1_ps(tri.b.y - tri.a.y),
+                     e1z = _mm_set1_ps(tri.b.z - tri.a.z);
+        const __m128 e2x = _mm_set1_ps(tri.c.x - tri.a.x), e2y = _mm_set1_ps(tri.c.y - tri.a.y),
+                     e2z = _mm_set1_ps(tri.c.z - tri.a.z);
+        const __m128 ax = _mm_set1_ps(tri.a.x), ay = _mm_set1_ps(tri.a.y), az = _mm_set1_ps(tri.a.z);
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+        const __m128i triangle = _mm_set1_epi32(index);
+        for (uint32_t g = 0; g < PACKET_GROUPS; ++g) {
+            const uint32_t bits = (rays >> (4 * g)) & 0xFu;
+            if (!bits) continue;
+            const uint32_t o = 4 * g;
+            __m128 dx = _mm_load_ps(&p.dx[o]), dy = _mm_load_ps(&p.dy[o]), dz = _mm_load_ps(&p.dz[o]);
+            // p = d x e2, det = e1 . p
+            __m128 px = _mm_sub_ps(_mm_mul_ps(dy, e2z), _mm_mul_ps(dz, e2y));
+            __m128 py = _mm_sub_ps(_mm_mul_ps(dz, e2x), _mm_mul_ps(dx, e2z));
+            __m128 pz = _mm_sub_ps(_mm_mul_ps(dx, e2y), _mm_mul_ps(dy, e2x));
+            __m128 det = _mm_add_ps(_mm_add_ps(_mm_mul_ps(e1x, px), _mm_mul_ps(e1y, py)), _mm_mul_ps(e1z, pz));
+            __m128 valid = _mm_and_ps(_mm_cmpge_ps(_mm_and_ps(det, absMask), _mm_set1_ps(1e-9f)), laneMask(bits));
+            __m128 invDet = _mm_div_ps(one, select(valid, det, one));
+            // s = o - a, u = (s . p) / det
+            __m128 sx = _mm_sub_ps(_mm_load_ps(&p.ox[o]), ax);
+            __m128 sy = _mm_sub_ps(_mm_load_ps(&p.oy[o]), ay);
+            __m128 sz = _mm_sub_ps(_mm_load_ps(&p.oz[o]), az);
+            __m128 u = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(sx, px), _mm_mul_ps(sy, py)), _mm_mul_ps(sz, pz)), invDet);
+            // q = s x e1, v = (d . q) / det, t = (e2 . q) / det
+            __m128 qx = _mm_sub_ps(_mm_mul_ps(sy, e1z), _mm_mul_ps(sz, e1y));
+            __m128 qy = _mm_sub_ps(_mm_mul_ps(sz, e1x), _mm_mul_ps(sx, e1z));
+            __m128 qz = _mm_sub_ps(_mm_mul_ps(sx, e1y), _mm_mul_ps(sy, e1x));
+            __m128 v = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, qx), _mm_mul_ps(dy, qy)), _mm_mul_ps(dz, qz)), invDet);
+            __m128 t = _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(e2x, qx), _mm_mul_ps(e2y, qy)), _mm_mul_ps(e2z, qz)), invDet);
+            __m128 best = _mm_load_ps(&p.best[o]);
+            __m128 hit = _mm_and_ps(_mm_and_ps(valid, _mm_and_ps(_mm_cmpge_ps(u, zero), _mm_cmple_ps(u, one))),
+                                    _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(v, zero), _mm_cmple_ps(_mm_add_ps(u, v), one)),
+                                               _mm_and_ps(_mm_cmpge_ps(t, zero), _mm_cmple_ps(t, best))));
+            if (!_mm_movemask_ps(hit)) continue;
+            _mm_store_ps(&p.best[o], select(hit, t, best));
+            __m128i previous = _mm_load_si128(reinterpret_cast<const __m128i*>(&p.triangle[o]));
+            __m128i hitMask = _mm_castps_si128(hit);
+            _mm_store_si128(reinterpret_cast<__m128i*>(&p.triangle[o]),
+                            _mm_or_si128(_mm_and_si128(hitMask, triangle), _mm_andnot_si128(hitMask, previous)));
+        }
+    }
+}
+
+uint32_t CollisionWorld::tracePacket(const glm::vec3* origins, const glm::vec3* directions, uint32_t count,
+                                     float maxDistance, RayHit* hits) const {
+    for (uint32_t i = 0; i < count; ++i) hits[i] = RayHit();
+    if (m_Nodes.empty() || count == 0) return 0;
+
+    RayPacket p;
+    for (uint32_t i = 0; i < MAX_PACKET_RAYS; ++i) {
+        bool live = i < count;
+        glm::vec3 o = live ? origins[i] : glm::vec3(0.0f);
+        glm::vec3 d = live ? directions[i] : glm::vec3(1.0f, 0.0f, 0.0f);
+        p.ox[i] = o.x; p.oy[i] = o.y; p.oz[i] = o.z;
+        p.dx[i] = d.x; p.dy[i] = d.y; p.dz[i] = d.z;
+        p.ix[i] = 1.0f / d.x; p.iy[i] = 1.0f / d.y; p.iz[i] = 1.0f / d.z;
+        p.best[i] = live ? maxDistance : -1.0f;
+        p.triangle[i] = -1;
+    }
+    const uint32_t allRays = count == 32 ? 0xFFFFFFFFu : (1u << count) - 1u;   // count <= MAX_PACKET_RAYS
+
+    // Each stack entry carries the rays that entered the node
+    uint32_t stack[MAX_STACK_DEPTH];
+    uint32_t stackRays[MAX_STACK_DEPTH];
+    uint32_t top = 0;
+    float nearest;
+    uint32_t rootRays = packetBoxTest(p, allRays, m_Nodes[0].min, m_Nodes[0].max, nearest);
+    if (rootRays) { stack[top] = 0; stackRays[top++] = rootRays; }
+    while (top > 0) {
+        --top;
+        const Node& node = m_Nodes[stack[top]];
+        const uint32_t rays = stackRays[top];
+        if (node.count > 0) {
+            for (uint32_t i = node.first; i < node.first + node.count; ++i) {
+                packetTriangleTest(p, rays, m_Triangles[i], static_cast<int32_t>(i));
+            }
+            continue;
+        }
+
+        // Rays that found a hit meanwhile drop out here, per ray
+        const Node& left = m_Nodes[node.first];
+        const Node& right = m_Nodes[node.first + 1];
+        float tLeft, tRight;
+        uint32_t leftRays = packetBoxTest(p, rays, left.min, left.max, tLeft);
+        uint32_t rightRays = packetBoxTest(p, rays, right.min, right.max, tRight);
+        bool leftFirst = tLeft <= tRight;
+        uint32_t farRays = leftFirst ? rightRays : leftRays, nearRays = leftFirst ? leftRays : rightRays;
+        uint32_t farChild = leftFirst ? node.first + 1 : node.first;
+        uint32_t nearChild = leftFirst ? node.first : node.first + 1;
+        if (farRays) { stack[top] = farChild; stackRays[top++] = farRays; }
+        if (nearRays) { stack[top] = nearChild; stackRays[top++] = nearRays; }
+    }
+
+    uint32_t hitCount = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (p.triangle[i] < 0) continue;
+        fillRayHit(origins[i], directions[i], static_cast<uint32_t>(p.triangle[i]), p.best[i], hits[i]);
+        ++hitCount;
+    }
+    return hitCount;
+}
+
+namespace {
+    const uint32_t SPHERE_GROUPS = CollisionWorld::MAX_PACKET_SPHERES / 4;
+    static_assert(CollisionWorld::MAX_PACKET_SPHERES % 4 == 0 && CollisionWorld::MAX_PACKET_SPHERES <= 32,
+                  "Sphere masks are 32-bit, spheres go in groups of four");
+
+    // Swept bounds of each sphere (start and end, grown by the radius) as
+    // four-wide groups; lanes past the sphere count are never in the mask
+    struct SpherePacket {
+        alignas(16) float minX[CollisionWorld::MAX_PACKET_SPHERES], minY[CollisionWorld::MAX_PACKET_SPHERES],
+                          minZ[CollisionWorld::MAX_PACKET_SPHERES];
+        alignas(16) float maxX[CollisionWorld::MAX_PACKET_SPHERES], maxY[CollisionWorld::MAX_PACKET_SPHERES],
+                          maxZ[CollisionWorld::MAX_PACKET_SPHERES];
+    };
+
+    // Spheres of `spheres` whose bounds overlap the box, with query()'s
+    // inclusive comparisons
+    inline uint32_t packetOverlap(const SpherePacket& p, uint32_t spheres, const glm::vec3& boxMin,
+                                  const glm::vec3& boxMax) {
+        const __m128 minX = _mm_set1_ps(boxMin.x), minY = _mm_set1_ps(boxMin.y), minZ = _mm_set1_ps(boxMin.z);
+        const __m128 maxX = _mm_set1_ps(boxMax.x), maxY = _mm_set1_ps(boxMax.y), maxZ = _mm_set1_ps(boxMax.z);
+        uint32_t result = 0;
+        for (uint32_t g = 0; g < SPHERE_GROUPS; ++g) {
+            const uint32_t bits = (spheres >> (4 * g)) & 0xFu;
+            if (!bits) continue;
+            const uint32_t o = 4 * g;
+            __m128 x = _mm_and_ps(_mm_cmpge_ps(maxX, _mm_load_ps(&p.minX[o])), _mm_cmple_ps(minX, _mm_load_ps(&p.maxX[o])));
+            __m128 y = _mm_and_ps(_mm_cmpge_ps(maxY, _mm_load_ps(&p.minY[o])), _mm_cmple_ps(minY, _mm_load_ps(&p.maxY[o])));
+            __m128 z = _mm_and_ps(_mm_cmpge_ps(maxZ, _mm_load_ps(&p.minZ[o])), _mm_cmple_ps(minZ, _mm_load_ps(&p.maxZ[o])));
+            __m128 overlap = _mm_and_ps(_mm_and_ps(x, y), _mm_and_ps(z, laneMask(bits)));
+            result |= static_cast<uint32_t>(_mm_movemask_ps(overlap)) << o;
+        }
+        return result;
+    }
+}
+
+uint32_t CollisionWorld::sweepPacket(const glm::vec3* centers, const float* radii, const glm::vec3* deltas,
+                                     uint32_t count, SweepHit* hits) const {
+    SpherePacket p;
+    float best[MAX_PACKET_SPHERES];
+    for (uint32_t i = 0; i < count; ++i) {
+        hits[i] = SweepHit();
+        best[i] = 1.0f;
+        glm::vec3 boxMin = glm::min(centers[i], centers[i] + deltas[i]) - glm::vec3(radii[i]);
+        glm::vec3 boxMax = glm::max(centers[i], centers[i] + deltas[i]) + glm::vec3(radii[i]);
+        p.minX[i] = boxMin.x; p.minY[i] = boxMin.y; p.minZ[i] = boxMin.z;
+        p.maxX[i] = boxMax.x; p.maxY[i] = boxMax.y; p.maxZ[i] = boxMax.z;
+    }
+    for (uint32_t i = count; i < MAX_PACKET_SPHERES; ++i) {
+        p.minX[i] = p.minY[i] = p.minZ[i] = 0.0f;
+        p.maxX[i] = p.maxY[i] = p.maxZ[i] = 0.0f;
+    }
+    if (m_Nodes.empty() || count == 0) return 0;
+    const uint32_t allSpheres = count == 32 ? 0xFFFFFFFFu : (1u << count) - 1u;   // count <= MAX_PACKET_SPHERES
+
+    // Same depth-first order as query(), each entry carrying the spheres
+    // that still overlap the node
+    uint32_t stack[MAX_STACK_DEPTH];
+    uint32_t stackSpheres[MAX_STACK_DEPTH];
+    uint32_t top = 0;
+    stack[top] = 0;
+    stackSpheres[top++] = allSpheres;
+    while (top > 0) {
+        --top;
+        const Node& node = m_Nodes[stack[top]];
+        const uint32_t spheres = packetOverlap(p, stackSpheres[top], node.min, node.max);
+        if (!spheres) continue;
+        if (node.count > 0) {
+            for (uint32_t t = node.first; t < node.first + node.count; ++t) {
+                const Triangle& tri = m_Triangles[t];
+                // Spheres whose bounds miss the triangle's can't touch it;
+                // the pad keeps rounding at a shared boundary from
+                // dropping a contact sweepSphere() would find
+                const glm::vec3 pad(1e-3f);
+                const uint32_t touching = packetOverlap(p, spheres, glm::min(glm::min(tri.a, tri.b), tri.c) - pad,
+                                                    glm::max(glm::max(tri.a, tri.b), tri.c) + pad);
+                for (uint32_t i = 0; i < count; ++i) {
+                    if (!((touching >> i) & 1u)) continue;
+                    glm::vec3 point, normal;
+                    if (sweepSphereTriangle(tri, centers[i], radii[i], deltas[i], best[i], point, normal)) {
+                        hits[i].hit = true;
+                        hits[i].fraction = best[i];
+                        hits[i].point = point;
+                        hits[i].normal = normal;
+                        hits[i].triangle = t;
+                    }
+                }
+            }
+        } else {
+            stack[top] = node.first;
+            stackSpheres[top++] = spheres;
+            stack[top] = node.first + 1;
+            stackSpheres[top++] = spheres;
+        }
+    }
+
+    uint32_t hitCount = 0;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (hits[i].hit) ++hitCount;
+    }
+    return hitCount;
+}
+#endif
+
+SlideResult CollisionWorld::moveAndSlide(const glm::vec3& feet, const glm::vec3& velocity, float deltaTime,
+                                         bool wasOnGround, float radius, float height) const {
+    using namespace Physics;
+
+    SlideResult result;
+    result.position = feet;
+    result.velocity = velocity;
+
+    glm::vec3 move = velocity * deltaTime;
+    float distance = glm::length(move);
+    if (distance < radius) {
+        // Can't cross a surface in one step: move, then push back out
+        result.position += move;
+        glm::vec3 normal;
+        if (depenetrate(result.position, normal, radius, height)) {
+            if (normal.y < WALKABLE_NORMAL_Y && normal.y > -WALKABLE_NORMAL_Y) {
+                result.hitWall = true;
+                result.wallNormal = normal;
+            }
+            float into = glm::dot(result.velocity, normal);
+            if (into < 0.0f) result.velocity -= normal * into;
+        }
+    } else {
+        int substeps = std::min(MAX_CCD_SUBSTEPS, (int)std::ceil(distance / CCD_SUBSTEP_DISTANCE));
+        float stepTime = deltaTime / (float)substeps;
+        for (int i = 0; i < substeps; ++i) {
+            // Use the slid velocity so later substeps follow the wall
+            slide(result, result.velocity * stepTime, wasOnGround, radius, height);
+        }
+    }
+
+    // Keep walking players glued to slopes and stairs going down
+    if (result.velocity.y <= 0.0f) {
+        float probeDistance = wasOnGround ? STEP_HEIGHT : GROUND_TOLERANCE;
+        SweepHit ground;
+        if (findGround(result.position, probeDistance, ground, radius, height)) {
+            result.position.y -= probeDistance * ground.fraction - COLLISION_SKIN;
+            result.onGround = true;
+            result.groundNormal = ground.normal;
+        }
+    }
+
+    return result;
+}
+
+void CollisionWorld::slide(SlideResult& result, glm::vec3 remaining, bool wasOnGround, float radius, float height) const {
+    using namespace Physics;
+
+    for (int iteration = 0; iteration < MAX_SLIDE_ITERATIONS; ++iteration) {
+        if (glm::dot(remaining, remaining) < 1e-10f) break;
+
+        SweepHit hit;
+        if (!sweepCapsule(result.position, radius, height, remaining, hit)) {
+            result.position += remaining;
+            break;
+        }
+
+        result.position += remaining * hit.fraction + hit.normal * COLLISION_SKIN;
+        remaining *= (1.0f - hit.fraction);
+
+        bool walkable = hit.normal.y >= WALKABLE_NORMAL_Y;
+        if (!walkable && wasOnGround) {
+            // Step-up: lift, move horizontally, drop back onto a walkable top
+            glm::vec3 horizontal(remaining.x, 0.0f, remaining.z);
+            glm::vec3 p = result.position;
+            float lift = STEP_HEIGHT;
+            SweepHit probe;
+            if (sweepCapsule(p, radius, height, glm::vec3(0.0f, lift, 0.0f), probe)) {
+                lift = std::max(0.0f, lift * probe.fraction - COLLISION_SKIN);
+            }
+            p.y += lift;
+
+            glm::vec3 moved = horizontal;
+            if (sweepCapsule(p, radius, height, horizontal, probe)) moved *= probe.fraction;
+            p += moved;
+
+            if (glm::dot(moved, moved) > 1e-8f &&
+                sweepCapsule(p, radius, height, glm::vec3(0.0f, -lift, 0.0f), probe) &&
+                probe.normal.y >= WALKABLE_NORMAL_Y) {
+                result.position = p + glm::vec3(0.0f, -lift * probe.fraction + COLLISION_SKIN, 0.0f);
+                result.groundNormal = probe.normal;
+                remaining = horizontal - moved;
+                continue;
+            }
+        }
+
+        if (!walkable && hit.normal.y > -WALKABLE_NORMAL_Y) {
+            result.hitWall = true;
+            result.wallNormal = hit.normal;
+        }
+
+        // Slide: drop the part of the motion going into the surface
+        remaining -= hit.normal * glm::dot(remaining, hit.normal);
+        float into = glm::dot(result.velocity, hit.normal);
+        if (into < 0.0f) result.velocity -= hit.normal * into;
+    }
+}
@@ -13,6 +13,12 @@ void FPSCamera::setPosition(const glm::vec3& pos) {
     m_Position = pos;
 }
 
+void FPSCamera::setViewAngles(float yaw, float pitch) {
+    m_Yaw = yaw;
+    m_Pitch = pitch;
+    updateVectors();
+}
+
 void FPSCamera::processMouseMovement(float xoffset, float yoffset) {
     float sensitivity = 0.1f;
     m_Yaw += xoffset * sensitivity;
@@ -0,0 +1,245 @@
+#include "glfw_input_source.h"
+
+namespace {
+    struct Binding {
+        InputAction action;
+        int code;
+        bool mouse;
+    };
+
+    const Binding BINDINGS[] = {
+        { InputAction::MOVE_FORWARD, GLFW_KEY_W, false },
+        { InputAction::MOVE_BACK,    GLFW_KEY_S, false },
+        { InputAction::MOVE_LEFT,    GLFW_KEY_A, false },
+        { InputAction::MOVE_RIGHT,   GLFW_KEY_D, false },
+        { InputAction::JUMP,         GLFW_KEY_SPACE, false },
+        { InputAction::CROUCH,       GLFW_KEY_LEFT_CONTROL, false },
+        { InputAction::FIRE,         GLFW_MOUSE_BUTTON_LEFT, true },
+        { InputAction::AIM,          GLFW_MOUSE_BUTTON_RIGHT, true },
+        { InputAction::RELOAD,       GLFW_KEY_R, false },
+        { InputAction::INSPECT,      GLFW_KEY_F, false },
+        { InputAction::SLOT_1,       GLFW_KEY_1, false },
+        { InputAction::SLOT_2,       GLFW_KEY_2, false },
+        { InputAction::SLOT_3,       GLFW_KEY_3, false },
+        { InputAction::SLOT_4,       GLFW_KEY_4, false },
+        { InputAction::SLOT_5,       GLFW_KEY_5, false },
+        { InputAction::VOLUME_UP,    GLFW_KEY_KP_ADD, false },
+        { InputAction::VOLUME_UP,    GLFW_KEY_EQUAL, false },
+        { InputAction::VOLUME_DOWN,  GLFW_KEY_KP_SUBTRACT, false },
+        { InputAction::VOLUME_DOWN,  GLFW_KEY_MINUS, false },
+        { InputAction::AUDIO_DEBUG,  GLFW_KEY_M, false },
+        { InputAction::THROW_GRENADE, GLFW_KEY_G, false },
+        { InputAction::SLOT_6,       GLFW_KEY_6, false },
+    };
+}
+
+GlfwInputSource::GlfwInputSource(GLFWwindow* window)
+    : m_Window(window) {
+    if (!m_Window) return;
+    glfwSetWindowUserPointer(m_Window, this);
+    glfwSetKeyCallback(m_Window, keyCallback);
+    glfwSetMouseButtonCallback(m_Window, mouseButtonCallback);
+    glfwSetCursorPosCallback(m_Window, cursorPosCallback);
+}
+
+void GlfwInputSource::pump(double rateHz) {
+    if (!m_Window) return;
+    double period = 1.0 / rateHz;
+    while (!glfwWindowShouldClose(m_Window)) {
+        glfwWaitEventsTimeout(period);
+        flushDeferred();
+    }
+}
+
+void GlfwInputSource::beginFrame(double sampleTime) {
+    m_SampleTime = sampleTime;
+    m_FramePresses = 0;
+
+    InputEvent event;
+    while (m_Queue.pop(event)) {
+        if (m_UnconsumedCount == 0 || event.time < m_UnconsumedOldest) m_UnconsumedOldest = event.time;
+        m_UnconsumedTimeSum += event.time;
+        m_UnconsumedCount++;
+
+        if (event.type == InputEvent::Type::MouseMove) {
+            m_MouseDX += event.dx;
+            m_MouseDY += event.dy;
+            continue;
+        }
+
+        uint32_t index = static_cast<uint32_t>(event.action);
+        uint32_t bit = 1u << index;
+        if (event.type == InputEvent::Type::Press) {
+            m_Held |= bit;
+            if (!(m_FramePresses & bit)) {      // Keep the first press of the frame
+                m_FramePresses |= bit;
+                m_FramePressTime[index] = event.time;
+            }
+        } else {
+            m_Held &= ~bit;
+        }
+    }
+}
+
+void GlfwInputSource::takeMouseDelta(float& dx, float& dy) {
+    dx = m_MouseDX;
+    dy = m_MouseDY;
+    m_MouseDX = 0.0f;
+    m_MouseDY = 0.0f;
+}
+
+void GlfwInputSource::onTickConsumed(double time) {
+    if (m_UnconsumedCount == 0) return;
+    m_LatencySum += m_UnconsumedCount * time - m_UnconsumedTimeSum;
+    double oldest = time - m_UnconsumedOldest;
+    if (oldest > m_LatencyMax) m_LatencyMax = oldest;
+    m_LatencyCount += m_UnconsumedCount;
+    m_UnconsumedCount = 0;
+    m_UnconsumedTimeSum = 0.0;
+}
+
+bool GlfwInputSource::isDown(InputAction action) const {
+    uint32_t index = static_cast<uint32_t>(action);
+    if (index >= ACTION_COUNT) return false;
+    // A tap released within the frame still counts as held once
+    return ((m_Held | m_FramePresses) >> index) & 1u;
+}
+
+float GlfwInputSource::pressAge(InputAction action) const {
+    uint32_t index = static_cast<uint32_t>(action);
+    if (index >= ACTION_COUNT || !((m_FramePresses >> index) & 1u)) return 0.0f;
+
+    double age = m_SampleTime - m_FramePressTime[index];
+    return age > 0.0 ? static_cast<float>(age) : 0.0f;
+}
+
+GlfwInputSource::LatencyStats GlfwInputSource::takeLatencyStats() {
+    LatencyStats stats;
+    stats.events = m_LatencyCount;
+    stats.queueFull = m_Queue.getFullCount();
+    if (m_LatencyCount > 0) {
+        stats.averageMs = static_cast<float>(m_LatencySum / m_LatencyCount * 1000.0);
+        stats.maxMs = static_cast<float>(m_LatencyMax * 1000.0);
+    }
+    m_LatencySum = 0.0;
+    m_LatencyMax = 0.0;
+    m_LatencyCount = 0;
+    return stats;
+}
+
+void GlfwInputSource::pushAction(InputAction action, bool pressed) {
+    // Several keys can share an action (VOLUME_UP is both + keys): only the
+    // first press and the last release change the action's state
+    uint8_t& down = m_BindingsDown[static_cast<uint32_t>(action)];
+    if (pressed) {
+        if (down++ > 0) return;
+    } else {
+        if (down > 0 && --down > 0) return;
+    }
+
+    double time = glfwGetTime();
+    uint32_t index = static_cast<uint32_t>(action);
+    flushDeferred();
+    if ((m_DeferredPress | m_DeferredRelease) & (1u << index)) {
+        deferAction(index, pressed, time);      // Behind an earlier event of the action
+        return;
+    }
+
+    InputEvent event;
+    event.type = pressed ? InputEvent::Type::Press : InputEvent::Type::Release;
+    event.action = action;
+    event.time = time;
+    if (!m_Queue.push(event)) deferAction(index, pressed, time);
+}
+
+void GlfwInputSource::deferAction(uint32_t index, bool pressed, double time) {
+    uint32_t bit = 1u << index;
+    uint32_t& same = pressed ? m_DeferredPress : m_DeferredRelease;
+    uint32_t& other = pressed ? m_DeferredRelease : m_DeferredPress;
+    if ((same & bit) && (other & bit)) {
+        // Third change while stuck: A B A ends like A, keep the first A
+        other &= ~bit;
+        return;
+    }
+    same |= bit;
+    (pressed ? m_DeferredPressTime : m_DeferredReleaseTime)[index] = time;
+    m_DeferredPressLast = pressed ? (m_DeferredPressLast | bit) : (m_DeferredPressLast & ~bit);
+}
+
+void GlfwInputSource::flushDeferred() {
+    uint32_t waiting = m_DeferredPress | m_DeferredRelease;
+    for (uint32_t index = 0; waiting != 0; ++index, waiting >>= 1) {
+        if (!(waiting & 1u)) continue;
+        uint32_t bit = 1u << index;
+        InputEvent event;
+        event.action = static_cast<InputAction>(index);
+        // Oldest first: a release that came before the pending press goes out first
+        bool releaseFirst = (m_DeferredRelease & bit) && (m_DeferredPressLast & bit);
+        for (int pass = 0; pass < 2; ++pass) {
+            bool press = (pass == 0) != releaseFirst;
+            uint32_t& deferred = press ? m_DeferredPress : m_DeferredRelease;
+            if (!(deferred & bit)) continue;
+            event.type = press ? InputEvent::Type::Press : InputEvent::Type::Release;
+            event.time = (press ? m_DeferredPressTime : m_DeferredReleaseTime)[index];
+            if (!m_Queue.push(event)) return;  // Still full, keep the rest in order
+            deferred &= ~bit;
+        }
+    }
+
+    if (m_HasDeferredMove) {
+        InputEvent event;
+        event.type = InputEvent::Type::MouseMove;
+        event.dx = m_DeferredDX;
+        event.dy = m_DeferredDY;
+        event.time = m_DeferredMoveTime;
+        if (!m_Queue.push(event, BUTTON_RESERVE)) return;
+        m_DeferredDX = 0.0f;
+        m_DeferredDY = 0.0f;
+        m_HasDeferredMove = false;
+    }
+}
+
+void GlfwInputSource::keyCallback(GLFWwindow* window, int key, int, int action, int) {
+    if (action == GLFW_REPEAT) return;
+    if (key == GLFW_KEY_ESCAPE) {
+        if (action == GLFW_PRESS) glfwSetWindowShouldClose(window, true);
+        return;
+    }
+
+    GlfwInputSource* self = static_cast<GlfwInputSource*>(glfwGetWindowUserPointer(window));
+    if (!self) return;
+    for (const Binding& binding : BINDINGS) {
+        if (!binding.mouse && binding.code == key) self->pushAction(binding.action, action == GLFW_PRESS);
+    }
+}
+
+void GlfwInputSource::mouseButtonCallback(GLFWwindow* window, int button, int action, int) {
+    GlfwInputSource* self = static_cast<GlfwInputSource*>(glfwGetWindowUserPointer(window));
+    if (!self) return;
+    for (const Binding& binding : BINDINGS) {
+        if (binding.mouse && binding.code == button) self->pushAction(binding.action, action == GLFW_PRESS);
+    }
+}
+
+void GlfwInputSource::cursorPosCallback(GLFWwindow* window, double x, double y) {
+    GlfwInputSource* self = static_cast<GlfwInputSource*>(glfwGetWindowUserPointer(window));
+    if (!self) return;
+
+    if (self->m_FirstCursor) {
+        self->m_LastCursorX = x;
+        self->m_LastCursorY = y;
+        self->m_FirstCursor = false;
+        return;
+    }
+
+    // Summed with whatever motion is still waiting, sent as one event
+    if (!self->m_HasDeferredMove) {
+        self->m_DeferredMoveTime = glfwGetTime();
+        self->m_HasDeferredMove = true;
+    }
+    self->m_DeferredDX += static_cast<float>(x - self->m_LastCursorX);
+    self->m_DeferredDY += static_cast<float>(self->m_LastCursorY - y);    // Up is positive
+    self->m_LastCursorX = x;
+    self->m_LastCursorY = y;
+    self->flushDeferred();
+}
@@ -0,0 +1,521 @@
+#include "hitscan.h"
+#include "collision_world.h"
+#include "audio_types.h"
+#include "random_stream.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // Standing player, PLAYER_HEIGHT tall, feet at the origin
+    const Hitscan::Hitbox HITBOXES[Hitscan::HITBOX_COUNT] = {
+        { HitResult::HEAD,      { 0.0f,   1.62f, 0.02f }, { 0.0f,   1.62f, 0.02f }, 0.12f },
+        { HitResult::CHEST,     { 0.0f,   1.15f, 0.0f  }, { 0.0f,   1.40f, 0.0f  }, 0.20f },
+        { HitResult::STOMACH,   { 0.0f,   0.92f, 0.0f  }, { 0.0f,   1.10f, 0.0f  }, 0.17f },
+        { HitResult::ARM_LEFT,  { -0.28f, 1.40f, 0.0f  }, { -0.30f, 0.95f, 0.05f }, 0.06f },
+        { HitResult::ARM_RIGHT, { 0.28f,  1.40f, 0.0f  }, { 0.30f,  0.95f, 0.05f }, 0.06f },
+        { HitResult::LEG_LEFT,  { -0.10f, 0.85f, 0.0f  }, { -0.10f, 0.08f, 0.0f  }, 0.09f },
+        { HitResult::LEG_RIGHT, { 0.10f,  0.85f, 0.0f  }, { 0.10f,  0.08f, 0.0f  }, 0.09f },
+    };
+    static_assert(Hitscan::HITBOX_COUNT < Hitscan::HitboxSet::LANES, "One target's hitboxes fit in one iteration");
+
+    // Per meter, relative to wood; indexed by Audio::SurfaceMaterial
+    const float MATERIAL_DENSITY[] = {
+        4.0f,   // CONCRETE
+        6.0f,   // METAL
+        1.0f,   // WOOD
+        3.0f,   // GRAVEL
+        2.0f,   // GRASS (earth)
+        0.5f,   // WATER
+        3.0f,   // SAND
+        3.0f,   // TILE
+        1.0f,   // CARPET
+        1.0f,   // SNOW
+    };
+    static_assert(sizeof(MATERIAL_DENSITY) / sizeof(MATERIAL_DENSITY[0]) ==
+                  static_cast<size_t>(Audio::SurfaceMaterial::SNOW) + 1, "One density per SurfaceMaterial");
+    const float MIN_EXIT_POWER = 0.1f;      // Fraction of its penetration a bullet needs left past a wall
+
+    const float INF = std::numeric_limits<float>::infinity();
+    const float PARALLEL_EPSILON = 1e-8f;
+
+    // Bounding sphere around the hitboxes, yaw-independent since the center
+    // is on the vertical axis
+    const float BOUND_CENTER_Y = 0.85f;
+
+    float computeBoundRadius() {
+        const glm::vec3 center(0.0f, BOUND_CENTER_Y, 0.0f);
+        float radius = 0.0f;
+        for (const Hitscan::Hitbox& box : HITBOXES) {
+            float reach = std::max(glm::length(box.a - center), glm::length(box.b - center));
+            radius = std::max(radius, reach + box.radius);
+        }
+        return radius;
+    }
+    const float BOUND_RADIUS = computeBoundRadius();
+
+    inline bool raySphere(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& center,
+                          float radius, float& t) {
+        glm::vec3 oc = origin - center;
+        float b = glm::dot(oc, direction);
+        float c = glm::dot(oc, oc) - radius * radius;
+        float h = b * b - c;
+        if (h < 0.0f) return false;
+        t = -b - std::sqrt(h);
+        return t >= 0.0f;
+    }
+
+#if defined(__SSE2__)
+    inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    struct Ray4 {
+        __m128 ox, oy, oz;
+        __m128 dx, dy, dz;
+    };
+
+    // Entry distance of the ray into four capsules, +inf where it misses.
+    // Same cases as Hitscan::rayCapsule: the body if the entry lands between
+    // the end points, else the nearer cap sphere.
+    inline __m128 rayCapsule4(const Ray4& ray, const float* ax, const float* ay, const float* az,
+                              const float* bx, const float* by, const float* bz, const float* radius) {
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 inf = _mm_set1_ps(INF);
+
+        __m128 ax4 = _mm_loadu_ps(ax), ay4 = _mm_loadu_ps(ay), az4 = _mm_loadu_ps(az);
+        __m128 bax = _mm_sub_ps(_mm_loadu_ps(bx), ax4);
+        __m128 bay = _mm_sub_ps(_mm_loadu_ps(by), ay4);
+        __m128 baz = _mm_sub_ps(_mm_loadu_ps(bz), az4);
+        __m128 oax = _mm_sub_ps(ray.ox, ax4);
+        __m128 oay = _mm_sub_ps(ray.oy, ay4);
+        __m128 oaz = _mm_sub_ps(ray.oz, az4);
+        __m128 r = _mm_loadu_ps(radius);
+        __m128 r2 = _mm_mul_ps(r, r);
+
+        auto dot = [](__m128 x0, __m128 y0, __m128 z0, __m128 x1, __m128 y1, __m128 z1) {
+            return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x0, x1), _mm_mul_ps(y0, y1)), _mm_mul_ps(z0, z1));
+        };
+        __m128 baba = dot(bax, bay, baz, bax, bay, baz);
+        __m128 bard = dot(bax, bay, baz, ray.dx, ray.dy, ray.dz);
+        __m128 baoa = dot(bax, bay, baz, oax, oay, oaz);
+        __m128 rdoa = dot(ray.dx, ray.dy, ray.dz, oax, oay, oaz);
+        __m128 oaoa = dot(oax, oay, oaz, oax, oay, oaz);
+
+        // Body: infinite cylinder, kept if the entry is between the caps
+        __m128 k2 = _mm_sub_ps(baba, _mm_mul_ps(bard, bard));
+        __m128 k1 = _mm_sub_ps(_mm_mul_ps(baba, rdoa), _mm_mul_ps(baoa, bard));
+        __m128 k0 = _mm_sub_ps(_mm_sub_ps(_mm_mul_ps(baba, oaoa), _mm_mul_ps(baoa, baoa)), _mm_mul_ps(r2, baba));
+        __m128 h = _mm_sub_ps(_mm_mul_ps(k1, k1), _mm_mul_ps(k2, k0));
+        __m128 notParallel = _mm_cmpgt_ps(k2, _mm_set1_ps(PARALLEL_EPSILON));
+        __m128 safeK2 = select(notParallel, k2, _mm_set1_ps(1.0f));
+        __m128 tBody = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(zero, k1), _mm_sqrt_ps(_mm_max_ps(h, zero))), safeK2);
+        __m128 y = _mm_add_ps(baoa, _mm_mul_ps(tBody, bard));
+        __m128 bodyHit = _mm_and_ps(_mm_and_ps(notParallel, _mm_cmpge_ps(h, zero)),
+                                    _mm_and_ps(_mm_cmpge_ps(tBody, zero),
+                                               _mm_and_ps(_mm_cmpgt_ps(y, zero), _mm_cmplt_ps(y, baba))));
+
+        // Caps: sphere at a, then at b (o - b = oa - ba)
+        __m128 hA = _mm_sub_ps(_mm_mul_ps(rdoa, rdoa), _mm_sub_ps(oaoa, r2));
+        __m128 tA = _mm_sub_ps(_mm_sub_ps(zero, rdoa), _mm_sqrt_ps(_mm_max_ps(hA, zero)));
+        tA = select(_mm_and_ps(_mm_cmpge_ps(hA, zero), _mm_cmpge_ps(tA, zero)), tA, inf);
+
+        __m128 rdob = _mm_sub_ps(rdoa, bard);
+        __m128 obob = _mm_add_ps(_mm_sub_ps(oaoa, _mm_add_ps(baoa, baoa)), baba);
+        __m128 hB = _mm_sub_ps(_mm_mul_ps(rdob, rdob), _mm_sub_ps(obob, r2));
+        __m128 tB = _mm_sub_ps(_mm_sub_ps(zero, rdob), _mm_sqrt_ps(_mm_max_ps(hB, zero)));
+        tB = select(_mm_and_ps(_mm_cmpge_ps(hB, zero), _mm_cmpge_ps(tB, zero)), tB, inf);
+
+        return select(bodyHit, tBody, _mm_min_ps(tA, tB));
+    }
+
+    inline float horizontalMin(__m128 v) {
+        v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 3, 0, 1)));
+        v = _mm_min_ps(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)));
+        return _mm_cvtss_f32(v);
+    }
+#endif
+}
+
+namespace Hitscan {
+
+const Hitbox* getHitboxes() {
+    return HITBOXES;
+}
+
+float getMaterialDensity(uint8_t material) {
+    const size_t count = sizeof(MATERIAL_DENSITY) / sizeof(MATERIAL_DENSITY[0]);
+    return material < count ? MATERIAL_DENSITY[material] : MATERIAL_DENSITY[0];
+}
+
+bool rayCapsule(const glm::vec3& origin, const glm::vec3& direction, const glm::vec3& a,
+                const glm::vec3& b, float radius, float& t, glm::vec3& normal) {
+    glm::vec3 ba = b - a;
+    float baba = glm::dot(ba, ba);
+    if (baba < PARALLEL_EPSILON) {
+        if (!raySphere(origin, direction, a, radius, t)) return false;
+        normal = (origin + direction * t - a) / radius;
+        return true;
+    }
+
+    // Cylinder body first, then whichever cap the ray reaches
+    glm::vec3 oa = origin - a;
+    float bard = glm::dot(ba, direction);
+    float baoa = glm::dot(ba, oa);
+    float rdoa = glm::dot(direction, oa);
+    float oaoa = glm::dot(oa, oa);
+    float k2 = baba - bard * bard;
+    float k1 = baba * rdoa - baoa * bard;
+    float k0 = baba * oaoa - baoa * baoa - radius * radius * baba;
+    float h = k1 * k1 - k2 * k0;
+    if (h < 0.0f) return false;
+
+    bool found = false;
+    if (k2 > PARALLEL_EPSILON) {
+        float tBody = (-k1 - std::sqrt(h)) / k2;
+        float y = baoa + tBody * bard;
+        if (tBody >= 0.0f && y > 0.0f && y < baba) {
+            t = tBody;
+            found = true;
+        }
+    }
+    if (!found) {
+        float tA, tB;
+        bool hitA = raySphere(origin, direction, a, radius, tA);
+        bool hitB = raySphere(origin, direction, b, radius, tB);
+        if (!hitA && !hitB) return false;
+        t = hitA && (!hitB || tA < tB) ? tA : tB;
+    }
+
+    glm::vec3 p = origin + direction * t;
+    float s = std::max(0.0f, std::min(1.0f, glm::dot(p - a, ba) / baba));
+    normal = (p - (a + ba * s)) / radius;
+    return true;
+}
+
+// ============================================================================
+// HitboxSet
+// ============================================================================
+
+void HitboxSet::build(const Target* targets, uint32_t count) {
+    const size_t slots = static_cast<size_t>(count) * LANES;
+    m_AX.assign(slots, 0.0f); m_AY.assign(slots, 0.0f); m_AZ.assign(slots, 0.0f);
+    m_BX.assign(slots, 0.0f); m_BY.assign(slots, 0.0f); m_BZ.assign(slots, 0.0f);
+    m_Radius.assign(slots, 0.0f);
+    m_Ids.resize(count);
+    const size_t padded = (count + 3u) & ~3u;
+    m_CX.assign(padded, 0.0f); m_CY.assign(padded, 0.0f); m_CZ.assign(padded, 0.0f);
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const Target& target = targets[i];
+        m_Ids[i] = target.id;
+        m_CX[i] = target.feet.x;
+        m_CY[i] = target.feet.y + BOUND_CENTER_Y;
+        m_CZ[i] = target.feet.z;
+
+        float yaw = glm::radians(target.yaw);
+        glm::vec3 forward(std::cos(yaw), 0.0f, std::sin(yaw));
+        glm::vec3 right(-forward.z, 0.0f, forward.x);
+        auto toWorld = [&](const glm::vec3& local) {
+            return target.feet + right * local.x + glm::vec3(0.0f, local.y, 0.0f) + forward * local.z;
+        };
+
+        for (uint32_t h = 0; h < HITBOX_COUNT; ++h) {
+            size_t slot = static_cast<size_t>(i) * LANES + h;
+            glm::vec3 a = toWorld(HITBOXES[h].a), b = toWorld(HITBOXES[h].b);
+            m_AX[slot] = a.x; m_AY[slot] = a.y; m_AZ[slot] = a.z;
+            m_BX[slot] = b.x; m_BY[slot] = b.y; m_BZ[slot] = b.z;
+            m_Radius[slot] = HITBOXES[h].radius;
+        }
+        // Padding slots stay zero-sized at the origin and are masked out by the kernel
+    }
+}
+
+void HitboxSet::clear() {
+    m_AX.clear(); m_AY.clear(); m_AZ.clear();
+    m_BX.clear(); m_BY.clear(); m_BZ.clear();
+    m_Radius.clear();
+    m_Ids.clear();
+    m_CX.clear(); m_CY.clear(); m_CZ.clear();
+}
+
+bool HitboxSet::enterBounds(uint32_t target, const glm::vec3& origin, const glm::vec3& direction,
+                            float maxDistance, float& skip) const {
+    glm::vec3 oc = origin - glm::vec3(m_CX[target], m_CY[target], m_CZ[target]);
+    float b = glm::dot(oc, direction);
+    float c = glm::dot(oc, oc) - BOUND_RADIUS * BOUND_RADIUS;
+    skip = 0.0f;
+    if (c <= 0.0f) return true;                 // Origin inside the sphere
+    float h = b * b - c;
+    if (b > 0.0f || h < 0.0f) return false;
+    // Closest approach minus the radius: no hitbox is entered before it
+    skip = std::max(0.0f, -b - BOUND_RADIUS);
+    return -b - std::sqrt(h) < maxDistance;
+}
+
+void HitboxSet::fillHit(uint32_t slot, const glm::vec3& origin, const glm::vec3& direction, float t,
+                        HitResult& result) const {
+    glm::vec3 a(m_AX[slot], m_AY[slot], m_AZ[slot]);
+    glm::vec3 ba = glm::vec3(m_BX[slot], m_BY[slot], m_BZ[slot]) - a;
+    glm::vec3 p = origin + direction * t;
+    float baba = glm::dot(ba, ba);
+    float s = baba > PARALLEL_EPSILON ? std::max(0.0f, std::min(1.0f, glm::dot(p - a, ba) / baba)) : 0.0f;
+
+    result.hit = true;
+    result.hitPoint = p;
+    result.hitNormal = (p - (a + ba * s)) / m_Radius[slot];
+    result.distance = t;
+    result.material = 0;
+    result.hitLocation = HITBOXES[slot % LANES].location;
+    result.isHeadshot = result.hitLocation == HitResult::HEAD;
+    result.targetId = m_Ids[slot / LANES];
+}
+
+bool HitboxSet::raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                        int ignoreId, HitResult& result) const {
+#if defined(__SSE2__)
+    Ray4 ray;
+    ray.dx = _mm_set1_ps(direction.x); ray.dy = _mm_set1_ps(direction.y); ray.dz = _mm_set1_ps(direction.z);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 inf = _mm_set1_ps(INF);
+    const __m128 boundRadius = _mm_set1_ps(BOUND_RADIUS);
+    const __m128 boundRadius2 = _mm_set1_ps(BOUND_RADIUS * BOUND_RADIUS);
+    const __m128 ox = _mm_set1_ps(origin.x), oy = _mm_set1_ps(origin.y), oz = _mm_set1_ps(origin.z);
+    // Lanes HITBOX_COUNT..LANES-1 of the upper half are padding
+    const __m128 padding = _mm_castsi128_ps(_mm_setr_epi32(0, 0, 0, -1));
+    static_assert(HitboxSet::LANES == 8 && HITBOX_COUNT == 7, "Padding mask assumes 7 hitboxes in 8 lanes");
+
+    float best = maxDistance;
+    uint32_t bestSlot = 0;
+    bool found = false;
+    const uint32_t count = size();
+    for (uint32_t base = 0; base < count; base += 4) {
+        // Same test as enterBounds(), for four targets
+        __m128 ocx = _mm_sub_ps(ox, _mm_loadu_ps(&m_CX[base]));
+        __m128 ocy = _mm_sub_ps(oy, _mm_loadu_ps(&m_CY[base]));
+        __m128 ocz = _mm_sub_ps(oz, _mm_loadu_ps(&m_CZ[base]));
+        __m128 b = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, ray.dx), _mm_mul_ps(ocy, ray.dy)), _mm_mul_ps(ocz, ray.dz));
+        __m128 c = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, ocx), _mm_mul_ps(ocy, ocy)), _mm_mul_ps(ocz, ocz)),
+                              boundRadius2);
+        __m128 h = _mm_sub_ps(_mm_mul_ps(b, b), c);
+        __m128 entry = _mm_sub_ps(_mm_sub_ps(zero, b), _mm_sqrt_ps(_mm_max_ps(h, zero)));
+        __m128 inside = _mm_cmple_ps(c, zero);
+        __m128 ahead = _mm_and_ps(_mm_and_ps(_mm_cmple_ps(b, zero), _mm_cmpge_ps(h, zero)),
+                                  _mm_cmplt_ps(entry, _mm_set1_ps(best)));
+        int candidates = _mm_movemask_ps(_mm_or_ps(inside, ahead));
+        if (count - base < 4) candidates &= (1 << (count - base)) - 1;
+        if (!candidates) continue;
+
+        alignas(16) float skips[4];
+        _mm_store_ps(skips, select(inside, zero, _mm_max_ps(zero, _mm_sub_ps(_mm_sub_ps(zero, b), boundRadius))));
+
+        for (uint32_t k = 0; k < 4; ++k) {
+            if (!(candidates & (1 << k))) continue;
+            const uint32_t i = base + k;
+            if (m_Ids[i] == ignoreId) continue;
+
+            glm::vec3 start = origin + direction * skips[k];
+            ray.ox = _mm_set1_ps(start.x); ray.oy = _mm_set1_ps(start.y); ray.oz = _mm_set1_ps(start.z);
+            const size_t lo = static_cast<size_t>(i) * LANES, hi = lo + 4;
+            __m128 tLo = rayCapsule4(ray, &m_AX[lo], &m_AY[lo], &m_AZ[lo], &m_BX[lo], &m_BY[lo], &m_BZ[lo], &m_Radius[lo]);
+            __m128 tHi = rayCapsule4(ray, &m_AX[hi], &m_AY[hi], &m_AZ[hi], &m_BX[hi], &m_BY[hi], &m_BZ[hi], &m_Radius[hi]);
+            tHi = select(padding, inf, tHi);
+
+            float nearestT = horizontalMin(_mm_min_ps(tLo, tHi));
+            float t = skips[k] + nearestT;
+            if (t >= best) continue;
+
+            __m128 nearest = _mm_set1_ps(nearestT);
+            int lanes = _mm_movemask_ps(_mm_cmpeq_ps(tLo, nearest)) | (_mm_movemask_ps(_mm_cmpeq_ps(tHi, nearest)) << 4);
+            uint32_t lane = 0;
+            while (!(lanes & (1 << lane))) ++lane;
+
+            best = t;
+            bestSlot = static_cast<uint32_t>(lo) + lane;
+            found = true;
+        }
+    }
+
+    if (found) fillHit(bestSlot, origin, direction, best, result);
+    return found;
+#else
+    return raycastScalar(origin, direction, maxDistance, ignoreId, result);
+#endif
+}
+
+bool HitboxSet::raycastScalar(const glm::vec3& origin, const glm::vec3& direction, float maxDistance,
+                              int ignoreId, HitResult& result) const {
+    float best = maxDistance;
+    uint32_t bestSlot = 0;
+    bool found = false;
+    const uint32_t count = size();
+    for (uint32_t i = 0; i < count; ++i) {
+        float skip;
+        if (m_Ids[i] == ignoreId || !enterBounds(i, origin, direction, best, skip)) continue;
+
+        glm::vec3 start = origin + direction * skip;
+        for (uint32_t h = 0; h < HITBOX_COUNT; ++h) {
+            uint32_t slot = i * LANES + h;
+            float t;
+            glm::vec3 normal;
+            if (!rayCapsule(start, direction, glm::vec3(m_AX[slot], m_AY[slot], m_AZ[slot]),
+                            glm::vec3(m_BX[slot], m_BY[slot], m_BZ[slot]), m_Radius[slot], t, normal)) {
+                continue;
+            }
+            t += skip;
+            if (t >= best) continue;
+            best = t;
+            bestSlot = slot;
+            found = true;
+        }
+    }
+
+    if (found) fillHit(bestSlot, origin, direction, best, result);
+    return found;
+}
+
+// ============================================================================
+// Trace
+// ============================================================================
+
+namespace {
+    void setWallHit(HitResult& result, const RayHit& wall) {
+        result.hit = true;
+        result.hitPoint = wall.point;
+        result.hitNormal = wall.normal;
+        result.distance = wall.distance;
+        result.material = wall.material;
+    }
+
+    // Players between `start` and `end` along the ray; distances stay
+    // measured from the real origin
+    bool hitboxesBetween(const Hitscan::HitboxSet* hitboxes, const glm::vec3& origin, const glm::vec3& direction,
+                         float start, float end, int ignoreId, HitResult& result) {
+        if (!hitboxes || end <= start) return false;
+        if (!hitboxes->raycast(origin + direction * start, direction, end - start, ignoreId, result)) return false;
+        result.distance += start;
+        return true;
+    }
+
+    HitResult tracePenetrating(const CollisionWorld* world, const Hitscan::HitboxSet* hitboxes,
+                               const glm::vec3& origin, const glm::vec3& direction, float maxRange,
+                               int ignoreId, float penetration) {
+        HitResult result;
+        RayHit surfaces[Hitscan::MAX_SURFACES];
+        const uint32_t count = world ? world->raycastAll(origin, direction, maxRange, surfaces, Hitscan::MAX_SURFACES) : 0;
+
+        float power = penetration;
+        float start = 0.0f;
+        uint32_t k = 0;
+        for (;;) {
+            // A full list may have dropped farther walls: nothing is assumed past it
+            float wallDistance = k < count ? surfaces[k].distance
+                                           : count == Hitscan::MAX_SURFACES ? start : maxRange;
+            if (hitboxesBetween(hitboxes, origin, direction, start, wallDistance, ignoreId, result)) break;
+            if (k == count) break;
+
+            const RayHit& wall = surfaces[k];
+            if (!wall.entering) {               // Leaving a solid the shot started in
+                start = wall.distance;
+                ++k;
+                continue;
+            }
+
+            // Thickness up to the next exit; open geometry (no exit) can't be crossed
+            uint32_t exit = k + 1;
+            while (exit < count && surfaces[exit].entering) ++exit;
+            float cost = exit < count
+                ? (surfaces[exit].distance - wall.distance) * Hitscan::getMaterialDensity(wall.material)
+                : INF;
+            if (power - cost < penetration * MIN_EXIT_POWER) {
+                setWallHit(result, wall);
+                break;
+            }
+
+            power -= cost;
+            ++result.penetrations;
+            start = surfaces[exit].distance;
+            k = exit + 1;
+        }
+
+        result.damageScale = power / penetration;
+        return result;
+    }
+}
+
+HitResult trace(const CollisionWorld* world, const HitboxSet* hitboxes, const glm::vec3& origin,
+                const glm::vec3& direction, float maxRange, int ignoreId, float penetration) {
+    if (penetration > 0.0f) {
+        return tracePenetrating(world, hitboxes, origin, direction, maxRange, ignoreId, penetration);
+    }
+
+    HitResult result;
+    float best = maxRange;
+
+    RayHit wall;
+    if (world && world->raycast(origin, direction, maxRange, wall)) {
+        best = wall.distance;
+        setWallHit(result, wall);
+    }
+
+    if (hitboxes) hitboxes->raycast(origin, direction, best, ignoreId, result);
+    return result;
+}
+
+void tracePacket(const CollisionWorld* world, const HitboxSet* hitboxes, const glm::vec3* origins,
+                 const glm::vec3* directions, uint32_t count, float maxRange, int ignoreId,
+                 HitResult* results) {
+    RayHit walls[CollisionWorld::MAX_PACKET_RAYS];
+    for (uint32_t first = 0; first < count; first += CollisionWorld::MAX_PACKET_RAYS) {
+        const uint32_t n = count - first < CollisionWorld::MAX_PACKET_RAYS ? count - first
+                                                                           : CollisionWorld::MAX_PACKET_RAYS;
+        if (world) world->raycastPacket(origins + first, directions + first, n, maxRange, walls);
+
+        for (uint32_t i = 0; i < n; ++i) {
+            HitResult& result = results[first + i];
+            result = HitResult();
+            float best = maxRange;
+            if (world && walls[i].hit) {
+                best = walls[i].distance;
+                setWallHit(result, walls[i]);
+            }
+            if (hitboxes) hitboxes->raycast(origins[first + i], directions[first + i], best, ignoreId, result);
+        }
+    }
+}
+
+// ============================================================================
+// Spread
+// ============================================================================
+
+float shotSpread(const Weapons::WeaponStats& stats, float speedFraction, bool airborne,
+                 float adsProgress, float recoil) {
+    float spread = stats.baseSpread;
+    if (speedFraction > 0.0f) spread += stats.movingSpread * speedFraction;
+    if (airborne) spread += stats.jumpingSpread;
+    spread *= (1.0f - stats.adsSpreadReduction * adsProgress);
+    spread += recoil * 0.01f;
+    return std::max(0.0f, spread);
+}
+
+glm::vec3 spreadDirection(const glm::vec3& direction, float spreadDegrees, RandomStream& random) {
+    if (spreadDegrees <= 0.0f) return direction;
+
+    float spreadRad = glm::radians(spreadDegrees);
+    float angle = random.range(0.0f, 2.0f * 3.14159265359f);
+    float radius = std::sqrt(random.nextFloat()) * spreadRad;      // sqrt for uniform distribution
+
+    glm::vec3 up = std::abs(direction.y) < 0.9f ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0);
+    glm::vec3 right = glm::normalize(glm::cross(direction, up));
+    up = glm::normalize(glm::cross(right, direction));
+
+    glm::vec3 offset = right * (std::cos(angle) * radius) + up * (std::sin(angle) * radius);
+    return glm::normalize(direction + offset);
+}
+
+}
@@ -0,0 +1,158 @@
+#include "input_recording.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+static_assert(sizeof(RecordedFrame) == 20, "RecordedFrame is written to disk as-is");
+
+namespace {
+    // FNV-1a over raw bytes, so any bit of drift changes the hash
+    uint64_t hashBytes(uint64_t hash, const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    template <typename T>
+    void writeValue(std::ofstream& out, const T& value) {
+        out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+    }
+
+    template <typename T>
+    bool readValue(std::ifstream& in, T& value) {
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+    }
+}
+
+void InputRecording::begin(const PlayerController& player) {
+    m_StartPosition = player.getPosition();
+    m_StartYaw = player.getYaw();
+    m_StartPitch = player.getPitch();
+    m_Checksum = 0;
+    m_Frames.clear();
+}
+
+void InputRecording::addFrame(float deltaTime, const InputSource& input, const PlayerController& player) {
+    StateInputSource buttons;
+    buttons.capture(input);
+
+    RecordedFrame frame;
+    frame.deltaTime = deltaTime;
+    frame.buttons = buttons.getMask();
+    frame.yaw = player.getYaw();
+    frame.pitch = player.getPitch();
+    frame.jumpAge = buttons.pressAge(InputAction::JUMP);
+    m_Frames.push_back(frame);
+}
+
+void InputRecording::finish(const PlayerController& player) {
+    m_Checksum = checksum(player);
+}
+
+uint64_t InputRecording::checksum(const PlayerController& player) {
+    const MovementState& state = player.getMovementState();
+    uint32_t tick = player.getTick();
+    uint8_t onGround = state.onGround ? 1 : 0;
+
+    uint64_t hash = 14695981039346656037ull;
+    hash = hashBytes(hash, &tick, sizeof(tick));
+    hash = hashBytes(hash, &state.position, sizeof(state.position));
+    hash = hashBytes(hash, &state.velocity, sizeof(state.velocity));
+    hash = hashBytes(hash, &onGround, sizeof(onGround));
+    hash = hashBytes(hash, &state.consecutiveHops, sizeof(state.consecutiveHops));
+    return hash;
+}
+
+bool InputRecording::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        std::cerr << "Failed to open recording for writing: " << path << std::endl;
+        return false;
+    }
+
+    uint32_t magic = MAGIC;
+    uint16_t version = VERSION, reserved = 0;
+    uint32_t frameCount = static_cast<uint32_t>(m_Frames.size());
+    writeValue(out, magic);
+    writeValue(out, version);
+    writeValue(out, reserved);
+    writeValue(out, frameCount);
+    writeValue(out, m_StartPosition);
+    writeValue(out, m_StartYaw);
+    writeValue(out, m_StartPitch);
+    writeValue(out, m_Checksum);
+    out.write(reinterpret_cast<const char*>(m_Frames.data()), m_Frames.size() * sizeof(RecordedFrame));
+    return static_cast<bool>(out);
+}
+
+bool InputRecording::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Failed to open recording: " << path << std::endl;
+        return false;
+    }
+
+    uint32_t magic = 0, frameCount = 0;
+    uint16_t version = 0, reserved = 0;
+    if (!readValue(in, magic) || !readValue(in, version) || !readValue(in, reserved) ||
+        magic != MAGIC || version != VERSION) {
+        std::cerr << "Not a TrueShot input recording (or wrong version): " << path << std::endl;
+        return false;
+    }
+    if (!readValue(in, frameCount) || !readValue(in, m_StartPosition) || !readValue(in, m_StartYaw) ||
+        !readValue(in, m_StartPitch) || !readValue(in, m_Checksum)) {
+        std::cerr << "Truncated recording header: " << path << std::endl;
+        return false;
+    }
+
+    m_Frames.resize(frameCount);
+    if (!in.read(reinterpret_cast<char*>(m_Frames.data()), frameCount * sizeof(RecordedFrame))) {
+        std::cerr << "Truncated recording: " << path << std::endl;
+        m_Frames.clear();
+        return false;
+    }
+    return true;
+}
+
+void InputRecording::replayPass(PlayerController& player) const {
+    StateInputSource buttons;
+    for (const RecordedFrame& frame : m_Frames) {
+        buttons.setMask(frame.buttons);
+        buttons.setPressAge(InputAction::JUMP, frame.jumpAge);
+        player.setViewAngles(frame.yaw, frame.pitch);
+        player.processInput(buttons, frame.deltaTime);
+        player.update(frame.deltaTime);
+    }
+}
+
+ReplayResult InputRecording::replay(const CollisionWorld* world, int passes) const {
+    ReplayResult result;
+    double bestNs = 0.0;
+
+    for (int pass = 0; pass < passes; ++pass) {
+        // Headless: no camera, no audio, same start as the live session
+        PlayerController player;
+        player.setCollisionWorld(world);
+        player.setPosition(m_StartPosition);
+        player.setViewAngles(m_StartYaw, m_StartPitch);
+        player.setReplaying(true);
+
+        auto start = std::chrono::steady_clock::now();
+        replayPass(player);
+        auto end = std::chrono::steady_clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(end - start).count();
+        if (pass == 0 || ns < bestNs) bestNs = ns;
+
+        result.ticks = player.getTick();
+        result.checksum = checksum(player);
+    }
+
+    result.checksumMatch = result.checksum == m_Checksum;
+    result.nsPerTick = result.ticks > 0 ? bestNs / result.ticks : 0.0;
+    return result;
+}
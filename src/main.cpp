@@ -4,8 +4,18 @@
 #include "weapon_system.h"
 #include "physics_types.h"
 #include "audio_system.h"
-
+#include "glfw_input_source.h"
+#include "collision_world.h"
+#include "input_recording.h"
+#include "projectile_system.h"
+#include "telemetry.h"
+#include "arena.h"
+
+#include <atomic>
+#include <cstring>
 #include <iostream>
+#include <string>
+#include <thread>
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 #include <glm/glm.hpp>
@@ -23,58 +33,48 @@ AudioSystem* gAudioSystem = nullptr;
 FPSCamera* gCamera = nullptr;
 PlayerController* gPlayerController = nullptr;
 WeaponSystem* gWeaponSystem = nullptr;
+GlfwInputSource* gInputSource = nullptr;
+ProjectileSystem* gProjectiles = nullptr;
 
-// Mouse state
-bool firstMouse = true;
-float lastX = SCR_WIDTH / 2.0f;
-float lastY = SCR_HEIGHT / 2.0f;
+// Framebuffer size, written by the window thread, applied by the game thread
+std::atomic<int> gFramebufferWidth{SCR_WIDTH};
+std::atomic<int> gFramebufferHeight{SCR_HEIGHT};
 
-// GLFW callbacks
+// GLFW callbacks (window thread; keys and mouse go through GlfwInputSource)
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
-    glViewport(0, 0, width, height);
-}
-
-void mouse_callback(GLFWwindow* window, double xpos, double ypos) {
-    if (firstMouse) {
-        lastX = (float)xpos;
-        lastY = (float)ypos;
-        firstMouse = false;
-        return;
-    }
-    
-    float xoffset = (float)xpos - lastX;
-    float yoffset = lastY - (float)ypos; // inversé : le haut c'est positif
-
-    lastX = (float)xpos;
-    lastY = (float)ypos;
-
-    if (gPlayerController) {
-        gPlayerController->processMouseInput(xoffset, yoffset);
-    }
+    gFramebufferWidth = width;
+    gFramebufferHeight = height;
 }
 
-void processInput(GLFWwindow* window, float deltaTime) {
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-        glfwSetWindowShouldClose(window, true);
-
+void processInput(float deltaTime) {
     // Player movement
-    if (gPlayerController)
-        gPlayerController->processInput(window, deltaTime);
+    if (gPlayerController && gInputSource)
+        gPlayerController->processInput(*gInputSource, deltaTime);
     
     // Weapon input
     if (gWeaponSystem)
-        gWeaponSystem->processInput(window, deltaTime);
+        gWeaponSystem->processInput(*gInputSource, deltaTime);
+
+    // Grenade throw, from the eye along the view
+    if (gProjectiles && gPlayerController && gInputSource) {
+        static bool throwPressed = false;
+        bool currentThrow = gInputSource->isDown(InputAction::THROW_GRENADE);
+        if (currentThrow && !throwPressed) {
+            glm::vec3 forward = gPlayerController->getViewForward();
+            glm::vec3 velocity = forward * Physics::GRENADE_THROW_SPEED + gPlayerController->getVelocity();
+            gProjectiles->spawn(ProjectileKind::HE_GRENADE, gPlayerController->getPosition() + forward * 0.5f, velocity);
+        }
+        throwPressed = currentThrow;
+    }
 
     // Audio controls
-    if (gAudioSystem) {
+    if (gAudioSystem && gInputSource) {
         static bool plusPressed = false, minusPressed = false;
         static bool mPressed = false, nPressed = false;
         
         // Volume control
-        bool currentPlus = glfwGetKey(window, GLFW_KEY_KP_ADD) == GLFW_PRESS || 
-                          glfwGetKey(window, GLFW_KEY_EQUAL) == GLFW_PRESS;
-        bool currentMinus = glfwGetKey(window, GLFW_KEY_KP_SUBTRACT) == GLFW_PRESS || 
-                           glfwGetKey(window, GLFW_KEY_MINUS) == GLFW_PRESS;
+        bool currentPlus = gInputSource->isDown(InputAction::VOLUME_UP);
+        bool currentMinus = gInputSource->isDown(InputAction::VOLUME_DOWN);
         
         if (currentPlus && !plusPressed) {
             float vol = std::min(1.0f, gAudioSystem->getMasterVolume() + 0.1f);
@@ -88,7 +88,7 @@ void processInput(GLFWwindow* window, float deltaTime) {
         }
         
         // Debug toggle
-        bool currentM = glfwGetKey(window, GLFW_KEY_M) == GLFW_PRESS;
+        bool currentM = gInputSource->isDown(InputAction::AUDIO_DEBUG);
         if (currentM && !mPressed) {
             gAudioSystem->toggleDebugVisualization();
         }
@@ -99,7 +99,7 @@ void processInput(GLFWwindow* window, float deltaTime) {
     }
 }
 
-void printDebugInfo(const PlayerController* controller, const WeaponSystem* weapons) {
+void printDebugInfo(const PlayerController* controller, const WeaponSystem* weapons, GlfwInputSource* input) {
     static float debugTimer = 0.0f;
     static float debugInterval = 2.0f; // Print every 2 seconds
     
@@ -116,6 +116,17 @@ void printDebugInfo(const PlayerController* controller, const WeaponSystem* weap
         std::cout << "  Max Speed: " << (int)movement.maxSpeed << " units/sec" << std::endl;
         std::cout << "  Bhop Combo: " << movement.consecutiveHops << std::endl;
         std::cout << "  On Ground: " << (movement.onGround ? "YES" : "NO") << std::endl;
+        std::cout << "  Dropped Sim Time: " << (int)(controller->getDroppedTime() * 1000.0f) << " ms" << std::endl;
+        
+        // Input latency: window event to the tick that used it
+        if (input) {
+            GlfwInputSource::LatencyStats latency = input->takeLatencyStats();
+            std::cout << "INPUT:" << std::endl;
+            std::cout << "  Latency: " << latency.averageMs << " ms avg, " << latency.maxMs << " ms max ("
+                      << latency.events << " events)" << std::endl;
+            if (latency.queueFull > 0)
+                std::cout << "  Queue Full (held back): " << latency.queueFull << std::endl;
+        }
         
         // Weapon info
         if (weapons && weapons->getCurrentWeapon()) {
@@ -147,12 +158,13 @@ void printControls() {
     std::cout << "  Mouse1 - Fire" << std::endl;
     std::cout << "  Mouse2 - Aim Down Sights (ADS)" << std::endl;
     std::cout << "  R - Reload" << std::endl;
-    std::cout << "  1-5 - Switch weapons:" << std::endl;
+    std::cout << "  1-6 - Switch weapons:" << std::endl;
     std::cout << "    1 - Glock-18" << std::endl;
     std::cout << "    2 - Desert Eagle" << std::endl;
     std::cout << "    3 - AK-47" << std::endl;
     std::cout << "    4 - M4A4" << std::endl;
     std::cout << "    5 - AWP" << std::endl;
+    std::cout << "    6 - Nova" << std::endl;
 
     std::cout << "\nAUDIO CONTROLS:" << std::endl;
     std::cout << "  + / - - Master volume" << std::endl;
@@ -170,7 +182,15 @@ void printControls() {
     std::cout << "==============================\n" << std::endl;
 }
 
-int main() {
+int main(int argc, char** argv) {
+    // --record <file> captures this session for replay (trueshot_bench replay)
+    std::string recordPath;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        }
+    }
+
     // Print controls first
     printControls();
     
@@ -198,10 +218,12 @@ int main() {
         return -1;
     }
 
+    // Gameplay logs go through the telemetry ring, drained off the main thread
+    Telemetry::start();
+
     // Viewport et callbacks
     glViewport(0, 0, SCR_WIDTH, SCR_HEIGHT);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
-    glfwSetCursorPosCallback(window, mouse_callback);
     glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
 
     // OpenGL options
@@ -210,14 +232,26 @@ int main() {
     // Création de la caméra et du controller
     FPSCamera camera(glm::vec3(0.0f, Physics::PLAYER_HEIGHT, 3.0f));
     PlayerController playerController(&camera);
-    WeaponSystem weaponSystem(&camera, &playerController);
+
+    // Weapon definitions, loaded once for the whole game: the compiled blob,
+    // else the text it is built from
+    WeaponData::Library weaponLibrary;
+    if (!weaponLibrary.open(WeaponData::BLOB_PATH)) {
+        TS_LOG_WARN("Weapon blob unusable ({}), compiling {}", weaponLibrary.getError(), WeaponData::TEXT_PATH);
+        if (!weaponLibrary.loadText(WeaponData::TEXT_PATH)) {
+            TS_LOG_ERROR("No weapons: {}", weaponLibrary.getError());
+        }
+    }
+    WeaponSystem weaponSystem(&camera, &playerController, weaponLibrary);
     AudioSystem audioSystem;
+    GlfwInputSource inputSource(window);
     
     // Set global pointers
     gCamera = &camera;
     gPlayerController = &playerController;
     gWeaponSystem = &weaponSystem;
     gAudioSystem = &audioSystem;
+    gInputSource = &inputSource;
 
     // Initialize audio system
     if (!audioSystem.initialize()) {
@@ -225,6 +259,35 @@ int main() {
     }
     weaponSystem.setAudioSystem(&audioSystem);
 
+    // Collision
+    CollisionWorld collisionWorld;
+    buildArena(collisionWorld);
+    playerController.setCollisionWorld(&collisionWorld);
+    weaponSystem.setCollisionWorld(&collisionWorld);
+
+    // Training dummies to shoot at: one per floor material, one side-on
+    const Hitscan::Target dummies[] = {
+        { 0, glm::vec3(-4.0f, 0.0f, -15.0f), 90.0f },
+        { 1, glm::vec3(4.0f, 0.0f, -15.0f), 90.0f },
+        { 2, glm::vec3(0.0f, 0.0f, -25.0f), 0.0f },
+    };
+    const uint32_t dummyCount = sizeof(dummies) / sizeof(dummies[0]);
+    Hitscan::HitboxSet dummyHitboxes;
+    dummyHitboxes.build(dummies, dummyCount);
+    weaponSystem.setHitboxes(&dummyHitboxes);
+
+    // Grenades (large fixed pool, keep it off the stack)
+    static ProjectileSystem projectiles;
+    projectiles.setCollisionWorld(&collisionWorld);
+    gProjectiles = &projectiles;
+
+    // Input recording
+    InputRecording recording;
+    if (!recordPath.empty()) {
+        recording.begin(playerController);
+        std::cout << "Recording input to " << recordPath << std::endl;
+    }
+
     // Shaders
     Shader shader("shaders/basic.vert", "shaders/basic.frag");
 
@@ -349,108 +412,169 @@ int main() {
 
     std::cout << "TrueShot initialized! Ready for tactical action!" << std::endl;
 
-    // Boucle principale
-    while (!glfwWindowShouldClose(window)) {
-        // Calcul du deltaTime
-        float currentFrame = (float)glfwGetTime();
-        deltaTime = currentFrame - lastFrame;
-        lastFrame = currentFrame;
-
-        // Input processing
-        processInput(window, deltaTime);
+    // The window thread only pumps input from here on; simulation and
+    // rendering run on the game thread, which takes over the GL context
+    glfwMakeContextCurrent(nullptr);
+    std::thread gameThread([&]() {
+        glfwMakeContextCurrent(window);
+
+        // Boucle principale
+        while (!glfwWindowShouldClose(window)) {
+            // Calcul du deltaTime
+            double frameTime = glfwGetTime();
+            float currentFrame = (float)frameTime;
+            deltaTime = currentFrame - lastFrame;
+            lastFrame = currentFrame;
+
+            // Drain the events the window thread queued, stamped against this sample
+            inputSource.beginFrame(frameTime);
+            float mouseX, mouseY;
+            inputSource.takeMouseDelta(mouseX, mouseY);
+            if (mouseX != 0.0f || mouseY != 0.0f)
+                playerController.processMouseInput(mouseX, mouseY);
+
+            // Resizes arrive on the window thread; apply them where the context lives
+            glViewport(0, 0, gFramebufferWidth.load(), gFramebufferHeight.load());
+
+            // Input processing
+            processInput(deltaTime);
+            if (!recordPath.empty())
+                recording.addFrame(deltaTime, inputSource, playerController);
         
-        // Physics/weapons/audio update
-        playerController.update(deltaTime);
-        weaponSystem.update(deltaTime);
-        audioSystem.update(deltaTime);
+            // Physics/weapons/audio update
+            uint32_t tickBefore = playerController.getTick();
+            playerController.update(deltaTime);
+            if (playerController.getTick() != tickBefore)
+                inputSource.onTickConsumed(glfwGetTime());
+            weaponSystem.update(deltaTime);
+            projectiles.update(deltaTime);
+            audioSystem.onProjectileEvents(projectiles.getEvents(), projectiles.getEventCount());
+            audioSystem.update(deltaTime);
 
-        audioSystem.setListenerFromCamera(&camera, &playerController);
+            audioSystem.setListenerFromCamera(&camera, &playerController);
 
-        // Debug info
-        printDebugInfo(&playerController, &weaponSystem);
+            // Debug info
+            printDebugInfo(&playerController, &weaponSystem, &inputSource);
 
-        // Rendu
-        glClearColor(0.05f, 0.1f, 0.15f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+            // Rendu
+            glClearColor(0.05f, 0.1f, 0.15f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-        shader.use();
+            shader.use();
 
-        // Matrices de projection et vue
-        float fov = 75.0f;
+            // Matrices de projection et vue
+            float fov = 75.0f;
         
-        // Adjust FOV for ADS
-        if (weaponSystem.isAiming() && weaponSystem.getCurrentWeapon()) {
-            float adsFOV = fov * weaponSystem.getCurrentWeapon()->stats.adsFOVMultiplier;
-            float adsProgress = weaponSystem.getWeaponState().adsProgress;
-            fov = glm::mix(fov, adsFOV, adsProgress);
-        }
+            // Adjust FOV for ADS
+            if (weaponSystem.isAiming() && weaponSystem.getCurrentWeapon()) {
+                float adsFOV = fov * weaponSystem.getCurrentWeapon()->stats.adsFOVMultiplier;
+                float adsProgress = weaponSystem.getWeaponState().adsProgress;
+                fov = glm::mix(fov, adsFOV, adsProgress);
+            }
         
-        glm::mat4 projection = glm::perspective(glm::radians(fov), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 200.0f);
-        glm::mat4 view = camera.getViewMatrix();
-        shader.setMat4("projection", projection);
-        shader.setMat4("view", view);
+            glm::mat4 projection = glm::perspective(glm::radians(fov), (float)SCR_WIDTH / (float)SCR_HEIGHT, 0.1f, 200.0f);
+            glm::mat4 view = camera.getViewMatrix();
+            shader.setMat4("projection", projection);
+            shader.setMat4("view", view);
 
-        // Rendu du sol
-        glm::mat4 model = glm::mat4(1.0f);
-        shader.setMat4("model", model);
+            // Rendu du sol
+            glm::mat4 model = glm::mat4(1.0f);
+            shader.setMat4("model", model);
 
-        glBindVertexArray(floorVAO);
-        glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
-        glBindVertexArray(0);
+            glBindVertexArray(floorVAO);
+            glDrawElements(GL_TRIANGLES, 6, GL_UNSIGNED_INT, 0);
+            glBindVertexArray(0);
 
-        // Rendu des targets/cubes
-        for (int i = 0; i < numTargets; ++i) {
-            glm::mat4 model = glm::mat4(1.0f);
-            model = glm::translate(model, targetPositions[i]);
+            // Rendu des targets/cubes
+            for (int i = 0; i < numTargets; ++i) {
+                glm::mat4 model = glm::mat4(1.0f);
+                model = glm::translate(model, targetPositions[i]);
             
-            // Rotation lente pour les voir bouger
-            model = glm::rotate(model, (float)glfwGetTime() * 0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
+                // Rotation lente pour les voir bouger
+                model = glm::rotate(model, (float)glfwGetTime() * 0.5f, glm::vec3(0.0f, 1.0f, 0.0f));
             
-            // Scale différente selon la distance pour le challenge
-            float distance = glm::length(targetPositions[i]);
-            float scale = 1.0f + (distance / 50.0f); // Plus loin = plus gros
-            model = glm::scale(model, glm::vec3(scale));
+                // Scale différente selon la distance pour le challenge
+                float distance = glm::length(targetPositions[i]);
+                float scale = 1.0f + (distance / 50.0f); // Plus loin = plus gros
+                model = glm::scale(model, glm::vec3(scale));
             
-            shader.setMat4("model", model);
+                shader.setMat4("model", model);
 
-            glBindVertexArray(cubeVAO);
-            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
-        }
-        glBindVertexArray(0);
+                glBindVertexArray(cubeVAO);
+                glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+            }
 
-        // Crosshair simple (rendu en dernier, sans depth test)
-        glDisable(GL_DEPTH_TEST);
+            // Dummies, one stretched cube per hitbox
+            glBindVertexArray(cubeVAO);
+            const Hitscan::Hitbox* hitboxes = Hitscan::getHitboxes();
+            for (uint32_t d = 0; d < dummyCount; ++d) {
+                glm::mat4 body = glm::translate(glm::mat4(1.0f), dummies[d].feet);
+                body = glm::rotate(body, glm::radians(90.0f - dummies[d].yaw), glm::vec3(0.0f, 1.0f, 0.0f));
+                for (uint32_t h = 0; h < Hitscan::HITBOX_COUNT; ++h) {
+                    const Hitscan::Hitbox& box = hitboxes[h];
+                    glm::vec3 extent = glm::abs(box.b - box.a) + glm::vec3(2.0f * box.radius);
+                    glm::mat4 model = glm::translate(body, (box.a + box.b) * 0.5f);
+                    shader.setMat4("model", glm::scale(model, extent));
+                    glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+                }
+            }
+
+            // Grenades as small cubes
+            glBindVertexArray(cubeVAO);
+            for (uint32_t i = 0; i < projectiles.size(); ++i) {
+                glm::mat4 model = glm::translate(glm::mat4(1.0f), projectiles.getPosition(i));
+                model = glm::scale(model, glm::vec3(0.2f));
+                shader.setMat4("model", model);
+                glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, 0);
+            }
+            glBindVertexArray(0);
+
+            // Crosshair simple (rendu en dernier, sans depth test)
+            glDisable(GL_DEPTH_TEST);
         
-        model = glm::mat4(1.0f);
-        // Position le crosshair au centre de l'écran
-        glm::vec3 cameraPos = playerController.getPosition();
-        glm::vec3 cameraForward = camera.getForward();
-        model = glm::translate(model, cameraPos + cameraForward * 2.0f);
+            model = glm::mat4(1.0f);
+            // Position le crosshair au centre de l'écran
+            glm::vec3 cameraPos = playerController.getRenderPosition();
+            glm::vec3 cameraForward = camera.getForward();
+            model = glm::translate(model, cameraPos + cameraForward * 2.0f);
         
-        shader.setMat4("model", model);
+            shader.setMat4("model", model);
 
-        glBindVertexArray(crosshairVAO);
-        glLineWidth(2.0f);
-        glDrawArrays(GL_LINES, 0, 4);
-        glBindVertexArray(0);
+            glBindVertexArray(crosshairVAO);
+            glLineWidth(2.0f);
+            glDrawArrays(GL_LINES, 0, 4);
+            glBindVertexArray(0);
         
-        glEnable(GL_DEPTH_TEST);
+            glEnable(GL_DEPTH_TEST);
 
-        // Swap et events
-        glfwSwapBuffers(window);
-        glfwPollEvents();
-    }
+            // Swap
+            glfwSwapBuffers(window);
+        }
+
+        if (!recordPath.empty()) {
+            recording.finish(playerController);
+            if (recording.save(recordPath))
+                std::cout << "Saved " << recording.getFrameCount() << " frames to " << recordPath << std::endl;
+        }
+
+        // Cleanup (GL objects belong to this thread's context)
+        glDeleteVertexArrays(1, &floorVAO);
+        glDeleteBuffers(1, &floorVBO);
+        glDeleteBuffers(1, &floorEBO);
+        glDeleteVertexArrays(1, &cubeVAO);
+        glDeleteBuffers(1, &cubeVBO);
+        glDeleteBuffers(1, &cubeEBO);
+        glDeleteVertexArrays(1, &crosshairVAO);
+        glDeleteBuffers(1, &crosshairVBO);
+        glfwMakeContextCurrent(nullptr);
+    });
+
+    // Input thread: wakes on every event, at least at 1 kHz, until close
+    inputSource.pump(1000.0);
+    gameThread.join();
 
-    // Cleanup
-    glDeleteVertexArrays(1, &floorVAO);
-    glDeleteBuffers(1, &floorVBO);
-    glDeleteBuffers(1, &floorEBO);
-    glDeleteVertexArrays(1, &cubeVAO);
-    glDeleteBuffers(1, &cubeVBO);
-    glDeleteBuffers(1, &cubeEBO);
-    glDeleteVertexArrays(1, &crosshairVAO);
-    glDeleteBuffers(1, &crosshairVBO);
     audioSystem.shutdown();
+    Telemetry::stop();
 
     glfwTerminate();
     return 0;
@@ -0,0 +1,351 @@
+#include "movement_batch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    // acos in degrees, Abramowitz & Stegun 4.4.45 (abs error < 0.004°).
+    // Only scales the strafe-angle bonus, so no libm call per player; the
+    // 20-60° window itself is tested on the cosine so its edges match
+    // PlayerController's acos exactly.
+    inline float fastAcosDegrees(float x) {
+        float a = std::fabs(x);
+        float r = std::sqrt(1.0f - a) * (1.5707288f + a * (-0.2121144f + a * (0.0742610f + a * -0.0187293f)));
+        if (x < 0.0f) r = 3.14159265f - r;
+        return r * 57.2957795f;
+    }
+
+    const float SMALL_SPEED = 1e-6f;
+    const float COS_20 = 0.93969262f;
+    const float COS_60 = 0.5f;
+}
+
+MovementBatch::MovementBatch(size_t capacity, Physics::MovementRuleset ruleset)
+    : m_Ruleset(ruleset) {
+    posX.reserve(capacity); posY.reserve(capacity); posZ.reserve(capacity);
+    velX.reserve(capacity); velY.reserve(capacity); velZ.reserve(capacity);
+    wishX.reserve(capacity); wishZ.reserve(capacity);
+    surfaceFriction.reserve(capacity);
+    airTime.reserve(capacity);
+    speed.reserve(capacity);
+    onGround.reserve(capacity);
+    wishJump.reserve(capacity);
+    jumpOffset.reserve(capacity);
+}
+
+size_t MovementBatch::add(const glm::vec3& position) {
+    posX.push_back(position.x); posY.push_back(position.y); posZ.push_back(position.z);
+    velX.push_back(0.0f); velY.push_back(0.0f); velZ.push_back(0.0f);
+    wishX.push_back(0.0f); wishZ.push_back(0.0f);
+    surfaceFriction.push_back(1.0f);
+    airTime.push_back(0.0f);
+    speed.push_back(0.0f);
+    onGround.push_back(0);
+    wishJump.push_back(0);
+    jumpOffset.push_back(0.0f);
+    return m_Count++;
+}
+
+void MovementBatch::clear() {
+    posX.clear(); posY.clear(); posZ.clear();
+    velX.clear(); velY.clear(); velZ.clear();
+    wishX.clear(); wishZ.clear();
+    surfaceFriction.clear();
+    airTime.clear();
+    speed.clear();
+    onGround.clear();
+    wishJump.clear();
+    jumpOffset.clear();
+    m_Count = 0;
+}
+
+void MovementBatch::setInput(size_t i, float yaw, const glm::vec2& moveInput, bool jumpPressed, float jumpAt) {
+    wishX[i] = 0.0f;
+    wishZ[i] = 0.0f;
+    if (jumpPressed) {
+        wishJump[i] = 1;
+        jumpOffset[i] = jumpAt;
+    }
+    if (glm::length(moveInput) < 0.1f) return;
+
+    float fx = cos(glm::radians(yaw));
+    float fz = sin(glm::radians(yaw));
+    // right = cross(forward, up) = (-fz, 0, fx)
+    float x = fx * moveInput.y - fz * moveInput.x;
+    float z = fz * moveInput.y + fx * moveInput.x;
+    float len = std::sqrt(x * x + z * z);
+    if (len > 0.0f) {
+        wishX[i] = x / len;
+        wishZ[i] = z / len;
+    }
+}
+
+float MovementBatch::getFixedTimestep() const {
+    return Physics::withProfile(m_Ruleset, [](auto profile) {
+        return 1.0f / decltype(profile)::TICK_RATE;
+    });
+}
+
+void MovementBatch::step(float deltaTime) {
+    Physics::withProfile(m_Ruleset, [&](auto profile) {
+        stepProfile<decltype(profile)>(deltaTime);
+    });
+}
+
+void MovementBatch::stepReference(float deltaTime) {
+    Physics::withProfile(m_Ruleset, [&](auto profile) {
+        stepScalar<decltype(profile)>(0, m_Count, deltaTime);
+    });
+}
+
+template <typename Profile>
+void MovementBatch::stepProfile(float deltaTime) {
+    size_t simdEnd = 0;
+#if defined(__SSE2__)
+    simdEnd = m_Count & ~size_t(3);
+    stepSSE<Profile>(0, simdEnd, deltaTime);
+#endif
+    stepScalar<Profile>(simdEnd, m_Count, deltaTime);
+}
+
+namespace {
+    // Ground friction without input, acceleration with it, for `dt`
+    template <typename P>
+    inline void groundMove(float& vx, float& vz, float wx, float wz, bool hasWish, float surfaceFriction, float dt) {
+        if (!hasWish) {
+            float hs = std::sqrt(vx * vx + vz * vz);
+            if (hs < 0.1f) {
+                vx = 0.0f;
+                vz = 0.0f;
+            } else {
+                float drop = std::max(hs, P::GROUND_FRICTION) * P::GROUND_FRICTION * surfaceFriction * dt;
+                float scale = std::max(0.0f, hs - drop) / hs;
+                vx *= scale;
+                vz *= scale;
+            }
+        } else {
+            float add = P::MAX_GROUND_SPEED - (vx * wx + vz * wz);
+            if (add > 0.0f) {
+                float accel = std::min(P::GROUND_ACCELERATION * P::MAX_GROUND_SPEED * dt, add);
+                vx += wx * accel;
+                vz += wz * accel;
+            }
+        }
+    }
+}
+
+template <typename Profile>
+void MovementBatch::stepScalar(size_t begin, size_t end, float stepTime) {
+    using P = Profile;
+    using Physics::PLAYER_HEIGHT;
+    using Physics::GROUND_TOLERANCE;
+
+    for (size_t i = begin; i < end; ++i) {
+        float px = posX[i], py = posY[i], pz = posZ[i];
+        float vx = velX[i], vy = velY[i], vz = velZ[i];
+        float wx = wishX[i], wz = wishZ[i];
+        float dt = stepTime;
+        bool hasWish = (wx * wx + wz * wz) > 0.0f;
+        bool wasGround = onGround[i] != 0;
+
+        // Ground state
+        bool ground = py <= PLAYER_HEIGHT + GROUND_TOLERANCE;
+        if (ground && vy <= 0.0f) {
+            vy = 0.0f;
+            py = PLAYER_HEIGHT;
+        }
+
+        // Jump at its sub-step time: keep walking until the press, then
+        // jump for the rest of the step
+        if (wishJump[i] && ground) {
+            float before = jumpOffset[i] * dt;
+            if (before > 0.0f) {
+                groundMove<P>(vx, vz, wx, wz, hasWish, surfaceFriction[i], before);
+                px += vx * before;
+                py = std::max(PLAYER_HEIGHT, py + vy * before);
+                pz += vz * before;
+                dt -= before;
+            }
+            vy = P::JUMP_IMPULSE;
+            ground = false;
+        }
+        wishJump[i] = 0;
+
+        float hs = std::sqrt(vx * vx + vz * vz);
+        if (ground) {
+            groundMove<P>(vx, vz, wx, wz, hasWish, surfaceFriction[i], dt);
+            if (!wasGround) airTime[i] = 0.0f;
+        } else {
+            if (hasWish) {
+                float rate = P::AIR_ACCELERATION;
+                if (hs >= 1.0f) {
+                    float d = std::max(-1.0f, std::min(1.0f, (vx * wx + vz * wz) / hs));
+                    if (d <= COS_20 && d >= COS_60) {
+                        float angle = fastAcosDegrees(d);
+                        float factor = std::max(0.5f, 1.0f - std::fabs(angle - P::OPTIMAL_STRAFE_ANGLE) / 30.0f);
+                        rate = P::AIR_ACCELERATION * (1.0f + factor * 0.5f);
+                    }
+                }
+                float add = P::AIR_MAX_SPEED - (vx * wx + vz * wz);
+                if (add > 0.0f) {
+                    float accel = std::min(rate * P::AIR_MAX_SPEED * dt, add);
+                    vx += wx * accel;
+                    vz += wz * accel;
+                }
+                float cs = std::sqrt(vx * vx + vz * vz);
+                if (cs > P::MAX_AIR_SPEED_CAP) {
+                    vx *= P::MAX_AIR_SPEED_CAP / cs;
+                    vz *= P::MAX_AIR_SPEED_CAP / cs;
+                }
+            }
+            float airFriction = 1.0f - P::AIR_FRICTION * dt;
+            vx *= airFriction;
+            vz *= airFriction;
+            airTime[i] += dt;
+            vy -= P::GRAVITY * dt;
+        }
+
+        posX[i] = px + vx * dt;
+        posY[i] = std::max(PLAYER_HEIGHT, py + vy * dt);
+        posZ[i] = pz + vz * dt;
+        velX[i] = vx; velY[i] = vy; velZ[i] = vz;
+        speed[i] = std::sqrt(vx * vx + vz * vz);
+        onGround[i] = ground ? 1 : 0;
+    }
+}
+
+#if defined(__SSE2__)
+namespace {
+    inline __m128 select(__m128 mask, __m128 a, __m128 b) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    inline __m128 loadMask(const uint8_t* flags) {
+        __m128i v = _mm_setr_epi32(flags[0], flags[1], flags[2], flags[3]);
+        return _mm_castsi128_ps(_mm_cmpgt_epi32(v, _mm_setzero_si128()));
+    }
+
+    inline __m128 fastAcosDegrees(__m128 x) {
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        __m128 a = _mm_andnot_ps(signBit, x);
+        __m128 poly = _mm_add_ps(_mm_set1_ps(0.0742610f), _mm_mul_ps(a, _mm_set1_ps(-0.0187293f)));
+        poly = _mm_add_ps(_mm_set1_ps(-0.2121144f), _mm_mul_ps(a, poly));
+        poly = _mm_add_ps(_mm_set1_ps(1.5707288f), _mm_mul_ps(a, poly));
+        __m128 r = _mm_mul_ps(_mm_sqrt_ps(_mm_sub_ps(_mm_set1_ps(1.0f), a)), poly);
+        __m128 negative = _mm_cmplt_ps(x, _mm_setzero_ps());
+        r = select(negative, _mm_sub_ps(_mm_set1_ps(3.14159265f), r), r);
+        return _mm_mul_ps(r, _mm_set1_ps(57.2957795f));
+    }
+}
+
+template <typename Profile>
+void MovementBatch::stepSSE(size_t begin, size_t end, float dt) {
+    using P = Profile;
+    using Physics::PLAYER_HEIGHT;
+    using Physics::GROUND_TOLERANCE;
+
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 dtv = _mm_set1_ps(dt);
+    const __m128 playerHeight = _mm_set1_ps(PLAYER_HEIGHT);
+    const __m128 signBit = _mm_set1_ps(-0.0f);
+
+    for (size_t i = begin; i < end; i += 4) {
+        // A jump pressed part-way through the step splits it in two for that
+        // player; rare enough to leave the whole group to the scalar path
+        uint32_t jumps;
+        std::memcpy(&jumps, &wishJump[i], sizeof(jumps));
+        if (jumps != 0 && _mm_movemask_ps(_mm_and_ps(loadMask(&wishJump[i]),
+                                                     _mm_cmpgt_ps(_mm_loadu_ps(&jumpOffset[i]), zero))) != 0) {
+            stepScalar<Profile>(i, i + 4, dt);
+            continue;
+        }
+
+        __m128 px = _mm_loadu_ps(&posX[i]), py = _mm_loadu_ps(&posY[i]), pz = _mm_loadu_ps(&posZ[i]);
+        __m128 vx = _mm_loadu_ps(&velX[i]), vy = _mm_loadu_ps(&velY[i]), vz = _mm_loadu_ps(&velZ[i]);
+        __m128 wx = _mm_loadu_ps(&wishX[i]), wz = _mm_loadu_ps(&wishZ[i]);
+        __m128 air = _mm_loadu_ps(&airTime[i]);
+        __m128 hasWish = _mm_cmpgt_ps(_mm_add_ps(_mm_mul_ps(wx, wx), _mm_mul_ps(wz, wz)), zero);
+        __m128 wasGround = loadMask(&onGround[i]);
+
+        // Ground state
+        __m128 ground = _mm_cmple_ps(py, _mm_set1_ps(PLAYER_HEIGHT + GROUND_TOLERANCE));
+        __m128 snap = _mm_and_ps(ground, _mm_cmple_ps(vy, zero));
+        vy = _mm_andnot_ps(snap, vy);
+        py = select(snap, playerHeight, py);
+
+        // Jump
+        __m128 jumped = _mm_and_ps(loadMask(&wishJump[i]), ground);
+        vy = select(jumped, _mm_set1_ps(P::JUMP_IMPULSE), vy);
+        ground = _mm_andnot_ps(jumped, ground);
+
+        __m128 hs = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vz, vz)));
+        __m128 invHs = _mm_div_ps(one, _mm_max_ps(hs, _mm_set1_ps(SMALL_SPEED)));
+        __m128 along = _mm_add_ps(_mm_mul_ps(vx, wx), _mm_mul_ps(vz, wz));
+
+        // Ground: friction without input, acceleration with input
+        __m128 drop = _mm_mul_ps(_mm_max_ps(hs, _mm_set1_ps(P::GROUND_FRICTION)),
+                                 _mm_mul_ps(_mm_set1_ps(P::GROUND_FRICTION * dt), _mm_loadu_ps(&surfaceFriction[i])));
+        __m128 frictionScale = _mm_mul_ps(_mm_max_ps(zero, _mm_sub_ps(hs, drop)), invHs);
+        frictionScale = _mm_andnot_ps(_mm_cmplt_ps(hs, _mm_set1_ps(0.1f)), frictionScale);
+        frictionScale = select(hasWish, one, frictionScale);
+
+        __m128 groundAdd = _mm_sub_ps(_mm_set1_ps(P::MAX_GROUND_SPEED), along);
+        __m128 groundAccel = _mm_min_ps(_mm_set1_ps(P::GROUND_ACCELERATION * P::MAX_GROUND_SPEED * dt), groundAdd);
+        groundAccel = _mm_and_ps(_mm_and_ps(hasWish, _mm_cmpgt_ps(groundAdd, zero)), groundAccel);
+
+        __m128 gvx = _mm_add_ps(_mm_mul_ps(vx, frictionScale), _mm_mul_ps(wx, groundAccel));
+        __m128 gvz = _mm_add_ps(_mm_mul_ps(vz, frictionScale), _mm_mul_ps(wz, groundAccel));
+
+        // Air: strafe bonus in the 20-60° window, speed cap, air friction
+        __m128 d = _mm_max_ps(_mm_set1_ps(-1.0f), _mm_min_ps(one, _mm_mul_ps(along, invHs)));
+        __m128 angle = fastAcosDegrees(d);
+        __m128 goodAngle = _mm_and_ps(_mm_cmple_ps(d, _mm_set1_ps(COS_20)), _mm_cmpge_ps(d, _mm_set1_ps(COS_60)));
+        goodAngle = _mm_and_ps(goodAngle, _mm_cmpge_ps(hs, one));
+        __m128 offset = _mm_andnot_ps(signBit, _mm_sub_ps(angle, _mm_set1_ps(P::OPTIMAL_STRAFE_ANGLE)));
+        __m128 factor = _mm_max_ps(_mm_set1_ps(0.5f), _mm_sub_ps(one, _mm_mul_ps(offset, _mm_set1_ps(1.0f / 30.0f))));
+        __m128 rate = _mm_mul_ps(_mm_set1_ps(P::AIR_ACCELERATION), _mm_add_ps(one, _mm_mul_ps(factor, _mm_set1_ps(0.5f))));
+        rate = select(goodAngle, rate, _mm_set1_ps(P::AIR_ACCELERATION));
+
+        __m128 airAdd = _mm_sub_ps(_mm_set1_ps(P::AIR_MAX_SPEED), along);
+        __m128 airAccel = _mm_min_ps(_mm_mul_ps(rate, _mm_set1_ps(P::AIR_MAX_SPEED * dt)), airAdd);
+        airAccel = _mm_and_ps(_mm_and_ps(hasWish, _mm_cmpgt_ps(airAdd, zero)), airAccel);
+        __m128 avx = _mm_add_ps(vx, _mm_mul_ps(wx, airAccel));
+        __m128 avz = _mm_add_ps(vz, _mm_mul_ps(wz, airAccel));
+
+        __m128 cs = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(avx, avx), _mm_mul_ps(avz, avz)));
+        __m128 capMask = _mm_and_ps(hasWish, _mm_cmpgt_ps(cs, _mm_set1_ps(P::MAX_AIR_SPEED_CAP)));
+        __m128 capScale = select(capMask, _mm_div_ps(_mm_set1_ps(P::MAX_AIR_SPEED_CAP), _mm_max_ps(cs, _mm_set1_ps(SMALL_SPEED))), one);
+        capScale = _mm_mul_ps(capScale, _mm_set1_ps(1.0f - P::AIR_FRICTION * dt));
+        avx = _mm_mul_ps(avx, capScale);
+        avz = _mm_mul_ps(avz, capScale);
+
+        vx = select(ground, gvx, avx);
+        vz = select(ground, gvz, avz);
+        vy = select(ground, vy, _mm_sub_ps(vy, _mm_set1_ps(P::GRAVITY * dt)));
+        __m128 landed = _mm_andnot_ps(wasGround, ground);
+        air = select(ground, _mm_andnot_ps(landed, air), _mm_add_ps(air, dtv));
+
+        // Integrate, floor clamp
+        px = _mm_add_ps(px, _mm_mul_ps(vx, dtv));
+        py = _mm_max_ps(playerHeight, _mm_add_ps(py, _mm_mul_ps(vy, dtv)));
+        pz = _mm_add_ps(pz, _mm_mul_ps(vz, dtv));
+
+        _mm_storeu_ps(&posX[i], px); _mm_storeu_ps(&posY[i], py); _mm_storeu_ps(&posZ[i], pz);
+        _mm_storeu_ps(&velX[i], vx); _mm_storeu_ps(&velY[i], vy); _mm_storeu_ps(&velZ[i], vz);
+        _mm_storeu_ps(&airTime[i], air);
+        _mm_storeu_ps(&speed[i], _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vz, vz))));
+
+        int groundBits = _mm_movemask_ps(ground);
+        for (int lane = 0; lane < 4; ++lane) {
+            onGround[i + lane] = (groundBits >> lane) & 1;
+            wishJump[i + lane] = 0;
+        }
+    }
+}
+#endif
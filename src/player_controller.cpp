@@ -1,16 +1,110 @@
 #include "player_controller.h"
 #include "fps_camera.h"
+#include "collision_world.h"
+#include "telemetry.h"
 
 #include <algorithm>
-#include <iostream>
 #include <cmath>
 
 PlayerController::PlayerController(FPSCamera* camera)
     : m_Camera(camera) {
     m_State.position = glm::vec3(0.0f, Physics::PLAYER_HEIGHT, 3.0f);
-    m_Camera->setPosition(m_State.position);
+    if (m_Camera) {
+        m_Camera->setPosition(m_State.position);
+        m_Camera->setViewAngles(m_Yaw, m_Pitch);
+    }
     m_GameTime = 0.0f;
     m_LastFootstepPos = m_State.position;
+    m_PreviousPosition = m_State.position;
+    m_RenderPosition = m_State.position;
+}
+
+void PlayerController::setPosition(const glm::vec3& position) {
+    m_State.position = position;
+    m_LastFootstepPos = position;
+    m_PreviousPosition = position;  // Teleport: nothing to interpolate from
+    m_RenderPosition = position;
+    if (m_Camera) m_Camera->setPosition(position);
+}
+
+PlayerSimState PlayerController::saveState() const {
+    PlayerSimState state;
+    state.movement = m_State;
+    state.input = m_Input;
+    state.yaw = m_Yaw;
+    state.pitch = m_Pitch;
+    state.gameTime = m_GameTime;
+    state.groundTime = m_GroundTime;
+    state.lastFootstepTime = m_LastFootstepTime;
+    state.lastFootstepPos = m_LastFootstepPos;
+    state.wasOnGroundAudio = m_WasOnGroundAudio;
+    state.tick = m_Tick;
+    return state;
+}
+
+void PlayerController::restoreState(const PlayerSimState& state) {
+    m_State = state.movement;
+    m_Input = state.input;
+    m_GameTime = state.gameTime;
+    m_GroundTime = state.groundTime;
+    m_LastFootstepTime = state.lastFootstepTime;
+    m_LastFootstepPos = state.lastFootstepPos;
+    m_WasOnGroundAudio = state.wasOnGroundAudio;
+    m_Tick = state.tick;
+    setViewAngles(state.yaw, state.pitch);
+    m_PreviousPosition = m_State.position;
+    m_RenderPosition = m_State.position;
+}
+
+void PlayerController::stepTick() {
+    m_History[m_Tick % HISTORY_TICKS] = saveState();
+    m_PreviousPosition = m_State.position;
+    updatePhysics(Physics::FIXED_TIMESTEP);
+    m_Tick++;
+}
+
+void PlayerController::simulateTick(const PlayerTickInput& input) {
+    StateInputSource source;
+    source.setMask(input.buttons);
+    setViewAngles(input.yaw, input.pitch);
+    processInput(source, Physics::FIXED_TIMESTEP);
+    if (m_Input.jumpPressed) scheduleJump(input.jumpOffset * Physics::FIXED_TIMESTEP);
+    m_GameTime += Physics::FIXED_TIMESTEP;
+    updateInputTiming(Physics::FIXED_TIMESTEP);
+    stepTick();
+    m_Input.reset();
+}
+
+bool PlayerController::resimulate(uint32_t fromTick, const PlayerTickInput* inputs, size_t count) {
+    const PlayerSimState& saved = m_History[fromTick % HISTORY_TICKS];
+    if (fromTick >= m_Tick || m_Tick - fromTick > HISTORY_TICKS || saved.tick != fromTick) return false;
+
+    restoreState(saved);
+    bool wasReplaying = m_Replaying;
+    m_Replaying = true;
+    for (size_t i = 0; i < count; ++i) {
+        simulateTick(inputs[i]);
+    }
+    m_Replaying = wasReplaying;
+    m_RenderPosition = m_State.position;
+    if (m_Camera) m_Camera->setPosition(m_RenderPosition);
+    return true;
+}
+
+void PlayerController::addViewAngles(float yawDelta, float pitchDelta) {
+    setViewAngles(m_Yaw + yawDelta, m_Pitch + pitchDelta);
+}
+
+void PlayerController::setViewAngles(float yaw, float pitch) {
+    m_Yaw = yaw;
+    m_Pitch = glm::clamp(pitch, -Physics::MAX_PITCH, Physics::MAX_PITCH);
+    if (m_Camera) m_Camera->setViewAngles(m_Yaw, m_Pitch);
+}
+
+glm::vec3 PlayerController::getViewForward() const {
+    float yaw = glm::radians(m_Yaw);
+    float pitch = glm::radians(m_Pitch);
+    return glm::vec3(cos(yaw) * cos(pitch), sin(pitch), sin(yaw) * cos(pitch));
 }
 
 void PlayerController::update(float deltaTime) {
@@ -22,29 +116,40 @@ void PlayerController::update(float deltaTime) {
     // Fixed timestep physics
     m_TimeAccumulator += deltaTime;
     
-    while (m_TimeAccumulator >= Physics::FIXED_TIMESTEP) {
-        updatePhysics(Physics::FIXED_TIMESTEP);
+    int steps = 0;
+    while (m_TimeAccumulator >= Physics::FIXED_TIMESTEP && steps < Physics::MAX_STEPS_PER_FRAME) {
+        stepTick();
         m_TimeAccumulator -= Physics::FIXED_TIMESTEP;
+        steps++;
     }
     
-    m_Camera->setPosition(m_State.position);
+    // Hitch: drop the whole ticks we couldn't afford instead of spiralling
+    if (m_TimeAccumulator >= Physics::FIXED_TIMESTEP) {
+        float remainder = std::fmod(m_TimeAccumulator, Physics::FIXED_TIMESTEP);
+        m_DroppedTime += m_TimeAccumulator - remainder;
+        m_TimeAccumulator = remainder;
+    }
+    
+    // Render one tick behind, blended by the leftover fraction of a tick
+    m_RenderPosition = glm::mix(m_PreviousPosition, m_State.position, getInterpolationAlpha());
+    if (m_Camera) m_Camera->setPosition(m_RenderPosition);
     m_Input.reset();
 }
 
-void PlayerController::processInput(GLFWwindow* window, float deltaTime) {
+void PlayerController::processInput(const InputSource& input, float deltaTime) {
     // Store previous jump state
     bool wasJumping = m_Input.jump;
     
     // Movement input (WASD)
     m_Input.moveInput = glm::vec2(0.0f);
     
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
+    if (input.isDown(InputAction::MOVE_FORWARD))
         m_Input.moveInput.y += 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
+    if (input.isDown(InputAction::MOVE_BACK))
         m_Input.moveInput.y -= 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_A) == GLFW_PRESS)
+    if (input.isDown(InputAction::MOVE_LEFT))
         m_Input.moveInput.x -= 1.0f;
-    if (glfwGetKey(window, GLFW_KEY_D) == GLFW_PRESS)
+    if (input.isDown(InputAction::MOVE_RIGHT))
         m_Input.moveInput.x += 1.0f;
     
     // Normalize diagonal movement
@@ -53,25 +158,40 @@ void PlayerController::processInput(GLFWwindow* window, float deltaTime) {
     }
     
     // Jump input avec timing
-    bool jumpCurrently = glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS;
+    bool jumpCurrently = input.isDown(InputAction::JUMP);
+    m_Input.crouch = input.isDown(InputAction::CROUCH);
     m_Input.jumpPressed = jumpCurrently && !wasJumping;
     m_Input.jumpReleased = !jumpCurrently && wasJumping;
     m_Input.jump = jumpCurrently;
     
     if (m_Input.jumpPressed) {
-        m_State.wishJump = true;
+        // The press is `age` s before this frame's sample, and update(deltaTime)
+        // will bring the simulation up to that sample
+        scheduleJump(m_TimeAccumulator + deltaTime - input.pressAge(InputAction::JUMP));
     }
 }
 
+void PlayerController::scheduleJump(float secondsAhead) {
+    float ticksAhead = std::max(0.0f, secondsAhead) / Physics::FIXED_TIMESTEP;
+    uint32_t wholeTicks = static_cast<uint32_t>(ticksAhead);
+    m_State.wishJump = true;
+    m_State.wishJumpTick = m_Tick + wholeTicks;
+    m_State.wishJumpFraction = ticksAhead - static_cast<float>(wholeTicks);
+}
+
+glm::vec3 PlayerController::getPositionAtInput(float inputAge, float deltaTime) const {
+    float ahead = glm::clamp(m_TimeAccumulator + deltaTime - inputAge,
+                             -Physics::FIXED_TIMESTEP, Physics::FIXED_TIMESTEP);
+    return m_State.position + m_State.velocity * ahead;
+}
+
 void PlayerController::processMouseInput(float xOffset, float yOffset) {
     m_Input.mouseInput = glm::vec2(xOffset, yOffset);
     
     // Smooth mouse delta pour strafe efficiency calculation
     m_Input.mouseDelta = m_Input.mouseDelta * 0.8f + m_Input.mouseInput * 0.2f;
     
-    if (m_Camera) {
-        m_Camera->processMouseMovement(xOffset, yOffset);
-    }
+    addViewAngles(xOffset * Physics::MOUSE_SENSITIVITY, yOffset * Physics::MOUSE_SENSITIVITY);
 }
 
 void PlayerController::updateInputTiming(float deltaTime) {
@@ -90,8 +210,8 @@ void PlayerController::updatePhysics(float deltaTime) {
     // Update ground state
     updateGroundState();
 
-    // Footstep audio
-    if (m_AudioSystem && m_State.onGround) {
+    // Footstep audio (cadence is tracked even when silent so replays match)
+    if (m_State.onGround) {
         float distanceMoved = glm::length(m_State.position - m_LastFootstepPos);
         float timeSinceLastStep = m_GameTime - m_LastFootstepTime;
         
@@ -104,44 +224,48 @@ void PlayerController::updatePhysics(float deltaTime) {
         }
         
         if (distanceMoved >= stepDistance && timeSinceLastStep > 0.1f) {
-            Audio::SurfaceMaterial surface = Audio::SurfaceMaterial::CONCRETE;
-            
-            // Simple surface detection based on position
-            if (m_State.position.y <= Physics::PLAYER_HEIGHT + 0.1f) {
-                surface = Audio::SurfaceMaterial::CONCRETE;  // On ground
+            if (AudioSystem* sound = audio()) {
+                sound->onFootstep(m_State.position, getGroundSurface(), m_State.speed, true);
             }
             
-            m_AudioSystem->onFootstep(m_State.position, surface, m_State.speed, true);
-            
             m_LastFootstepTime = m_GameTime;
             m_LastFootstepPos = m_State.position;
         }
     }
     
     // Jump audio
-    static bool wasOnGround = true;
-    if (m_AudioSystem && !wasOnGround && m_State.onGround) {
+    AudioSystem* sound = audio();
+    if (sound && !m_WasOnGroundAudio && m_State.onGround) {
         // Just landed
-        float impactForce = std::min(1.0f, abs(m_State.previousVelocity.y) / 300.0f);
-        m_AudioSystem->onLand(m_State.position, impactForce, true);
-    } else if (m_AudioSystem && wasOnGround && !m_State.onGround && m_State.velocity.y > 100.0f) {
+        float impactForce = std::min(1.0f, std::fabs(m_State.previousVelocity.y) / 300.0f);
+        sound->onLand(m_State.position, impactForce, true);
+    } else if (sound && m_WasOnGroundAudio && !m_State.onGround && m_State.velocity.y > 100.0f) {
         // Just jumped
-        m_AudioSystem->onJump(m_State.position, true);
+        sound->onJump(m_State.position, true);
     }
-    wasOnGround = m_State.onGround;
-    
-    // Handle jump avec timing optimisé
-    if (m_State.wishJump) {
+    m_WasOnGroundAudio = m_State.onGround;
+    
+    // Handle jump at its sub-tick time: keep walking until the press, then
+    // jump for the rest of the tick. Presses in a later tick wait for it.
+    float remaining = deltaTime;
+    if (m_State.wishJump && m_State.wishJumpTick <= m_Tick) {
+        float beforeJump = (m_State.wishJumpTick == m_Tick) ? m_State.wishJumpFraction * deltaTime : 0.0f;
+        if (beforeJump > 0.0f && m_State.onGround) {
+            handleGroundMovement(beforeJump);
+            applyGravity(beforeJump);
+            applyMovement(beforeJump);
+            remaining -= beforeJump;
+        }
         handleBunnyHop();
         m_State.wishJump = false;
     }
     
     // Apply movement
     if (m_State.onGround) {
-        handleGroundMovement(deltaTime);
+        handleGroundMovement(remaining);
     } else {
-        handleAirMovement(deltaTime);
-        m_State.airTime += deltaTime;
+        handleAirMovement(remaining);
+        m_State.airTime += remaining;
     }
     
     // Reset air time when landing
@@ -149,8 +273,8 @@ void PlayerController::updatePhysics(float deltaTime) {
         m_State.airTime = 0.0f;
     }
     
-    applyGravity(deltaTime);
-    applyMovement(deltaTime);
+    applyGravity(remaining);
+    applyMovement(remaining);
     
     // Update performance metrics
     glm::vec3 horizontalVel = glm::vec3(m_State.velocity.x, 0.0f, m_State.velocity.z);
@@ -189,7 +313,7 @@ void PlayerController::optimizeAirMovement(const glm::vec3& wishDir, float delta
     // Optimal strafe jumping: 30-45 degrees
     if (angle >= 20.0f && angle <= 60.0f) {
         // Bonus acceleration pour bon angle
-        float angleFactor = 1.0f - abs(angle - Physics::OPTIMAL_STRAFE_ANGLE) / 30.0f;
+        float angleFactor = 1.0f - std::fabs(angle - Physics::OPTIMAL_STRAFE_ANGLE) / 30.0f;
         angleFactor = std::max(0.5f, angleFactor);
         
         float effectiveAccel = Physics::AIR_ACCELERATION * (1.0f + angleFactor * 0.5f);
@@ -215,9 +339,10 @@ void PlayerController::handleBunnyHop() {
         m_State.onGround = false;
         m_State.consecutiveHops++;
         
-        std::cout << "Bhop #" << m_State.consecutiveHops 
-                  << " | Speed: " << m_State.speed 
-                  << " | Efficiency: " << (m_State.strafeEfficiency * 100.0f) << "%" << std::endl;
+        if (!m_Replaying) {
+            TS_LOG_INFO("Bhop #{} | Speed: {} | Efficiency: {}%",
+                        m_State.consecutiveHops, m_State.speed, m_State.strafeEfficiency * 100.0f);
+        }
     } else if (m_State.airTime < 0.1f) {
         // Pre-speed: jump buffering
         m_State.wishJump = true; // Keep trying
@@ -250,11 +375,10 @@ void PlayerController::handleGroundMovement(float deltaTime) {
     
     // Reset consecutive hops if we stay on ground too long
     if (m_State.wasOnGround && m_State.onGround) {
-        static float groundTime = 0.0f;
-        groundTime += deltaTime;
-        if (groundTime > 0.2f) { // 200ms tolerance
+        m_GroundTime += deltaTime;
+        if (m_GroundTime > 0.2f) { // 200ms tolerance
             m_State.consecutiveHops = 0;
-            groundTime = 0.0f;
+            m_GroundTime = 0.0f;
         }
     }
     
@@ -274,9 +398,8 @@ glm::vec3 PlayerController::calculateWishDirection() const {
         return glm::vec3(0.0f);
     }
     
-    glm::vec3 forward = m_Camera->getForward();
-    forward.y = 0.0f;
-    forward = glm::normalize(forward);
+    // Yaw only: looking up or down doesn't slow horizontal movement
+    glm::vec3 forward(cos(glm::radians(m_Yaw)), 0.0f, sin(glm::radians(m_Yaw)));
     
     glm::vec3 right = glm::normalize(glm::cross(forward, glm::vec3(0, 1, 0)));
     
@@ -330,7 +453,45 @@ void PlayerController::applyGravity(float deltaTime) {
     }
 }
 
+Audio::SurfaceMaterial PlayerController::getGroundSurface() {
+    if (!m_World) return Audio::SurfaceMaterial::CONCRETE;   // Flat test arena
+
+    glm::vec3 feet = m_State.position - glm::vec3(0.0f, Physics::PLAYER_HEIGHT, 0.0f);
+    int32_t cellX = static_cast<int32_t>(std::floor(feet.x / Physics::GROUND_CELL_SIZE));
+    int32_t cellY = static_cast<int32_t>(std::floor(feet.y / Physics::STEP_HEIGHT));
+    int32_t cellZ = static_cast<int32_t>(std::floor(feet.z / Physics::GROUND_CELL_SIZE));
+    GroundCache& cache = m_GroundCache;
+    if (cache.valid && cache.cellX == cellX && cache.cellY == cellY && cache.cellZ == cellZ) {
+        return cache.surface;
+    }
+
+    // Ray from a step above the feet, so a ledge just climbed still counts
+    GroundSample ground;
+    glm::vec3 origin = feet + glm::vec3(0.0f, Physics::STEP_HEIGHT, 0.0f);
+    if (m_World->traceGround(origin, Physics::STEP_HEIGHT + Physics::GROUND_TRACE_DISTANCE, ground)) {
+        cache.surface = static_cast<Audio::SurfaceMaterial>(ground.material);
+    } else {
+        cache.surface = Audio::SurfaceMaterial::CONCRETE;
+    }
+    cache.valid = true;
+    cache.cellX = cellX;
+    cache.cellY = cellY;
+    cache.cellZ = cellZ;
+    return cache.surface;
+}
+
 void PlayerController::updateGroundState() {
+    if (m_World) {
+        SweepHit ground;
+        glm::vec3 feet = m_State.position - glm::vec3(0.0f, Physics::PLAYER_HEIGHT, 0.0f);
+        m_State.onGround = m_World->findGround(feet, Physics::GROUND_TOLERANCE, ground);
+        if (m_State.onGround && m_State.velocity.y <= 0.0f) {
+            m_State.velocity.y = 0.0f;
+            m_State.position.y -= Physics::GROUND_TOLERANCE * ground.fraction - Physics::COLLISION_SKIN;
+        }
+        return;
+    }
+
     m_State.onGround = checkGroundCollision(m_State.position);
     
     if (m_State.onGround && m_State.velocity.y <= 0.0f) {
@@ -340,6 +501,18 @@ void PlayerController::updateGroundState() {
 }
 
 void PlayerController::applyMovement(float deltaTime) {
+    if (m_World) {
+        // Position is the eye; the collision capsule stands below it
+        glm::vec3 eyeOffset(0.0f, Physics::PLAYER_HEIGHT, 0.0f);
+        SlideResult result = m_World->moveAndSlide(m_State.position - eyeOffset, m_State.velocity,
+                                                   deltaTime, m_State.onGround);
+        m_State.position = result.position + eyeOffset;
+        m_State.velocity = result.velocity;
+        m_State.hitWall = result.hitWall;
+        if (result.hitWall) m_State.wallNormal = result.wallNormal;
+        return;
+    }
+
     glm::vec3 newPosition = m_State.position + m_State.velocity * deltaTime;
     newPosition = resolveCollisions(newPosition);
     m_State.position = newPosition;
@@ -400,6 +573,9 @@ void PlayerController::handleWallCollision(const glm::vec3& wallNormal) {
         glm::vec3 reflection = m_State.velocity - 2.0f * glm::dot(m_State.velocity, wallNormal) * wallNormal;
         m_State.velocity = reflection * Physics::WALL_BOUNCE_FACTOR;
         
-        std::cout << "Wall bounce! Speed: " << speed << " → " << glm::length(glm::vec3(m_State.velocity.x, 0.0f, m_State.velocity.z)) << std::endl;
+        if (!m_Replaying) {
+            TS_LOG_INFO("Wall bounce! Speed: {} → {}", speed,
+                        glm::length(glm::vec3(m_State.velocity.x, 0.0f, m_State.velocity.z)));
+        }
     }
 }
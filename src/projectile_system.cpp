@@ -0,0 +1,329 @@
+#include "projectile_system.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace {
+    const ProjectileSpec SPECS[] = {
+        // name          radius  fuse   elast. friction onGround atRest
+        { "he_grenade",  0.1f,   1.6f,  0.45f, 0.2f,    false,   false },
+        { "flashbang",   0.1f,   1.6f,  0.45f, 0.2f,    false,   false },
+        { "smoke",       0.12f,  15.0f, 0.4f,  0.25f,   false,   true  },   // Fuse is only a lifetime cap
+        { "molotov",     0.1f,   2.0f,  0.3f,  0.3f,    true,    false },
+    };
+    static_assert(sizeof(SPECS) / sizeof(SPECS[0]) == static_cast<size_t>(ProjectileKind::COUNT),
+                  "One spec per ProjectileKind");
+
+    // Level sweep, or the flat test floor when there is no level
+    bool sweepLevel(const CollisionWorld* world, const glm::vec3& center, float radius,
+                    const glm::vec3& delta, SweepHit& hit) {
+        if (world) return world->sweepSphere(center, radius, delta, hit);
+
+        hit = SweepHit();
+        float end = center.y + delta.y;
+        if (end >= radius || delta.y >= 0.0f) return false;
+        hit.hit = true;
+        hit.fraction = std::max(0.0f, (center.y - radius) / -delta.y);
+        hit.normal = glm::vec3(0.0f, 1.0f, 0.0f);
+        hit.point = center + delta * hit.fraction - glm::vec3(0.0f, radius, 0.0f);
+        return true;
+    }
+
+    // 8-unit cells of a 16 x 16 grid that wraps, in Morton order: nearby
+    // projectiles get nearby keys
+    uint16_t cellKey(float x, float z) {
+        auto spread = [](float v) {
+            uint32_t bits = static_cast<uint32_t>(static_cast<int32_t>(std::floor(v * 0.125f))) & 15u;
+            bits = (bits | (bits << 2)) & 0x33u;
+            return (bits | (bits << 1)) & 0x55u;
+        };
+        return static_cast<uint16_t>(spread(x) | (spread(z) << 1));
+    }
+}
+
+const ProjectileSpec& ProjectileSystem::getSpec(ProjectileKind kind) {
+    return SPECS[static_cast<uint32_t>(kind)];
+}
+
+bool ProjectileSystem::spawn(ProjectileKind kind, const glm::vec3& position, const glm::vec3& velocity, uint32_t owner) {
+    if (m_Count == CAPACITY || kind >= ProjectileKind::COUNT) return false;
+
+    uint32_t i = m_Count++;
+    m_PosX[i] = position.x; m_PosY[i] = position.y; m_PosZ[i] = position.z;
+    m_VelX[i] = velocity.x; m_VelY[i] = velocity.y; m_VelZ[i] = velocity.z;
+    m_Fuse[i] = getSpec(kind).fuse;
+    m_Kind[i] = kind;
+    m_Owner[i] = owner;
+    m_Detonate[i] = false;
+    m_AtRest[i] = false;
+    return true;
+}
+
+void ProjectileSystem::clear() {
+    m_Count = 0;
+    m_EventCount = 0;
+    m_TimeAccumulator = 0.0f;
+}
+
+void ProjectileSystem::update(float deltaTime) {
+    m_EventCount = 0;
+    m_TimeAccumulator += deltaTime;
+
+    int steps = 0;
+    while (m_TimeAccumulator >= Physics::FIXED_TIMESTEP && steps < Physics::MAX_STEPS_PER_FRAME) {
+        step(Physics::FIXED_TIMESTEP);
+        m_TimeAccumulator -= Physics::FIXED_TIMESTEP;
+        ++steps;
+    }
+    // Same policy as the player: a long stall is dropped, not caught up
+    if (m_TimeAccumulator >= Physics::FIXED_TIMESTEP) {
+        m_TimeAccumulator = std::fmod(m_TimeAccumulator, Physics::FIXED_TIMESTEP);
+    }
+}
+
+void ProjectileSystem::step(float deltaTime) {
+    if (m_Count == 0) return;
+    integrate(deltaTime);
+    sortByCell();
+
+    // Every projectile's first sweep, the free ones moved four at a time
+    sweepBatch(m_Count);
+    for (uint32_t i = 0; i < m_Count; ++i) {
+        m_Free[i] = m_Hits[i].hit ? 0.0f : 1.0f;
+        if (!m_Hits[i].hit) m_AtRest[i] = false;        // In flight: nothing to roll on
+    }
+    advance();
+
+    // Then rounds of the ones still moving after a contact, each one batch
+    // of sweeps, up to MAX_BOUNCES_PER_TICK contacts. m_Order keeps cell
+    // order as it shrinks.
+    uint32_t moving = 0;
+    for (uint32_t k = 0; k < m_Count; ++k) {
+        uint32_t i = m_Order[k];
+        if (!m_Hits[i].hit) continue;
+        m_Remaining[i] = deltaTime;
+        m_Grounded[i] = false;
+        if (bounce(i, m_Hits[i])) m_Order[moving++] = static_cast<uint16_t>(i);
+        else settle(i, deltaTime);
+    }
+    for (int round = 1; round < MAX_BOUNCES_PER_TICK && moving > 0; ++round) {
+        const uint32_t count = moving;
+        sweepBatch(count);
+        moving = 0;
+        for (uint32_t k = 0; k < count; ++k) {
+            uint32_t i = m_Order[k];
+            if (!m_Hits[i].hit) {
+                m_PosX[i] += m_DeltaX[i]; m_PosY[i] += m_DeltaY[i]; m_PosZ[i] += m_DeltaZ[i];
+                settle(i, deltaTime);
+            } else if (bounce(i, m_Hits[i]) && round + 1 < MAX_BOUNCES_PER_TICK) {
+                m_Order[moving++] = static_cast<uint16_t>(i);
+            } else {
+                settle(i, deltaTime);
+            }
+        }
+    }
+    // The last round's survivors are out of contacts for this tick
+    for (uint32_t k = 0; k < moving; ++k) settle(m_Order[k], deltaTime);
+    expire();
+}
+
+void ProjectileSystem::stepReference(float deltaTime) {
+    if (m_Count == 0) return;
+    const float gravityStep = Physics::GRAVITY * Physics::GRENADE_GRAVITY_SCALE * deltaTime;
+    for (uint32_t i = 0; i < m_Count; ++i) {
+        m_VelY[i] -= gravityStep;
+        m_Fuse[i] -= deltaTime;
+        sweep(i, deltaTime);
+    }
+    expire();
+}
+
+void ProjectileSystem::integrate(float dt) {
+    const float gravityStep = Physics::GRAVITY * Physics::GRENADE_GRAVITY_SCALE * dt;
+
+    uint32_t i = 0;
+#if defined(__SSE2__)
+    const __m128 gravity = _mm_set1_ps(gravityStep);
+    const __m128 dtv = _mm_set1_ps(dt);
+    for (; i + 4 <= m_Count; i += 4) {
+        __m128 velY = _mm_sub_ps(_mm_load_ps(&m_VelY[i]), gravity);
+        _mm_store_ps(&m_VelY[i], velY);
+        _mm_store_ps(&m_Fuse[i], _mm_sub_ps(_mm_load_ps(&m_Fuse[i]), dtv));
+        _mm_store_ps(&m_DeltaX[i], _mm_mul_ps(_mm_load_ps(&m_VelX[i]), dtv));
+        _mm_store_ps(&m_DeltaY[i], _mm_mul_ps(velY, dtv));
+        _mm_store_ps(&m_DeltaZ[i], _mm_mul_ps(_mm_load_ps(&m_VelZ[i]), dtv));
+    }
+#endif
+    for (; i < m_Count; ++i) {
+        m_VelY[i] -= gravityStep;
+        m_Fuse[i] -= dt;
+        m_DeltaX[i] = m_VelX[i] * dt;
+        m_DeltaY[i] = m_VelY[i] * dt;
+        m_DeltaZ[i] = m_VelZ[i] * dt;
+    }
+}
+
+void ProjectileSystem::sortByCell() {
+    // Counting sort on the cell key, stable so equal cells keep pool order
+    uint16_t cellStart[CELL_KEYS + 1] = {};
+    for (uint32_t i = 0; i < m_Count; ++i) {
+        m_Cell[i] = cellKey(m_PosX[i], m_PosZ[i]);
+        ++cellStart[m_Cell[i] + 1];
+    }
+    for (uint32_t c = 0; c < CELL_KEYS; ++c) cellStart[c + 1] += cellStart[c];
+    for (uint32_t i = 0; i < m_Count; ++i) m_Order[cellStart[m_Cell[i]]++] = static_cast<uint16_t>(i);
+}
+
+void ProjectileSystem::sweepBatch(uint32_t count) {
+    if (!m_World) {
+        for (uint32_t k = 0; k < count; ++k) {
+            uint32_t i = m_Order[k];
+            sweepLevel(nullptr, getPosition(i), getSpec(m_Kind[i]).radius,
+                       glm::vec3(m_DeltaX[i], m_DeltaY[i], m_DeltaZ[i]), m_Hits[i]);
+        }
+        return;
+    }
+
+    const uint32_t packet = CollisionWorld::MAX_PACKET_SPHERES;
+    glm::vec3 centers[packet], deltas[packet];
+    float radii[packet];
+    SweepHit hits[packet];
+    for (uint32_t first = 0; first < count; first += packet) {
+        const uint32_t n = std::min(packet, count - first);
+        for (uint32_t k = 0; k < n; ++k) {
+            uint32_t i = m_Order[first + k];
+            centers[k] = getPosition(i);
+            deltas[k] = glm::vec3(m_DeltaX[i], m_DeltaY[i], m_DeltaZ[i]);
+            radii[k] = getSpec(m_Kind[i]).radius;
+        }
+        m_World->sweepSpherePacket(centers, radii, deltas, n, hits);
+        for (uint32_t k = 0; k < n; ++k) m_Hits[m_Order[first + k]] = hits[k];
+    }
+}
+
+void ProjectileSystem::advance() {
+    // Whole move for the free ones; the rest move in bounce()
+    uint32_t i = 0;
+#if defined(__SSE2__)
+    for (; i + 4 <= m_Count; i += 4) {
+        __m128 free = _mm_load_ps(&m_Free[i]);
+        _mm_store_ps(&m_PosX[i], _mm_add_ps(_mm_load_ps(&m_PosX[i]), _mm_mul_ps(_mm_load_ps(&m_DeltaX[i]), free)));
+        _mm_store_ps(&m_PosY[i], _mm_add_ps(_mm_load_ps(&m_PosY[i]), _mm_mul_ps(_mm_load_ps(&m_DeltaY[i]), free)));
+        _mm_store_ps(&m_PosZ[i], _mm_add_ps(_mm_load_ps(&m_PosZ[i]), _mm_mul_ps(_mm_load_ps(&m_DeltaZ[i]), free)));
+    }
+#endif
+    for (; i < m_Count; ++i) {
+        m_PosX[i] += m_DeltaX[i] * m_Free[i];
+        m_PosY[i] += m_DeltaY[i] * m_Free[i];
+        m_PosZ[i] += m_DeltaZ[i] * m_Free[i];
+    }
+}
+
+void ProjectileSystem::sweep(uint32_t i, float dt) {
+    const ProjectileSpec& spec = getSpec(m_Kind[i]);
+    glm::vec3 delta = getVelocity(i) * dt;
+    m_DeltaX[i] = delta.x; m_DeltaY[i] = delta.y; m_DeltaZ[i] = delta.z;
+    m_Remaining[i] = dt;
+    m_Grounded[i] = false;
+
+    SweepHit hit;
+    if (!sweepLevel(m_World, getPosition(i), spec.radius, delta, hit)) {
+        m_PosX[i] += delta.x; m_PosY[i] += delta.y; m_PosZ[i] += delta.z;
+        m_AtRest[i] = false;
+        return;
+    }
+    for (int contact = 1; bounce(i, hit) && contact < MAX_BOUNCES_PER_TICK; ++contact) {
+        delta = glm::vec3(m_DeltaX[i], m_DeltaY[i], m_DeltaZ[i]);
+        if (!sweepLevel(m_World, getPosition(i), spec.radius, delta, hit)) {
+            m_PosX[i] += delta.x; m_PosY[i] += delta.y; m_PosZ[i] += delta.z;
+            break;
+        }
+    }
+    settle(i, dt);
+}
+
+bool ProjectileSystem::bounce(uint32_t i, const SweepHit& hit) {
+    const ProjectileSpec& spec = getSpec(m_Kind[i]);
+    glm::vec3 pos(m_PosX[i], m_PosY[i], m_PosZ[i]);
+    glm::vec3 vel(m_VelX[i], m_VelY[i], m_VelZ[i]);
+    glm::vec3 delta(m_DeltaX[i], m_DeltaY[i], m_DeltaZ[i]);
+
+    pos += delta * hit.fraction + hit.normal * Physics::COLLISION_SKIN;
+    m_Remaining[i] *= 1.0f - hit.fraction;
+
+    float intoSurface = -glm::dot(vel, hit.normal);
+    if (intoSurface > 0.0f) {                   // Otherwise a grazing contact, already leaving
+        bool walkable = hit.normal.y >= Physics::WALKABLE_NORMAL_Y;
+        glm::vec3 normalPart = -hit.normal * intoSurface;
+        glm::vec3 tangent = vel - normalPart;
+        if (walkable && intoSurface < Physics::GRENADE_REST_SPEED) {
+            // Settled on the floor: roll instead of bouncing in place
+            vel = tangent;
+            m_Grounded[i] = true;
+        } else {
+            vel = tangent * (1.0f - spec.friction) - normalPart * spec.elasticity;
+            uint8_t material = m_World ? m_World->getMaterial(hit.triangle) : 0;
+            pushEvent(ProjectileEvent::Type::Bounce, i, pos, material, intoSurface);
+            if (walkable && spec.detonateOnGround) m_Detonate[i] = true;
+        }
+    }
+
+    delta = vel * m_Remaining[i];
+    m_PosX[i] = pos.x; m_PosY[i] = pos.y; m_PosZ[i] = pos.z;
+    m_VelX[i] = vel.x; m_VelY[i] = vel.y; m_VelZ[i] = vel.z;
+    m_DeltaX[i] = delta.x; m_DeltaY[i] = delta.y; m_DeltaZ[i] = delta.z;
+    return m_Remaining[i] > 0.0f;
+}
+
+void ProjectileSystem::settle(uint32_t i, float dt) {
+    glm::vec3 vel(m_VelX[i], m_VelY[i], m_VelZ[i]);
+    if (m_Grounded[i]) {
+        float speed = glm::length(vel);
+        float rolled = speed - Physics::GRENADE_ROLL_FRICTION * dt;
+        vel = rolled > Physics::GRENADE_STOP_SPEED ? vel * (rolled / speed) : glm::vec3(0.0f);
+    }
+    m_AtRest[i] = m_Grounded[i] && vel == glm::vec3(0.0f);
+    m_VelX[i] = vel.x; m_VelY[i] = vel.y; m_VelZ[i] = vel.z;
+}
+
+void ProjectileSystem::expire() {
+    // Backwards, so the projectile swapped into a hole has already been checked
+    for (uint32_t i = m_Count; i-- > 0;) {
+        bool detonate = m_Detonate[i] || m_Fuse[i] <= 0.0f ||
+                        (m_AtRest[i] && getSpec(m_Kind[i]).detonateAtRest);
+        if (!detonate) continue;
+        pushEvent(ProjectileEvent::Type::Detonate, i, getPosition(i), 0, 0.0f);
+        remove(i);
+    }
+}
+
+void ProjectileSystem::remove(uint32_t i) {
+    uint32_t last = --m_Count;
+    if (i == last) return;
+    m_PosX[i] = m_PosX[last]; m_PosY[i] = m_PosY[last]; m_PosZ[i] = m_PosZ[last];
+    m_VelX[i] = m_VelX[last]; m_VelY[i] = m_VelY[last]; m_VelZ[i] = m_VelZ[last];
+    m_Fuse[i] = m_Fuse[last];
+    m_Kind[i] = m_Kind[last];
+    m_Owner[i] = m_Owner[last];
+    m_Detonate[i] = m_Detonate[last];
+    m_AtRest[i] = m_AtRest[last];
+}
+
+void ProjectileSystem::pushEvent(ProjectileEvent::Type type, uint32_t i, const glm::vec3& position,
+                                 uint8_t material, float speed) {
+    if (m_EventCount == MAX_EVENTS) {
+        ++m_DroppedEvents;
+        return;
+    }
+    ProjectileEvent& event = m_Events[m_EventCount++];
+    event.type = type;
+    event.kind = m_Kind[i];
+    event.material = material;
+    event.owner = m_Owner[i];
+    event.position = position;
+    event.speed = speed;
+}
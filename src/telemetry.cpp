@@ -0,0 +1,193 @@
+#include "telemetry.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <mutex>
+#include <thread>
+
+namespace Telemetry {
+
+namespace {
+    static_assert((RING_CAPACITY & (RING_CAPACITY - 1)) == 0, "RING_CAPACITY must be a power of two");
+
+    // Lifetime of a ring: claimed by a thread, released when that thread
+    // exits, and handed out again once the drain has emptied it
+    enum RingState : uint32_t { RING_FREE, RING_OWNED, RING_RELEASED };
+
+    // Single producer (the owning thread), single consumer (the drain)
+    struct Ring {
+        alignas(64) std::atomic<uint32_t> head{0};     // Next slot to write
+        alignas(64) std::atomic<uint32_t> tail{0};     // Next slot to read
+        std::atomic<uint32_t> dropped{0};
+        std::atomic<uint32_t> state{RING_FREE};
+        Record records[RING_CAPACITY];
+    };
+
+    // Static storage: claiming a ring never allocates
+    Ring g_Rings[MAX_THREADS];
+    std::atomic<uint32_t> g_Overflow{0};        // Records from threads without a ring
+
+    std::thread g_Drain;
+    std::atomic<bool> g_Running{false};
+    std::mutex g_DrainMutex;                    // flush() vs the drain thread, never taken by producers
+
+    // Gives the ring back when the owning thread exits
+    struct RingLease {
+        Ring* ring = nullptr;
+        ~RingLease() {
+            if (ring) ring->state.store(RING_RELEASED, std::memory_order_release);
+        }
+    };
+    thread_local RingLease t_Lease;
+
+    Ring* threadRing() {
+        if (t_Lease.ring) return t_Lease.ring;
+        // Without a ring the thread retries on every record, so it picks up
+        // the ring of the next thread to exit
+        for (Ring& ring : g_Rings) {
+            uint32_t expected = RING_FREE;
+            if (ring.state.compare_exchange_strong(expected, RING_OWNED, std::memory_order_acquire)) {
+                t_Lease.ring = &ring;
+                break;
+            }
+        }
+        return t_Lease.ring;
+    }
+
+    uint64_t nowNs() {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void appendArg(std::string& out, const Record& record, const Arg& arg) {
+        char buffer[32];
+        switch (arg.type) {
+        case Arg::Type::Int:
+            std::snprintf(buffer, sizeof(buffer), "%lld", static_cast<long long>(arg.i));
+            out += buffer;
+            break;
+        case Arg::Type::Uint:
+            std::snprintf(buffer, sizeof(buffer), "%llu", static_cast<unsigned long long>(arg.u));
+            out += buffer;
+            break;
+        case Arg::Type::Float:
+            std::snprintf(buffer, sizeof(buffer), "%g", arg.f);
+            out += buffer;
+            break;
+        case Arg::Type::Text:
+            out += record.text + arg.text;
+            break;
+        }
+    }
+
+    // "{}" takes the next argument; extra placeholders print as-is
+    void format(std::string& out, const Record& record) {
+        uint32_t next = 0;
+        for (const char* c = record.format; *c; ++c) {
+            if (c[0] == '{' && c[1] == '}' && next < record.argCount) {
+                appendArg(out, record, record.args[next++]);
+                ++c;
+            } else {
+                out += *c;
+            }
+        }
+        out += '\n';
+    }
+
+    // Formats whatever is in the rings; returns false if there was nothing
+    bool drainOnce(std::string& info, std::string& errors) {
+        bool any = false;
+        for (Ring& ring : g_Rings) {
+            // Read before head: a released ring's last record is then visible
+            uint32_t state = ring.state.load(std::memory_order_acquire);
+            if (state == RING_FREE) continue;
+            uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+            uint32_t head = ring.head.load(std::memory_order_acquire);
+            for (; tail != head; ++tail) {
+                const Record& record = ring.records[tail & (RING_CAPACITY - 1)];
+                format(record.level >= Level::Warn ? errors : info, record);
+                any = true;
+            }
+            ring.tail.store(tail, std::memory_order_release);
+
+            uint32_t dropped = ring.dropped.exchange(0, std::memory_order_relaxed);
+            if (dropped) errors += "[telemetry] dropped " + std::to_string(dropped) + " records (ring full)\n";
+            if (state == RING_RELEASED) ring.state.store(RING_FREE, std::memory_order_release);
+        }
+
+        uint32_t overflow = g_Overflow.exchange(0, std::memory_order_relaxed);
+        if (overflow) errors += "[telemetry] dropped " + std::to_string(overflow) + " records (too many threads)\n";
+
+        // One write per batch instead of a flush per line
+        if (!info.empty()) {
+            std::cout << info;
+            std::cout.flush();
+            info.clear();
+        }
+        if (!errors.empty()) {
+            std::cerr << errors;
+            errors.clear();
+        }
+        return any;
+    }
+
+    void drainLoop() {
+        std::string info, errors;
+        info.reserve(16 * 1024);
+        while (g_Running.load(std::memory_order_acquire)) {
+            bool any;
+            {
+                std::lock_guard<std::mutex> lock(g_DrainMutex);
+                any = drainOnce(info, errors);
+            }
+            if (!any) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+}
+
+Record* beginRecord(Level level, const char* format) {
+    Ring* ring = threadRing();
+    if (!ring) {
+        g_Overflow.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    uint32_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= RING_CAPACITY) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    Record& record = ring->records[head & (RING_CAPACITY - 1)];
+    record.timestampNs = nowNs();
+    record.format = format;
+    record.level = level;
+    record.argCount = 0;
+    record.textUsed = 0;
+    return &record;
+}
+
+void commitRecord() {
+    // Only reached after a successful beginRecord on this thread
+    t_Lease.ring->head.fetch_add(1, std::memory_order_release);
+}
+
+void start() {
+    if (g_Running.exchange(true)) return;
+    g_Drain = std::thread(drainLoop);
+}
+
+void stop() {
+    if (g_Running.exchange(false)) g_Drain.join();
+    flush();
+}
+
+void flush() {
+    std::lock_guard<std::mutex> lock(g_DrainMutex);
+    std::string info, errors;
+    drainOnce(info, errors);
+}
+
+} // namespace Telemetry
@@ -0,0 +1,474 @@
+#include "weapon_data.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <new>
+#include <sstream>
+#include <type_traits>
+
+#ifdef _WIN32
+    #define NOMINMAX
+    #define WIN32_LEAN_AND_MEAN
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+static_assert(sizeof(WeaponData::Header) == 24, "Header is written to disk as-is");
+static_assert(sizeof(Weapons::RecoilPoint) == 16, "RecoilPoint is written to disk as-is");
+static_assert(std::is_standard_layout<Weapons::WeaponConfig>::value, "WeaponConfig is read in place");
+
+namespace {
+    using Weapons::WeaponConfig;
+    using Weapons::WeaponStats;
+    using Weapons::RecoilPoint;
+
+    // FNV-1a over raw bytes, like the recording checksums
+    uint64_t hashBytes(const uint8_t* bytes, size_t size) {
+        uint64_t hash = 14695981039346656037ull;
+        for (size_t i = 0; i < size; ++i) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    const char* const WEAPON_TYPES[] = { "RIFLE", "SMG", "SNIPER", "PISTOL", "SHOTGUN", "LMG" };
+    const char* const FIRE_MODES[] = { "SEMI_AUTO", "FULL_AUTO", "BURST", "BOLT_ACTION" };
+    const int WEAPON_TYPE_COUNT = sizeof(WEAPON_TYPES) / sizeof(WEAPON_TYPES[0]);
+    const int FIRE_MODE_COUNT = sizeof(FIRE_MODES) / sizeof(FIRE_MODES[0]);
+
+    // WeaponStats members by their text name
+    enum class FieldType { Float, Int, FireMode };
+    struct Field {
+        const char* name;
+        size_t offset;
+        FieldType type;
+    };
+#define STAT_FIELD(member, type) { #member, offsetof(WeaponStats, member), FieldType::type }
+    const Field STAT_FIELDS[] = {
+        STAT_FIELD(baseDamage, Float),
+        STAT_FIELD(headshotMultiplier, Float),
+        STAT_FIELD(chestMultiplier, Float),
+        STAT_FIELD(limbMultiplier, Float),
+        STAT_FIELD(optimalRange, Float),
+        STAT_FIELD(maxRange, Float),
+        STAT_FIELD(minDamagePercent, Float),
+        STAT_FIELD(baseSpread, Float),
+        STAT_FIELD(movingSpread, Float),
+        STAT_FIELD(jumpingSpread, Float),
+        STAT_FIELD(crouchingSpread, Float),
+        STAT_FIELD(pelletCount, Int),
+        STAT_FIELD(pelletSpread, Float),
+        STAT_FIELD(penetration, Float),
+        STAT_FIELD(recoilMagnitude, Float),
+        STAT_FIELD(recoilRecovery, Float),
+        STAT_FIELD(recoilRandomness, Float),
+        STAT_FIELD(fireRate, Float),
+        STAT_FIELD(fireMode, FireMode),
+        STAT_FIELD(magazineSize, Int),
+        STAT_FIELD(reserveAmmo, Int),
+        STAT_FIELD(reloadTime, Float),
+        STAT_FIELD(tacticalReloadTime, Float),
+        STAT_FIELD(movementSpeedMultiplier, Float),
+        STAT_FIELD(adsSpeedMultiplier, Float),
+        STAT_FIELD(adsTime, Float),
+        STAT_FIELD(adsSpreadReduction, Float),
+        STAT_FIELD(adsFOVMultiplier, Float),
+    };
+#undef STAT_FIELD
+
+    struct Definition {
+        std::string key;
+        std::string name;
+        Weapons::WeaponType type = Weapons::WeaponType::RIFLE;
+        WeaponStats stats;
+        std::vector<RecoilPoint> recoil;
+    };
+
+    std::string trim(const std::string& text) {
+        size_t begin = text.find_first_not_of(" \t\r");
+        if (begin == std::string::npos) return std::string();
+        size_t end = text.find_last_not_of(" \t\r");
+        return text.substr(begin, end - begin + 1);
+    }
+
+    bool parseFloats(const std::string& text, float* values, int count) {
+        std::istringstream in(text);
+        for (int i = 0; i < count; ++i) {
+            if (!(in >> values[i])) return false;
+        }
+        std::string rest;
+        return !(in >> rest);
+    }
+
+    int lookup(const char* const* names, int count, const std::string& value) {
+        for (int i = 0; i < count; ++i) {
+            if (value == names[i]) return i;
+        }
+        return -1;
+    }
+
+    // Procedural pattern for weapons without a hand-made one: strongest
+    // vertical kick first, horizontal swing decaying over the magazine
+    void appendControlledPattern(float verticalStrength, float horizontalVariation, int patternLength,
+                                 std::vector<RecoilPoint>& pattern) {
+        for (int i = 0; i < patternLength; ++i) {
+            float progress = patternLength > 1 ? float(i) / float(patternLength - 1) : 0.0f;
+            float vertical = verticalStrength * (1.0f - progress * 0.3f);
+            float horizontal = static_cast<float>(horizontalVariation * std::sin(double(progress * 6.28f)) *
+                                                  (1.0f - progress * 0.5f));
+            pattern.push_back({ glm::vec2(horizontal, vertical), i * 0.1f, 8.0f });
+        }
+    }
+
+    bool setProperty(Definition& weapon, const std::string& property, const std::string& value, std::string& error) {
+        if (property == "name") {
+            if (value.empty() || value.size() >= sizeof(WeaponConfig::name)) {
+                error = "name must be 1 to " + std::to_string(sizeof(WeaponConfig::name) - 1) + " characters";
+                return false;
+            }
+            weapon.name = value;
+            return true;
+        }
+        if (property == "type") {
+            int type = lookup(WEAPON_TYPES, WEAPON_TYPE_COUNT, value);
+            if (type < 0) {
+                error = "unknown weapon type '" + value + "'";
+                return false;
+            }
+            weapon.type = static_cast<Weapons::WeaponType>(type);
+            return true;
+        }
+        if (property == "recoil") {
+            // x y timeOffset resetSpeed
+            float v[4];
+            if (!parseFloats(value, v, 4)) {
+                error = "recoil expects 'x y timeOffset resetSpeed'";
+                return false;
+            }
+            weapon.recoil.push_back({ glm::vec2(v[0], v[1]), v[2], v[3] });
+            return true;
+        }
+        if (property == "recoilControlled") {
+            // verticalStrength horizontalVariation length
+            float v[3];
+            if (!parseFloats(value, v, 3) || v[2] < 1.0f || v[2] != std::floor(v[2])) {
+                error = "recoilControlled expects 'vertical horizontal length'";
+                return false;
+            }
+            appendControlledPattern(v[0], v[1], static_cast<int>(v[2]), weapon.recoil);
+            return true;
+        }
+
+        for (const Field& field : STAT_FIELDS) {
+            if (property != field.name) continue;
+            char* target = reinterpret_cast<char*>(&weapon.stats) + field.offset;
+            if (field.type == FieldType::FireMode) {
+                int mode = lookup(FIRE_MODES, FIRE_MODE_COUNT, value);
+                if (mode < 0) {
+                    error = "unknown fire mode '" + value + "'";
+                    return false;
+                }
+                Weapons::FireMode fireMode = static_cast<Weapons::FireMode>(mode);
+                std::memcpy(target, &fireMode, sizeof(fireMode));
+                return true;
+            }
+            float number;
+            if (!parseFloats(value, &number, 1)) {
+                error = property + " expects a number";
+                return false;
+            }
+            if (field.type == FieldType::Int) {
+                if (number != std::floor(number)) {
+                    error = property + " expects a whole number";
+                    return false;
+                }
+                int whole = static_cast<int>(number);
+                std::memcpy(target, &whole, sizeof(whole));
+            } else {
+                std::memcpy(target, &number, sizeof(number));
+            }
+            return true;
+        }
+
+        error = "unknown property '" + property + "'";
+        return false;
+    }
+
+    // What the weapon code divides by or scales with. Shared by the compiler
+    // and adopt(), so a hand-edited blob can't reach fireAt() with a zero
+    // fire rate. Comparisons are written so NaN fails them.
+    const char* checkStats(const WeaponStats& stats) {
+        for (const Field& field : STAT_FIELDS) {
+            if (field.type != FieldType::Float) continue;
+            float value;
+            std::memcpy(&value, reinterpret_cast<const char*>(&stats) + field.offset, sizeof(value));
+            if (!std::isfinite(value)) return "stats must be finite numbers";
+        }
+        if (static_cast<unsigned>(stats.fireMode) >= static_cast<unsigned>(FIRE_MODE_COUNT)) return "unknown fireMode";
+        if (stats.pelletCount < 1) return "pelletCount must be at least 1";
+        if (stats.magazineSize < 1) return "magazineSize must be at least 1";
+        if (stats.reserveAmmo < 0) return "reserveAmmo must not be negative";
+        if (!(stats.fireRate > 0.0f)) return "fireRate must be positive";
+        if (!(stats.adsTime > 0.0f)) return "adsTime must be positive";
+        if (!(stats.optimalRange >= 0.0f)) return "optimalRange must not be negative";
+        if (!(stats.maxRange > stats.optimalRange)) return "maxRange must exceed optimalRange";
+        if (!(stats.minDamagePercent >= 0.0f && stats.minDamagePercent <= 1.0f)) return "minDamagePercent must be within 0..1";
+        if (!(stats.baseDamage >= 0.0f)) return "baseDamage must not be negative";
+        if (!(stats.pelletSpread >= 0.0f)) return "pelletSpread must not be negative";
+        if (!(stats.penetration >= 0.0f)) return "penetration must not be negative";
+        if (!(stats.reloadTime >= 0.0f && stats.tacticalReloadTime >= 0.0f)) return "reload times must not be negative";
+        return nullptr;
+    }
+
+    bool validate(const Definition& weapon, std::string& error) {
+        const char* problem = checkStats(weapon.stats);
+        if (weapon.name.empty()) error = "has no name";
+        else if (problem) error = problem;
+        else return true;
+        error = "[" + weapon.key + "] " + error;
+        return false;
+    }
+}
+
+namespace WeaponData {
+
+bool compile(const std::string& source, std::vector<uint8_t>& blob, std::string& error) {
+    std::vector<Definition> weapons;
+    std::istringstream in(source);
+    std::string line;
+    for (int lineNumber = 1; std::getline(in, line); ++lineNumber) {
+        size_t comment = line.find('#');
+        if (comment != std::string::npos) line.erase(comment);
+        line = trim(line);
+        if (line.empty()) continue;
+
+        std::string problem;
+        if (line.front() == '[') {
+            std::string key = line.back() == ']' ? trim(line.substr(1, line.size() - 2)) : std::string();
+            if (key.empty() || key.size() >= sizeof(WeaponConfig::key)) {
+                problem = "expected [key] of 1 to " + std::to_string(sizeof(WeaponConfig::key) - 1) + " characters";
+            } else {
+                for (const Definition& weapon : weapons) {
+                    if (weapon.key == key) problem = "duplicate weapon [" + key + "]";
+                }
+            }
+            if (problem.empty()) {
+                weapons.emplace_back();
+                weapons.back().key = key;
+            }
+        } else {
+            size_t equals = line.find('=');
+            if (equals == std::string::npos) {
+                problem = "expected 'property = value'";
+            } else if (weapons.empty()) {
+                problem = "property outside of a [weapon] section";
+            } else {
+                setProperty(weapons.back(), trim(line.substr(0, equals)), trim(line.substr(equals + 1)), problem);
+            }
+        }
+        if (!problem.empty()) {
+            error = "line " + std::to_string(lineNumber) + ": " + problem;
+            return false;
+        }
+    }
+
+    if (weapons.empty() || weapons.size() > MAX_WEAPONS) {
+        error = "expected 1 to " + std::to_string(MAX_WEAPONS) + " weapons";
+        return false;
+    }
+    size_t pointCount = 0;
+    for (const Definition& weapon : weapons) {
+        if (!validate(weapon, error)) return false;
+        pointCount += weapon.recoil.size();
+    }
+
+    const size_t recordsOffset = sizeof(Header);
+    const size_t pointsOffset = recordsOffset + weapons.size() * sizeof(WeaponConfig);
+    blob.assign(pointsOffset + pointCount * sizeof(RecoilPoint), 0);
+
+    size_t point = 0;
+    for (size_t i = 0; i < weapons.size(); ++i) {
+        const Definition& weapon = weapons[i];
+        const size_t recordOffset = recordsOffset + i * sizeof(WeaponConfig);
+        WeaponConfig* record = new (blob.data() + recordOffset) WeaponConfig();
+        std::memcpy(record->key, weapon.key.c_str(), weapon.key.size());
+        std::memcpy(record->name, weapon.name.c_str(), weapon.name.size());
+        record->type = weapon.type;
+        record->stats = weapon.stats;
+        record->recoilOffset = static_cast<uint32_t>(pointsOffset + point * sizeof(RecoilPoint) - recordOffset);
+        record->recoilCount = static_cast<uint32_t>(weapon.recoil.size());
+        if (!weapon.recoil.empty()) {
+            std::memcpy(blob.data() + pointsOffset + point * sizeof(RecoilPoint), weapon.recoil.data(),
+                        weapon.recoil.size() * sizeof(RecoilPoint));
+        }
+        point += weapon.recoil.size();
+    }
+
+    Header header;
+    header.magic = MAGIC;
+    header.version = VERSION;
+    header.count = static_cast<uint16_t>(weapons.size());
+    header.recordSize = sizeof(WeaponConfig);
+    header.size = static_cast<uint32_t>(blob.size());
+    header.hash = hashBytes(blob.data() + sizeof(Header), blob.size() - sizeof(Header));
+    std::memcpy(blob.data(), &header, sizeof(Header));
+    return true;
+}
+
+bool Library::open(const std::string& blobPath) {
+    close();
+#ifdef _WIN32
+    HANDLE file = CreateFileA(blobPath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        m_Error = "cannot open " + blobPath;
+        return false;
+    }
+    LARGE_INTEGER fileSize;
+    HANDLE mapping = nullptr;
+    void* view = nullptr;
+    if (GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0) {
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping) view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    }
+    if (!view) {
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        m_Error = "cannot map " + blobPath;
+        return false;
+    }
+    m_File = file;
+    m_MappingHandle = mapping;
+    m_Mapping = view;
+    m_MappingSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(blobPath.c_str(), O_RDONLY);
+    if (fd < 0) {
+        m_Error = "cannot open " + blobPath;
+        return false;
+    }
+    struct stat info;
+    void* view = MAP_FAILED;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        view = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    ::close(fd);                                // The mapping keeps the file alive
+    if (view == MAP_FAILED) {
+        m_Error = "cannot map " + blobPath;
+        return false;
+    }
+    m_Mapping = view;
+    m_MappingSize = static_cast<size_t>(info.st_size);
+#endif
+
+    if (adopt(static_cast<const uint8_t*>(m_Mapping), m_MappingSize)) return true;
+    close();
+    m_Error = blobPath + " is not a valid version " + std::to_string(VERSION) + " weapon blob";
+    return false;
+}
+
+bool Library::loadText(const std::string& textPath) {
+    close();
+    std::ifstream in(textPath);
+    if (!in) {
+        m_Error = "cannot open " + textPath;
+        return false;
+    }
+    std::stringstream source;
+    source << in.rdbuf();
+
+    std::string error;
+    if (!compile(source.str(), m_Compiled, error)) {
+        m_Compiled.clear();
+        m_Error = textPath + ": " + error;
+        return false;
+    }
+    return adopt(m_Compiled.data(), m_Compiled.size());
+}
+
+void Library::close() {
+    m_Error.clear();
+    m_Records = nullptr;
+    m_Count = 0;
+    m_Hash = 0;
+    m_Compiled.clear();
+    if (!m_Mapping) return;
+#ifdef _WIN32
+    UnmapViewOfFile(m_Mapping);
+    CloseHandle(static_cast<HANDLE>(m_MappingHandle));
+    CloseHandle(static_cast<HANDLE>(m_File));
+    m_File = nullptr;
+    m_MappingHandle = nullptr;
+#else
+    munmap(m_Mapping, m_MappingSize);
+#endif
+    m_Mapping = nullptr;
+    m_MappingSize = 0;
+}
+
+const Weapons::WeaponConfig* Library::find(const char* key) const {
+    for (uint32_t i = 0; i < m_Count; ++i) {
+        if (std::strcmp(m_Records[i].key, key) == 0) return m_Records + i;
+    }
+    return nullptr;
+}
+
+void defaultLoadout(const Library& weapons, WeaponInventory& inventory) {
+    inventory = WeaponInventory{};
+    for (int slot = 0; slot < WeaponInventory::SLOTS; ++slot) {
+        const Weapons::WeaponConfig* weapon = weapons.find(DEFAULT_LOADOUT[slot]);
+        if (!weapon) continue;
+        WeaponSlot& target = inventory.slots[slot];
+        target.weapon = static_cast<uint8_t>(weapons.indexOf(weapon));
+        target.chamberedRound = true;
+        target.currentAmmo = static_cast<uint16_t>(weapon->stats.magazineSize);
+        target.reserveAmmo = static_cast<uint16_t>(weapon->stats.reserveAmmo);
+    }
+    if (inventory.slots[DEFAULT_SLOT - 1].weapon != WeaponSlot::EMPTY) inventory.active = DEFAULT_SLOT - 1;
+}
+
+bool Library::adopt(const uint8_t* data, size_t size) {
+    Header header;
+    if (size < sizeof(Header)) return false;
+    std::memcpy(&header, data, sizeof(Header));
+    if (header.magic != MAGIC || header.version != VERSION) return false;
+    if (header.recordSize != sizeof(WeaponConfig) || header.size != size) return false;
+    if (header.count == 0 || header.count > MAX_WEAPONS) return false;
+
+    const size_t pointsOffset = sizeof(Header) + header.count * sizeof(WeaponConfig);
+    if (pointsOffset > size) return false;
+    if (hashBytes(data + sizeof(Header), size - sizeof(Header)) != header.hash) return false;
+
+    // A blob from a trusted build still gets its bounds checked: the
+    // records are dereferenced without checks from here on
+    const WeaponConfig* records = reinterpret_cast<const WeaponConfig*>(data + sizeof(Header));
+    for (uint32_t i = 0; i < header.count; ++i) {
+        const WeaponConfig& record = records[i];
+        if (!std::memchr(record.key, '\0', sizeof(record.key))) return false;
+        if (!std::memchr(record.name, '\0', sizeof(record.name))) return false;
+        // Unsigned, so a negative enum value is out of range too
+        if (static_cast<unsigned>(record.type) >= static_cast<unsigned>(WEAPON_TYPE_COUNT)) return false;
+        if (checkStats(record.stats)) return false;
+
+        size_t first = sizeof(Header) + i * sizeof(WeaponConfig) + record.recoilOffset;
+        if (record.recoilCount > 0 && (first < pointsOffset || first % alignof(RecoilPoint) != 0 ||
+                                       first + size_t(record.recoilCount) * sizeof(RecoilPoint) > size)) {
+            return false;
+        }
+    }
+
+    m_Records = records;
+    m_Count = header.count;
+    m_Hash = header.hash;
+    return true;
+}
+
+}
@@ -2,26 +2,27 @@
 #include "fps_camera.h"
 #include "player_controller.h"
 #include "audio_system.h"
+#include "telemetry.h"
 
 #include <algorithm>
 #include <iostream>
-#include <random>
 #include <cmath>
+#include <cstdio>
 
-WeaponSystem::WeaponSystem(FPSCamera* camera, PlayerController* player)
-    : m_Camera(camera), m_Player(player) {
+WeaponSystem::WeaponSystem(FPSCamera* camera, PlayerController* player, const WeaponData::Library& weapons)
+    : m_Camera(camera), m_Player(player), m_Weapons(weapons) {
     
-    // Initialize weapon database
-    m_WeaponConfigs["ak47"] = WeaponFactory::createAK47();
-    m_WeaponConfigs["m4a4"] = WeaponFactory::createM4A4();
-    m_WeaponConfigs["awp"] = WeaponFactory::createAWP();
-    m_WeaponConfigs["glock"] = WeaponFactory::createGlock();
-    m_WeaponConfigs["deagle"] = WeaponFactory::createDeagle();
-    
-    // Start with AK47
-    equipWeapon("ak47");
+    // Same spawn loadout as the server gives
+    WeaponData::defaultLoadout(m_Weapons, m_Inventory);
+    for (int slot = 0; slot < WeaponInventory::SLOTS; ++slot) {
+        if (m_Inventory.slots[slot].weapon == WeaponSlot::EMPTY)
+            TS_LOG_WARN("Weapon not found: {}", WeaponData::DEFAULT_LOADOUT[slot]);
+    }
+    if (m_Inventory.active >= 0) drawActive();
     
-    std::cout << "WeaponSystem initialized with " << m_WeaponConfigs.size() << " weapons" << std::endl;
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(m_Weapons.hash()));
+    TS_LOG_INFO("WeaponSystem initialized with {} weapons (data hash {})", m_Weapons.size(), hash);
 }
 
 WeaponSystem::~WeaponSystem() = default;
@@ -41,18 +42,18 @@ void WeaponSystem::update(float deltaTime) {
     m_Input.reset();
 }
 
-void WeaponSystem::processInput(GLFWwindow* window, float deltaTime) {
+void WeaponSystem::processInput(const InputSource& input, float deltaTime) {
     // Store previous states
     bool wasPrimaryFire = m_Input.primaryFire;
     bool wasReload = m_Input.reload;
     
     // Primary fire (Mouse1)
-    m_Input.primaryFire = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_LEFT) == GLFW_PRESS;
+    m_Input.primaryFire = input.isDown(InputAction::FIRE);
     m_Input.primaryPressed = m_Input.primaryFire && !wasPrimaryFire;
     m_Input.primaryReleased = !m_Input.primaryFire && wasPrimaryFire;
     
     // Secondary fire / ADS (Mouse2)
-    bool currentSecondary = glfwGetMouseButton(window, GLFW_MOUSE_BUTTON_RIGHT) == GLFW_PRESS;
+    bool currentSecondary = input.isDown(InputAction::AIM);
     if (currentSecondary && !m_Input.secondaryFire) {
         startADS();
     } else if (!currentSecondary && m_Input.secondaryFire) {
@@ -61,23 +62,47 @@ void WeaponSystem::processInput(GLFWwindow* window, float deltaTime) {
     m_Input.secondaryFire = currentSecondary;
     
     // Reload (R key)
-    m_Input.reload = glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS;
+    m_Input.reload = input.isDown(InputAction::RELOAD);
     m_Input.reloadPressed = m_Input.reload && !wasReload;
     
-    // Weapon switching (1-5 keys)
-    for (int i = 1; i <= 5; ++i) {
-        if (glfwGetKey(window, GLFW_KEY_0 + i) == GLFW_PRESS) {
+    // Weapon switching (1-6 keys)
+    static const InputAction SLOTS[] = {
+        InputAction::SLOT_1, InputAction::SLOT_2, InputAction::SLOT_3,
+        InputAction::SLOT_4, InputAction::SLOT_5, InputAction::SLOT_6
+    };
+    for (int i = 1; i <= 6; ++i) {
+        if (input.isDown(SLOTS[i - 1])) {
             switchToWeapon(i);
             break;
         }
     }
     
     // Inspect (F key)
-    m_Input.inspect = glfwGetKey(window, GLFW_KEY_F) == GLFW_PRESS;
-    
-    // Handle fire input
-    if (m_Input.primaryPressed || (m_Input.primaryFire && canFire())) {
-        fire();
+    m_Input.inspect = input.isDown(InputAction::INSPECT);
+    
+    // Handle fire input. This frame's sample is at m_GameTime + deltaTime
+    // (update() hasn't advanced the clock yet): the press fires when it
+    // happened, and held automatic fire follows the fire rate exactly
+    // instead of snapping to frames.
+    float sampleTime = m_GameTime + deltaTime;
+    if (m_Input.primaryPressed) {
+        float age = std::min(input.pressAge(InputAction::FIRE), deltaTime);
+        float shotTime = sampleTime - age;
+        if (canFireAt(shotTime)) {
+            glm::vec3 eyePos = m_Player ? m_Player->getPositionAtInput(age, deltaTime) : glm::vec3(0.0f);
+            fireAt(shotTime, eyePos);
+        }
+    }
+    if (m_Input.primaryFire && m_CurrentWeapon &&
+        m_CurrentWeapon->stats.fireMode != Weapons::FireMode::SEMI_AUTO) {
+        float fireInterval = 60.0f / m_CurrentWeapon->stats.fireRate;
+        for (;;) {
+            float shotTime = std::max(m_WeaponState.lastFireTime + fireInterval, m_GameTime);
+            if (shotTime > sampleTime || !canFireAt(shotTime)) break;
+            float age = sampleTime - shotTime;
+            glm::vec3 eyePos = m_Player ? m_Player->getPositionAtInput(age, deltaTime) : glm::vec3(0.0f);
+            fireAt(shotTime, eyePos);
+        }
     }
     
     // Handle reload input
@@ -86,52 +111,93 @@ void WeaponSystem::processInput(GLFWwindow* window, float deltaTime) {
     }
 }
 
-bool WeaponSystem::equipWeapon(const std::string& weaponName) {
-    auto it = m_WeaponConfigs.find(weaponName);
-    if (it == m_WeaponConfigs.end()) {
-        std::cerr << "Weapon not found: " << weaponName << std::endl;
+bool WeaponSystem::giveWeapon(int slot, const std::string& weaponName) {
+    if (slot < 1 || slot > WeaponInventory::SLOTS) return false;
+    const Weapons::WeaponConfig* weapon = m_Weapons.find(weaponName.c_str());
+    if (!weapon) {
+        TS_LOG_WARN("Weapon not found: {}", weaponName);
         return false;
     }
     
-    m_CurrentWeapon = std::make_unique<Weapons::WeaponConfig>(*it->second);
+    WeaponSlot& target = m_Inventory.slots[slot - 1];
+    target.weapon = static_cast<uint8_t>(m_Weapons.indexOf(weapon));
+    target.chamberedRound = true;
+    target.currentAmmo = static_cast<uint16_t>(weapon->stats.magazineSize);
+    target.reserveAmmo = static_cast<uint16_t>(weapon->stats.reserveAmmo);
+    
+    if (m_Inventory.active == slot - 1) drawActive();
+    return true;
+}
+
+bool WeaponSystem::equipWeapon(const std::string& weaponName) {
+    int slot = m_Inventory.active >= 0 ? m_Inventory.active + 1 : 1;
+    if (!giveWeapon(slot, weaponName)) return false;
+    if (m_Inventory.active != slot - 1) {
+        m_Inventory.active = static_cast<int8_t>(slot - 1);
+        drawActive();
+    }
+    return true;
+}
+
+void WeaponSystem::switchToWeapon(int slot) {
+    if (slot < 1 || slot > WeaponInventory::SLOTS) return;
+    if (slot - 1 == m_Inventory.active) return;
+    if (m_Inventory.slots[slot - 1].weapon == WeaponSlot::EMPTY) return;
+    
+    stowActive();
+    m_Inventory.active = static_cast<int8_t>(slot - 1);
+    drawActive();
+}
+
+void WeaponSystem::dropWeapon() {
+    if (m_Inventory.active < 0) return;
+    
+    m_Inventory.slots[m_Inventory.active] = WeaponSlot{};
+    m_Inventory.active = -1;
+    m_CurrentWeapon = nullptr;
+    m_WeaponState = WeaponState{};
+}
+
+void WeaponSystem::stowActive() {
+    if (m_Inventory.active < 0 || !m_CurrentWeapon) return;
+    
+    WeaponSlot& slot = m_Inventory.slots[m_Inventory.active];
+    slot.chamberedRound = m_WeaponState.chamberedRound;
+    slot.currentAmmo = static_cast<uint16_t>(m_WeaponState.currentAmmo);
+    slot.reserveAmmo = static_cast<uint16_t>(m_WeaponState.reserveAmmo);
+}
+
+void WeaponSystem::drawActive() {
+    const WeaponSlot& slot = m_Inventory.slots[m_Inventory.active];
+    m_CurrentWeapon = m_Weapons.at(slot.weapon);
     
-    // Reset weapon state
+    // Fresh handling state (recoil, ADS, reload), the slot's ammo
     m_WeaponState = WeaponState{};
-    m_WeaponState.currentAmmo = m_CurrentWeapon->stats.magazineSize;
-    m_WeaponState.reserveAmmo = m_CurrentWeapon->stats.reserveAmmo;
-    m_WeaponState.chamberedRound = true;
+    m_WeaponState.currentAmmo = slot.currentAmmo;
+    m_WeaponState.reserveAmmo = slot.reserveAmmo;
+    m_WeaponState.chamberedRound = slot.chamberedRound;
     
     changeWeaponState(Weapons::WeaponState::DRAWING);
     
-    if (m_CurrentWeapon && m_AudioSystem) {
+    if (m_AudioSystem) {
         m_AudioSystem->onWeaponDraw(m_CurrentWeapon->name, m_Player->getPosition());
     }
 
-    std::cout << "Equipped: " << m_CurrentWeapon->name << " (" 
-              << m_WeaponState.currentAmmo << "/" << m_WeaponState.reserveAmmo << ")" << std::endl;
-    
-    return true;
+    TS_LOG_INFO("Equipped: {} ({}/{})", m_CurrentWeapon->name,
+                m_WeaponState.currentAmmo, m_WeaponState.reserveAmmo);
 }
 
-void WeaponSystem::switchToWeapon(int slot) {
-    // Simple weapon switching by slot
-    switch(slot) {
-        case 1: equipWeapon("glock"); break;
-        case 2: equipWeapon("deagle"); break;
-        case 3: equipWeapon("ak47"); break;
-        case 4: equipWeapon("m4a4"); break;
-        case 5: equipWeapon("awp"); break;
-        default: break;
-    }
+bool WeaponSystem::canFire() const {
+    return canFireAt(m_GameTime);
 }
 
-bool WeaponSystem::canFire() const {
+bool WeaponSystem::canFireAt(float shotTime) const {
     if (!m_CurrentWeapon) return false;
     if (m_WeaponState.state != Weapons::WeaponState::IDLE) return false;
     if (m_WeaponState.currentAmmo <= 0) return false;
     
     // Check fire rate
-    float timeSinceLastShot = m_GameTime - m_WeaponState.lastFireTime;
+    float timeSinceLastShot = shotTime - m_WeaponState.lastFireTime;
     float fireInterval = 60.0f / m_CurrentWeapon->stats.fireRate;
     
     if (timeSinceLastShot < fireInterval) return false;
@@ -145,11 +211,15 @@ bool WeaponSystem::canFire() const {
 }
 
 void WeaponSystem::fire() {
-    if (!canFire()) return;
+    fireAt(m_GameTime, m_Player ? m_Player->getPosition() : glm::vec3(0.0f));
+}
+
+void WeaponSystem::fireAt(float shotTime, const glm::vec3& eyePos) {
+    if (!canFireAt(shotTime)) return;
     
     // Update timing
-    m_WeaponState.lastFireTime = m_GameTime;
-    m_WeaponState.lastShotTime = m_GameTime;
+    m_WeaponState.lastFireTime = shotTime;
+    m_WeaponState.lastShotTime = shotTime;
     m_WeaponState.shotsFired++;
     
     // Consume ammo
@@ -158,43 +228,68 @@ void WeaponSystem::fire() {
         m_WeaponState.chamberedRound = false;
     }
     
+    // This shot's randomness, the same wherever it is simulated
+    RandomStream random(m_RandomSeed, m_ShotSequence++);
+
     // Calculate shot direction with spread
-    glm::vec3 forward = m_Camera->getForward();
-    glm::vec3 shotDirection = applySpreadToDirection(forward);
-    
-    // Perform raycast
-    glm::vec3 cameraPos = m_Camera ? glm::vec3(0) : glm::vec3(0); // Get actual camera position
-    HitResult hit = performRaycast(cameraPos, shotDirection);
+    glm::vec3 forward = m_Player ? m_Player->getViewForward() : m_Camera->getForward();
+    glm::vec3 shotDirection = applySpreadToDirection(forward, random);
+    
+    // Perform raycast from the eye, one ray per pellet
+    HitResult pellets[MAX_PELLETS];
+    int pelletCount = 1;
+    if (m_CurrentWeapon->stats.pelletCount > 1) {
+        pelletCount = performPelletRaycast(eyePos, shotDirection, random, pellets);
+    } else {
+        pellets[0] = performRaycast(eyePos, shotDirection);
+    }
+    const HitResult& hit = pellets[0];
 
     // Audio feedback
     if (m_AudioSystem) {
-        m_AudioSystem->onWeaponFire(m_CurrentWeapon->name, m_Player->getPosition());
+        m_AudioSystem->onWeaponFire(m_CurrentWeapon->name, eyePos);
         
-        if (hit.hit) {
-            Audio::SurfaceMaterial material = Audio::SurfaceMaterial::CONCRETE; // Default
-            m_AudioSystem->onBulletImpact(hit.hitPoint, material);
+        for (int i = 0; i < pelletCount; ++i) {
+            if (pellets[i].hit && pellets[i].targetId < 0) {
+                m_AudioSystem->onBulletImpact(pellets[i].hitPoint, static_cast<Audio::SurfaceMaterial>(pellets[i].material));
+            }
         }
     }
     
     // Add recoil
-    addRecoil();
+    addRecoil(random);
     
     // Add view punch for screen shake
     float punchStrength = m_CurrentWeapon->stats.recoilMagnitude * 0.5f;
-    m_ViewPunchVelocity.y += punchStrength * (0.8f + 0.4f * (rand() / float(RAND_MAX)));
-    m_ViewPunchVelocity.x += punchStrength * 0.3f * ((rand() / float(RAND_MAX)) - 0.5f);
+    m_ViewPunchVelocity.y += punchStrength * random.range(0.8f, 1.2f);
+    m_ViewPunchVelocity.x += punchStrength * 0.3f * random.range(-0.5f, 0.5f);
     
     // Debug output
-    std::cout << "FIRE! " << m_CurrentWeapon->name 
-              << " | Ammo: " << m_WeaponState.currentAmmo 
-              << " | Shots: " << m_WeaponState.shotsFired
-              << " | Spread: " << calculateCurrentSpread() << "°";
-    
-    if (hit.hit) {
-        std::cout << " | HIT at " << hit.distance << "m for " << hit.damage << " dmg";
-        if (hit.isHeadshot) std::cout << " (HEADSHOT!)";
+    if (pelletCount > 1) {
+        int pelletsOnTarget = 0;
+        float totalDamage = 0.0f;
+        for (int i = 0; i < pelletCount; ++i) {
+            if (pellets[i].targetId < 0) continue;
+            ++pelletsOnTarget;
+            totalDamage += pellets[i].damage;
+        }
+        TS_LOG_INFO("FIRE! {} | Ammo: {} | {}/{} pellets on target for {} dmg",
+                    m_CurrentWeapon->name, m_WeaponState.currentAmmo, pelletsOnTarget, pelletCount, totalDamage);
+    } else if (hit.targetId >= 0) {
+        const char* note = hit.penetrations > 0 ? (hit.isHeadshot ? " (HEADSHOT!) through a wall" : " through a wall")
+                                                : (hit.isHeadshot ? " (HEADSHOT!)" : "");
+        TS_LOG_INFO("FIRE! {} | Ammo: {} | Shots: {} | Spread: {}° | HIT target {} at {}m for {} dmg{}",
+                    m_CurrentWeapon->name, m_WeaponState.currentAmmo, m_WeaponState.shotsFired,
+                    calculateCurrentSpread(), hit.targetId, hit.distance, hit.damage, note);
+    } else if (hit.hit) {
+        TS_LOG_DEBUG("FIRE! {} | Ammo: {} | Shots: {} | Spread: {}° | wall at {}m",
+                     m_CurrentWeapon->name, m_WeaponState.currentAmmo, m_WeaponState.shotsFired,
+                     calculateCurrentSpread(), hit.distance);
+    } else {
+        TS_LOG_INFO("FIRE! {} | Ammo: {} | Shots: {} | Spread: {}°",
+                    m_CurrentWeapon->name, m_WeaponState.currentAmmo, m_WeaponState.shotsFired,
+                    calculateCurrentSpread());
     }
-    std::cout << std::endl;
     
     // Auto-reload when empty
     if (m_WeaponState.currentAmmo == 0 && m_WeaponState.reserveAmmo > 0) {
@@ -203,28 +298,31 @@ void WeaponSystem::fire() {
 }
 
 HitResult WeaponSystem::performRaycast(const glm::vec3& origin, const glm::vec3& direction) const {
-    HitResult result;
-    
-    // Simple raycast - in a real game you'd use a physics engine
-    // For now, simulate hitting something at random distance
-    float maxRange = m_CurrentWeapon->stats.maxRange;
-    float hitDistance = maxRange * 0.5f + (rand() / float(RAND_MAX)) * maxRange * 0.5f;
-    
-    if (hitDistance <= maxRange) {
-        result.hit = true;
-        result.hitPoint = origin + direction * hitDistance;
-        result.distance = hitDistance;
-        result.damage = calculateDamage(result);
-        
-        // Random hit location for demo
-        int location = rand() % 7;
-        result.hitLocation = static_cast<HitResult::HitLocation>(location);
-        result.isHeadshot = (result.hitLocation == HitResult::HEAD);
-    }
-    
+    HitResult result = Hitscan::trace(m_World, m_Hitboxes, origin, direction,
+                                      m_CurrentWeapon->stats.maxRange, -1, m_CurrentWeapon->stats.penetration);
+    // Walls take no damage
+    if (result.targetId >= 0) result.damage = calculateDamage(result);
     return result;
 }
 
+int WeaponSystem::performPelletRaycast(const glm::vec3& origin, const glm::vec3& direction, RandomStream& random,
+                                       HitResult* hits) const {
+    const int count = std::min(m_CurrentWeapon->stats.pelletCount, MAX_PELLETS);
+    glm::vec3 origins[MAX_PELLETS];
+    glm::vec3 directions[MAX_PELLETS];
+    for (int i = 0; i < count; ++i) {
+        origins[i] = origin;
+        directions[i] = applySpreadToDirection(direction, m_CurrentWeapon->stats.pelletSpread, random);
+    }
+
+    Hitscan::tracePacket(m_World, m_Hitboxes, origins, directions, static_cast<uint32_t>(count),
+                         m_CurrentWeapon->stats.maxRange, -1, hits);
+    for (int i = 0; i < count; ++i) {
+        if (hits[i].targetId >= 0) hits[i].damage = calculateDamage(hits[i]);
+    }
+    return count;
+}
+
 float WeaponSystem::calculateDamage(const HitResult& hit) const {
     if (!m_CurrentWeapon || !hit.hit) return 0.0f;
     
@@ -259,22 +357,18 @@ float WeaponSystem::calculateDamage(const HitResult& hit) const {
             break;
     }
     
-    return baseDamage * distanceFactor * locationMultiplier;
+    return baseDamage * distanceFactor * locationMultiplier * hit.damageScale;
 }
 
-void WeaponSystem::addRecoil() {
+void WeaponSystem::addRecoil(RandomStream& random) {
     if (!m_CurrentWeapon) return;
     
     // Get recoil pattern point
     glm::vec2 patternRecoil = getRecoilPatternPoint(m_WeaponState.shotsFired - 1);
     
     // Add randomness
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::normal_distribution<float> dist(0.0f, m_CurrentWeapon->stats.recoilRandomness);
-    
-    patternRecoil.x += dist(gen);
-    patternRecoil.y += dist(gen);
+    patternRecoil.x += random.normal(m_CurrentWeapon->stats.recoilRandomness);
+    patternRecoil.y += random.normal(m_CurrentWeapon->stats.recoilRandomness);
     
     // Scale by weapon recoil magnitude
     patternRecoil *= m_CurrentWeapon->stats.recoilMagnitude;
@@ -287,13 +381,13 @@ void WeaponSystem::addRecoil() {
 }
 
 glm::vec2 WeaponSystem::getRecoilPatternPoint(int shotIndex) const {
-    if (!m_CurrentWeapon || m_CurrentWeapon->recoilPattern.empty()) {
+    if (!m_CurrentWeapon || m_CurrentWeapon->recoilCount == 0) {
         return glm::vec2(0.0f, 1.0f); // Default upward recoil
     }
     
     // Clamp to pattern length
-    int patternIndex = std::min(shotIndex, (int)m_CurrentWeapon->recoilPattern.size() - 1);
-    return m_CurrentWeapon->recoilPattern[patternIndex].offset;
+    int patternIndex = std::min(shotIndex, (int)m_CurrentWeapon->recoilCount - 1);
+    return m_CurrentWeapon->recoilPattern()[patternIndex].offset;
 }
 
 void WeaponSystem::applyRecoilToCamera() {
@@ -301,7 +395,10 @@ void WeaponSystem::applyRecoilToCamera() {
     float punchX = m_WeaponState.targetRecoil.x * 0.1f;
     float punchY = -m_WeaponState.targetRecoil.y * 0.1f; // Negative because recoil goes up
     
-    if (m_Camera) {
+    // The controller owns the view angles; it forwards them to the camera
+    if (m_Player) {
+        m_Player->addViewAngles(punchX * Physics::MOUSE_SENSITIVITY, punchY * Physics::MOUSE_SENSITIVITY);
+    } else if (m_Camera) {
         m_Camera->processMouseMovement(punchX, punchY);
     }
 }
@@ -335,60 +432,31 @@ void WeaponSystem::updateRecoil(float deltaTime) {
 float WeaponSystem::calculateCurrentSpread() const {
     if (!m_CurrentWeapon) return 0.0f;
     
-    float spread = m_CurrentWeapon->stats.baseSpread;
-    
-    // Movement penalty
+    // Movement and jumping penalties
+    float speedFraction = 0.0f;
+    bool airborne = false;
     if (m_Player) {
         float playerSpeed = m_Player->getSpeed();
-        if (playerSpeed > 1.0f) {
-            spread += m_CurrentWeapon->stats.movingSpread * (playerSpeed / 250.0f);
-        }
-        
-        // Jumping penalty
-        if (!m_Player->isOnGround()) {
-            spread += m_CurrentWeapon->stats.jumpingSpread;
-        }
+        if (playerSpeed > 1.0f) speedFraction = playerSpeed / 250.0f;
+        airborne = !m_Player->isOnGround();
     }
     
     // Crouching bonus (implement crouching in player controller)
     // spread += m_CurrentWeapon->stats.crouchingSpread;
     
-    // ADS reduction
-    if (m_WeaponState.isAiming) {
-        spread *= (1.0f - m_CurrentWeapon->stats.adsSpreadReduction * m_WeaponState.adsProgress);
-    }
-    
-    // Recoil increases spread
-    float recoilSpread = glm::length(m_WeaponState.currentRecoil) * 0.01f;
-    spread += recoilSpread;
-    
-    return std::max(0.0f, spread);
+    // Shared with the server's replay of the shot (Hitscan::shotSpread)
+    float adsProgress = m_WeaponState.isAiming ? m_WeaponState.adsProgress : 0.0f;
+    return Hitscan::shotSpread(m_CurrentWeapon->stats, speedFraction, airborne, adsProgress,
+                               glm::length(m_WeaponState.currentRecoil));
 }
 
-glm::vec3 WeaponSystem::applySpreadToDirection(const glm::vec3& baseDirection) const {
-    float spreadAngle = calculateCurrentSpread();
-    if (spreadAngle <= 0.0f) return baseDirection;
-    
-    // Convert spread from degrees to radians
-    float spreadRad = glm::radians(spreadAngle);
-    
-    // Generate random offset within spread cone
-    std::random_device rd;
-    std::mt19937 gen(rd());
-    std::uniform_real_distribution<float> angleDist(0.0f, 2.0f * 3.14159265359f);
-    std::uniform_real_distribution<float> radiusDist(0.0f, 1.0f);
-    
-    float angle = angleDist(gen);
-    float radius = sqrt(radiusDist(gen)) * spreadRad; // sqrt for uniform distribution
-    
-    // Create perpendicular vectors
-    glm::vec3 up = abs(baseDirection.y) < 0.9f ? glm::vec3(0, 1, 0) : glm::vec3(1, 0, 0);
-    glm::vec3 right = glm::normalize(glm::cross(baseDirection, up));
-    up = glm::normalize(glm::cross(right, baseDirection));
-    
-    // Apply spread
-    glm::vec3 spreadOffset = right * (cos(angle) * radius) + up * (sin(angle) * radius);
-    return glm::normalize(baseDirection + spreadOffset);
+glm::vec3 WeaponSystem::applySpreadToDirection(const glm::vec3& baseDirection, RandomStream& random) const {
+    return applySpreadToDirection(baseDirection, calculateCurrentSpread(), random);
+}
+
+glm::vec3 WeaponSystem::applySpreadToDirection(const glm::vec3& baseDirection, float spreadAngle,
+                                               RandomStream& random) const {
+    return Hitscan::spreadDirection(baseDirection, spreadAngle, random);
 }
 
 void WeaponSystem::startReload() {
@@ -410,13 +478,13 @@ void WeaponSystem::startReload() {
     
     m_WeaponState.stateTimer = reloadTime;
     
-    std::cout << "Reloading " << m_CurrentWeapon->name << " (" << reloadTime << "s)" << std::endl;
+    TS_LOG_INFO("Reloading {} ({}s)", m_CurrentWeapon->name, reloadTime);
 }
 
 void WeaponSystem::cancelReload() {
     if (m_WeaponState.state == Weapons::WeaponState::RELOADING) {
         changeWeaponState(Weapons::WeaponState::IDLE);
-        std::cout << "Reload cancelled" << std::endl;
+        TS_LOG_INFO("Reload cancelled");
     }
 }
 
@@ -428,12 +496,12 @@ void WeaponSystem::startADS() {
     if (!m_CurrentWeapon || m_WeaponState.state != Weapons::WeaponState::IDLE) return;
     
     m_WeaponState.isAiming = true;
-    std::cout << "ADS started" << std::endl;
+    TS_LOG_DEBUG("ADS started");
 }
 
 void WeaponSystem::stopADS() {
     m_WeaponState.isAiming = false;
-    std::cout << "ADS stopped" << std::endl;
+    TS_LOG_DEBUG("ADS stopped");
 }
 
 bool WeaponSystem::isAiming() const {
@@ -461,8 +529,7 @@ void WeaponSystem::updateStateMachine(float deltaTime) {
                         m_WeaponState.reserveAmmo -= ammoToAdd;
                         m_WeaponState.chamberedRound = true;
                         
-                        std::cout << "Reload complete! " << m_WeaponState.currentAmmo 
-                                  << "/" << m_WeaponState.reserveAmmo << std::endl;
+                        TS_LOG_INFO("Reload complete! {}/{}", m_WeaponState.currentAmmo, m_WeaponState.reserveAmmo);
                     }
                     changeWeaponState(Weapons::WeaponState::IDLE);
                     break;
@@ -516,8 +583,14 @@ void WeaponSystem::applyViewPunch() {
     m_ViewPunch += m_ViewPunchVelocity * (1.0f/60.0f);
     
     // Apply minimal punch to camera for subtle screen shake
-    if (m_Camera && glm::length(m_ViewPunch) > 0.01f) {
-        m_Camera->processMouseMovement(m_ViewPunch.x * 0.1f, m_ViewPunch.y * 0.1f);
+    if (glm::length(m_ViewPunch) > 0.01f) {
+        float punchX = m_ViewPunch.x * 0.1f;
+        float punchY = m_ViewPunch.y * 0.1f;
+        if (m_Player) {
+            m_Player->addViewAngles(punchX * Physics::MOUSE_SENSITIVITY, punchY * Physics::MOUSE_SENSITIVITY);
+        } else if (m_Camera) {
+            m_Camera->processMouseMovement(punchX, punchY);
+        }
     }
 }
 
@@ -542,7 +615,7 @@ void WeaponSystem::updateInputTiming(float deltaTime) {
 }
 
 const Weapons::WeaponConfig* WeaponSystem::getCurrentWeapon() const {
-    return m_CurrentWeapon.get();
+    return m_CurrentWeapon;
 }
 
 glm::vec2 WeaponSystem::getCurrentSpread() const {
@@ -567,270 +640,3 @@ void WeaponSystem::printDebugInfo() const {
         m_DebugTimer = 0.0f;
     }
 }
-
-// WeaponFactory implementations
-std::unique_ptr<Weapons::WeaponConfig> WeaponFactory::createAK47() {
-    auto weapon = std::make_unique<Weapons::WeaponConfig>();
-    
-    weapon->name = "AK-47";
-    weapon->type = Weapons::WeaponType::RIFLE;
-    
-    // AK-47 stats (high damage, high recoil)
-    weapon->stats.baseDamage = 36.0f;
-    weapon->stats.headshotMultiplier = 4.0f;
-    weapon->stats.optimalRange = 25.0f;
-    weapon->stats.maxRange = 80.0f;
-    weapon->stats.minDamagePercent = 0.25f;
-    
-    weapon->stats.baseSpread = 0.15f;
-    weapon->stats.movingSpread = 0.4f;
-    weapon->stats.jumpingSpread = 1.2f;
-    weapon->stats.crouchingSpread = -0.08f;
-    
-    weapon->stats.recoilMagnitude = 1.2f;
-    weapon->stats.recoilRecovery = 6.0f;
-    weapon->stats.recoilRandomness = 0.15f;
-    
-    weapon->stats.fireRate = 600.0f;
-    weapon->stats.fireMode = Weapons::FireMode::FULL_AUTO;
-    
-    weapon->stats.magazineSize = 30;
-    weapon->stats.reserveAmmo = 90;
-    weapon->stats.reloadTime = 2.5f;
-    weapon->stats.tacticalReloadTime = 2.0f;
-    
-    weapon->stats.movementSpeedMultiplier = 0.87f;
-    weapon->stats.adsTime = 0.35f;
-    weapon->stats.adsSpreadReduction = 0.75f;
-    
-    weapon->recoilPattern = generateAK47Pattern();
-    
-    return weapon;
-}
-
-std::unique_ptr<Weapons::WeaponConfig> WeaponFactory::createM4A4() {
-    auto weapon = std::make_unique<Weapons::WeaponConfig>();
-    
-    weapon->name = "M4A4";
-    weapon->type = Weapons::WeaponType::RIFLE;
-    
-    // M4A4 stats (balanced, controllable)
-    weapon->stats.baseDamage = 33.0f;
-    weapon->stats.headshotMultiplier = 4.0f;
-    weapon->stats.optimalRange = 30.0f;
-    weapon->stats.maxRange = 85.0f;
-    weapon->stats.minDamagePercent = 0.3f;
-    
-    weapon->stats.baseSpread = 0.12f;
-    weapon->stats.movingSpread = 0.35f;
-    weapon->stats.jumpingSpread = 1.0f;
-    weapon->stats.crouchingSpread = -0.06f;
-    
-    weapon->stats.recoilMagnitude = 1.0f;
-    weapon->stats.recoilRecovery = 7.0f;
-    weapon->stats.recoilRandomness = 0.1f;
-    
-    weapon->stats.fireRate = 666.0f;
-    weapon->stats.fireMode = Weapons::FireMode::FULL_AUTO;
-    
-    weapon->stats.magazineSize = 30;
-    weapon->stats.reserveAmmo = 90;
-    weapon->stats.reloadTime = 3.1f;
-    weapon->stats.tacticalReloadTime = 2.3f;
-    
-    weapon->stats.movementSpeedMultiplier = 0.9f;
-    weapon->stats.adsTime = 0.3f;
-    weapon->stats.adsSpreadReduction = 0.8f;
-    
-    weapon->recoilPattern = generateM4A4Pattern();
-    
-    return weapon;
-}
-
-std::unique_ptr<Weapons::WeaponConfig> WeaponFactory::createAWP() {
-    auto weapon = std::make_unique<Weapons::WeaponConfig>();
-    
-    weapon->name = "AWP";
-    weapon->type = Weapons::WeaponType::SNIPER;
-    
-    // AWP stats (one-shot potential, slow)
-    weapon->stats.baseDamage = 115.0f;
-    weapon->stats.headshotMultiplier = 2.5f; // Always kills anyway
-    weapon->stats.optimalRange = 60.0f;
-    weapon->stats.maxRange = 150.0f;
-    weapon->stats.minDamagePercent = 0.8f;
-    
-    weapon->stats.baseSpread = 0.05f;
-    weapon->stats.movingSpread = 0.8f;
-    weapon->stats.jumpingSpread = 2.0f;
-    weapon->stats.crouchingSpread = -0.02f;
-    
-    weapon->stats.recoilMagnitude = 2.0f;
-    weapon->stats.recoilRecovery = 4.0f;
-    weapon->stats.recoilRandomness = 0.05f;
-    
-    weapon->stats.fireRate = 41.0f; // Very slow
-    weapon->stats.fireMode = Weapons::FireMode::BOLT_ACTION;
-    
-    weapon->stats.magazineSize = 10;
-    weapon->stats.reserveAmmo = 30;
-    weapon->stats.reloadTime = 3.7f;
-    weapon->stats.tacticalReloadTime = 2.9f;
-    
-    weapon->stats.movementSpeedMultiplier = 0.76f; // Very slow movement
-    weapon->stats.adsTime = 0.45f;
-    weapon->stats.adsSpreadReduction = 0.95f;
-    weapon->stats.adsFOVMultiplier = 0.2f; // High zoom
-    
-    // Simple recoil pattern - mostly vertical
-    weapon->recoilPattern = {
-        {glm::vec2(0.0f, 8.0f), 0.0f, 8.0f}
-    };
-    
-    return weapon;
-}
-
-std::unique_ptr<Weapons::WeaponConfig> WeaponFactory::createGlock() {
-    auto weapon = std::make_unique<Weapons::WeaponConfig>();
-    
-    weapon->name = "Glock-18";
-    weapon->type = Weapons::WeaponType::PISTOL;
-    
-    // Glock stats (low damage, high mobility)
-    weapon->stats.baseDamage = 28.0f;
-    weapon->stats.headshotMultiplier = 4.0f;
-    weapon->stats.optimalRange = 15.0f;
-    weapon->stats.maxRange = 50.0f;
-    weapon->stats.minDamagePercent = 0.4f;
-    
-    weapon->stats.baseSpread = 0.2f;
-    weapon->stats.movingSpread = 0.25f;
-    weapon->stats.jumpingSpread = 0.8f;
-    weapon->stats.crouchingSpread = -0.05f;
-    
-    weapon->stats.recoilMagnitude = 0.8f;
-    weapon->stats.recoilRecovery = 10.0f;
-    weapon->stats.recoilRandomness = 0.2f;
-    
-    weapon->stats.fireRate = 400.0f;
-    weapon->stats.fireMode = Weapons::FireMode::SEMI_AUTO;
-    
-    weapon->stats.magazineSize = 20;
-    weapon->stats.reserveAmmo = 120;
-    weapon->stats.reloadTime = 2.2f;
-    weapon->stats.tacticalReloadTime = 1.8f;
-    
-    weapon->stats.movementSpeedMultiplier = 1.0f; // No movement penalty
-    weapon->stats.adsTime = 0.2f;
-    weapon->stats.adsSpreadReduction = 0.6f;
-    
-    weapon->recoilPattern = generateControlledPattern(0.5f, 0.3f, 10);
-    
-    return weapon;
-}
-
-std::unique_ptr<Weapons::WeaponConfig> WeaponFactory::createDeagle() {
-    auto weapon = std::make_unique<Weapons::WeaponConfig>();
-    
-    weapon->name = "Desert Eagle";
-    weapon->type = Weapons::WeaponType::PISTOL;
-    
-    // Deagle stats (high damage, high recoil)
-    weapon->stats.baseDamage = 53.0f;
-    weapon->stats.headshotMultiplier = 4.0f;
-    weapon->stats.optimalRange = 20.0f;
-    weapon->stats.maxRange = 70.0f;
-    weapon->stats.minDamagePercent = 0.3f;
-    
-    weapon->stats.baseSpread = 0.3f;
-    weapon->stats.movingSpread = 0.5f;
-    weapon->stats.jumpingSpread = 1.5f;
-    weapon->stats.crouchingSpread = -0.1f;
-    
-    weapon->stats.recoilMagnitude = 1.8f;
-    weapon->stats.recoilRecovery = 5.0f;
-    weapon->stats.recoilRandomness = 0.3f;
-    
-    weapon->stats.fireRate = 267.0f; // Slow
-    weapon->stats.fireMode = Weapons::FireMode::SEMI_AUTO;
-    
-    weapon->stats.magazineSize = 7;
-    weapon->stats.reserveAmmo = 35;
-    weapon->stats.reloadTime = 2.2f;
-    weapon->stats.tacticalReloadTime = 1.8f;
-    
-    weapon->stats.movementSpeedMultiplier = 0.95f;
-    weapon->stats.adsTime = 0.25f;
-    weapon->stats.adsSpreadReduction = 0.7f;
-    
-    weapon->recoilPattern = generateControlledPattern(1.5f, 0.8f, 7);
-    
-    return weapon;
-}
-
-std::vector<Weapons::RecoilPoint> WeaponFactory::generateAK47Pattern() {
-    // Simplified AK-47 recoil pattern (first 15 shots)
-    return {
-        {glm::vec2(0.0f, 2.0f), 0.0f, 8.0f},      // 1
-        {glm::vec2(0.1f, 2.2f), 0.1f, 8.0f},      // 2
-        {glm::vec2(-0.2f, 2.4f), 0.2f, 8.0f},     // 3
-        {glm::vec2(-0.4f, 2.1f), 0.3f, 8.0f},     // 4
-        {glm::vec2(-0.6f, 1.8f), 0.4f, 8.0f},     // 5
-        {glm::vec2(-0.8f, 1.5f), 0.5f, 8.0f},     // 6
-        {glm::vec2(-1.0f, 1.2f), 0.6f, 8.0f},     // 7
-        {glm::vec2(-1.1f, 1.0f), 0.7f, 8.0f},     // 8
-        {glm::vec2(-0.9f, 0.8f), 0.8f, 8.0f},     // 9
-        {glm::vec2(-0.6f, 0.7f), 0.9f, 8.0f},     // 10
-        {glm::vec2(-0.2f, 0.6f), 1.0f, 8.0f},     // 11
-        {glm::vec2(0.3f, 0.6f), 1.1f, 8.0f},      // 12
-        {glm::vec2(0.7f, 0.7f), 1.2f, 8.0f},      // 13
-        {glm::vec2(1.0f, 0.8f), 1.3f, 8.0f},      // 14
-        {glm::vec2(1.2f, 0.9f), 1.4f, 8.0f}       // 15
-    };
-}
-
-std::vector<Weapons::RecoilPoint> WeaponFactory::generateM4A4Pattern() {
-    // M4A4 pattern - more vertical, less horizontal movement
-    return {
-        {glm::vec2(0.0f, 1.8f), 0.0f, 8.0f},
-        {glm::vec2(0.05f, 1.9f), 0.1f, 8.0f},
-        {glm::vec2(-0.1f, 2.0f), 0.2f, 8.0f},
-        {glm::vec2(-0.2f, 1.8f), 0.3f, 8.0f},
-        {glm::vec2(-0.3f, 1.6f), 0.4f, 8.0f},
-        {glm::vec2(-0.4f, 1.4f), 0.5f, 8.0f},
-        {glm::vec2(-0.45f, 1.2f), 0.6f, 8.0f},
-        {glm::vec2(-0.4f, 1.0f), 0.7f, 8.0f},
-        {glm::vec2(-0.3f, 0.9f), 0.8f, 8.0f},
-        {glm::vec2(-0.1f, 0.8f), 0.9f, 8.0f},
-        {glm::vec2(0.1f, 0.8f), 1.0f, 8.0f},
-        {glm::vec2(0.3f, 0.9f), 1.1f, 8.0f},
-        {glm::vec2(0.4f, 1.0f), 1.2f, 8.0f},
-        {glm::vec2(0.45f, 1.1f), 1.3f, 8.0f},
-        {glm::vec2(0.4f, 1.2f), 1.4f, 8.0f}
-    };
-}
-
-std::vector<Weapons::RecoilPoint> WeaponFactory::generateControlledPattern(
-    float verticalStrength, float horizontalVariation, int patternLength) {
-    
-    std::vector<Weapons::RecoilPoint> pattern;
-    pattern.reserve(patternLength);
-    
-    for (int i = 0; i < patternLength; ++i) {
-        float progress = float(i) / float(patternLength - 1);
-        
-        // Vertical component (strongest at beginning)
-        float vertical = verticalStrength * (1.0f - progress * 0.3f);
-        
-        // Horizontal component (alternating with decay)
-        float horizontal = horizontalVariation * sin(progress * 6.28f) * (1.0f - progress * 0.5f);
-        
-        pattern.push_back({
-            glm::vec2(horizontal, vertical),
-            i * 0.1f,
-            8.0f
-        });
-    }
-    
-    return pattern;
-}
@@ -0,0 +1,47 @@
+// Compiles weapon definitions (data/weapons.txt) into the binary blob the
+// game maps at startup. Run by the build; by hand:
+//   weapon_compiler data/weapons.txt weapons.bin
+
+#include "weapon_data.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "Usage: " << argv[0] << " <weapons.txt> <weapons.bin>" << std::endl;
+        return 2;
+    }
+
+    std::ifstream in(argv[1]);
+    if (!in) {
+        std::cerr << "Cannot read " << argv[1] << std::endl;
+        return 1;
+    }
+    std::stringstream source;
+    source << in.rdbuf();
+
+    std::vector<uint8_t> blob;
+    std::string error;
+    if (!WeaponData::compile(source.str(), blob, error)) {
+        std::cerr << argv[1] << ": " << error << std::endl;
+        return 1;
+    }
+
+    std::ofstream out(argv[2], std::ios::binary | std::ios::trunc);
+    out.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+    if (!out) {
+        std::cerr << "Cannot write " << argv[2] << std::endl;
+        return 1;
+    }
+
+    WeaponData::Header header;
+    std::memcpy(&header, blob.data(), sizeof(header));
+    char hash[17];
+    std::snprintf(hash, sizeof(hash), "%016llx", static_cast<unsigned long long>(header.hash));
+    std::cout << argv[2] << ": " << header.count << " weapons, " << blob.size() << " bytes, hash " << hash << std::endl;
+    return 0;
+}